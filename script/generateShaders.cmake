@@ -1,37 +1,160 @@
+option(VULKAN_RENDERER_EMBED_SHADERS "Embed SPIR-V through .incbin instead of hex arrays where the compiler supports it" ON)
+set(VULKAN_RENDERER_SHADER_OPTIMIZATION "none" CACHE STRING
+	"SPIR-V embedded after reflection: none, strip (debug and non-semantic instructions), size or performance (spirv-opt -Os or -O, then strip)")
+set_property(CACHE VULKAN_RENDERER_SHADER_OPTIMIZATION PROPERTY STRINGS none strip size performance)
+find_program(SPIRV_OPT_EXECUTABLE spirv-opt HINTS $ENV{VULKAN_SDK}/bin $ENV{VULKAN_SDK}/Bin)
+
 function(generate_shaders SHADER_DIR TARGET_NAME)
 	set(SPV_DIR ${CMAKE_CURRENT_BINARY_DIR}/spv)
 	set(HEADER_DIR ${CMAKE_CURRENT_BINARY_DIR}/header)
 	find_package(Vulkan REQUIRED)
 	set(GLSL_COMPILER_BIN ${Vulkan_GLSLANG_VALIDATOR_EXECUTABLE})
+	# .incbin needs a GNU style assembler, MSVC keeps the hex arrays
+	set(EMBED_SHADERS OFF)
+	if(VULKAN_RENDERER_EMBED_SHADERS AND CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang" AND NOT MSVC)
+		set(EMBED_SHADERS ON)
+	endif()
+	# reflection reads the glslangValidator output, the optimized copy next to it is embedded;
+	# without spirv-opt generate_shader strips it and the optimization recipes are skipped
+	set(SPIRV_OPT_FLAGS "")
+	if(VULKAN_RENDERER_SHADER_OPTIMIZATION STREQUAL "size")
+		set(SPIRV_OPT_FLAGS -Os)
+	elseif(VULKAN_RENDERER_SHADER_OPTIMIZATION STREQUAL "performance")
+		set(SPIRV_OPT_FLAGS -O)
+	elseif(NOT VULKAN_RENDERER_SHADER_OPTIMIZATION MATCHES "^(none|strip)$")
+		message(FATAL_ERROR "Unknown VULKAN_RENDERER_SHADER_OPTIMIZATION ${VULKAN_RENDERER_SHADER_OPTIMIZATION}")
+	endif()
+	if(SPIRV_OPT_FLAGS AND NOT SPIRV_OPT_EXECUTABLE)
+		message(WARNING "spirv-opt was not found, shaders of ${TARGET_NAME} are only stripped")
+	endif()
 	file(GLOB SHADERS ${SHADER_DIR}/*.vert ${SHADER_DIR}/*.frag ${SHADER_DIR}/*.comp ${SHADER_DIR}/*.geom ${SHADER_DIR}/*.tesc ${SHADER_DIR}/*.tese ${SHADER_DIR}/*.mesh ${SHADER_DIR}/*.task ${SHADER_DIR}/*.rgen ${SHADER_DIR}/*.rchit ${SHADER_DIR}/*.rmiss)
 	
+	# one generate_shader run reflects every shader of the target in parallel and rewrites
+	# only the outputs whose content changed, the stamp keeps it from running on every build
+	set(MANIFEST_FILE ${CMAKE_CURRENT_BINARY_DIR}/${TARGET_NAME}_shaders.txt)
+	set(STAMP_FILE ${MANIFEST_FILE}.stamp)
+	file(MAKE_DIRECTORY ${SPV_DIR} ${HEADER_DIR})
+	set(MANIFEST_ENTRIES "")
+	set(SPV_FILES "")
+	set(GENERATED_FILES "")
+	set(EMBED_FILES "")
 	foreach(SHADER IN LISTS SHADERS)
 		get_filename_component(SHADER_NAME ${SHADER} NAME)
 		string(REPLACE "." "_" HEADER_NAME ${SHADER_NAME})
 		string(TOUPPER ${HEADER_NAME} GLOBAL_SHADER_VAR)
 		set(SPV_FILE "${SPV_DIR}/${SHADER_NAME}.spv")
-		set(SPV_TARGET "${HEADER_NAME}_spv")
 		set(HEADER_FILE "${HEADER_DIR}/${HEADER_NAME}.hpp")
-		set(HEADER_TARGET "${HEADER_NAME}_header")
 		set(GLSL_COMPILE_COMMAND ${GLSL_COMPILER_BIN} -I${SHADER_DIR} -V100 -o ${SPV_FILE} ${SHADER})
 
 		add_custom_command(OUTPUT ${SPV_FILE}
 			COMMAND ${GLSL_COMPILE_COMMAND}
 			DEPENDS ${SHADER}
 			COMMENT "Compiling ${FILENAME}: ${GLSL_COMPILE_COMMAND}")
-		add_custom_target(${SPV_TARGET} DEPENDS ${SPV_FILE})
-
-		add_custom_command(OUTPUT ${HEADER_FILE}
-			COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/generate_shader ${SPV_FILE} ${HEADER_FILE}
-			DEPENDS ${SPV_FILE} generate_shader
-			COMMENT "Generating ${HEADER_NAME}")
-		add_custom_target(${HEADER_TARGET} DEPENDS ${HEADER_FILE})
-		add_dependencies(${HEADER_TARGET} ${SPV_TARGET})
-		add_dependencies(${HEADER_TARGET} generate_shader)
+		list(APPEND SPV_FILES ${SPV_FILE})
+		set(CODE_FILE ${SPV_FILE})
+		if(NOT VULKAN_RENDERER_SHADER_OPTIMIZATION STREQUAL "none")
+			set(CODE_FILE "${SPV_DIR}/${SHADER_NAME}.opt.spv")
+			if(SPIRV_OPT_EXECUTABLE)
+				set(OPTIMIZE_COMMAND ${SPIRV_OPT_EXECUTABLE} ${SPIRV_OPT_FLAGS} --strip-debug --strip-nonsemantic -o ${CODE_FILE} ${SPV_FILE})
+			else()
+				set(OPTIMIZE_COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/generate_shader --strip ${SPV_FILE} ${CODE_FILE})
+			endif()
+			add_custom_command(OUTPUT ${CODE_FILE}
+				COMMAND ${OPTIMIZE_COMMAND}
+				DEPENDS ${SPV_FILE} generate_shader
+				COMMENT "Optimizing ${SHADER_NAME}")
+			list(APPEND SPV_FILES ${CODE_FILE})
+		endif()
+		# per shader generate_shader options, e.g. set_source_files_properties(shaders/mesh.vert
+		# PROPERTIES GENERATE_SHADER_OPTIONS "--vertex-format;inNormal=a2b10g10r10_snorm_pack32")
+		# compression is chosen per shader too, "--compression;spirv-lz" replaces its code by
+		# compressedCode for a vkr::ShaderLibrary
+		get_source_file_property(SHADER_OPTIONS ${SHADER} GENERATE_SHADER_OPTIONS)
+		if(SHADER_OPTIONS)
+			set(SHADER_OPTIONS ";${SHADER_OPTIONS}")
+		else()
+			set(SHADER_OPTIONS "")
+		endif()
+		if(NOT CODE_FILE STREQUAL SPV_FILE)
+			string(APPEND SHADER_OPTIONS ";--code;${CODE_FILE}")
+		endif()
 
-		add_dependencies(${TARGET_NAME} ${HEADER_TARGET})
+		if(EMBED_SHADERS)
+			set(EMBED_FILE "${HEADER_DIR}/${HEADER_NAME}.cpp")
+			string(APPEND MANIFEST_ENTRIES "${SPV_FILE};${HEADER_FILE};${EMBED_FILE}${SHADER_OPTIONS}\n")
+			list(APPEND GENERATED_FILES ${HEADER_FILE})
+			list(APPEND EMBED_FILES ${EMBED_FILE})
+			# the assembler reads the SPIR-V file, or the compressed one generate_shader writes next to the source
+			set(EMBEDDED_FILE ${CODE_FILE})
+			if("spirv-lz" IN_LIST SHADER_OPTIONS)
+				set(EMBEDDED_FILE "${HEADER_DIR}/${HEADER_NAME}.spvz")
+				list(APPEND EMBED_FILES ${EMBEDDED_FILE})
+			endif()
+			set_source_files_properties(${EMBED_FILE} PROPERTIES OBJECT_DEPENDS ${EMBEDDED_FILE})
+			target_sources(${TARGET_NAME} PRIVATE ${EMBED_FILE})
+		else()
+			string(APPEND MANIFEST_ENTRIES "${SPV_FILE};${HEADER_FILE}${SHADER_OPTIONS}\n")
+			list(APPEND GENERATED_FILES ${HEADER_FILE})
+		endif()
 	endforeach()
 
+	file(CONFIGURE OUTPUT ${MANIFEST_FILE} CONTENT "${MANIFEST_ENTRIES}" @ONLY)
+	# the sources compiled into the target are outputs so that only this command produces them,
+	# the stamp comes first for generators that order by the first output; the headers stay
+	# byproducts, a header whose content did not change keeps its time and its includers
+	add_custom_command(OUTPUT ${STAMP_FILE} ${EMBED_FILES}
+		BYPRODUCTS ${GENERATED_FILES}
+		COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/generate_shader --manifest ${MANIFEST_FILE}
+		COMMAND ${CMAKE_COMMAND} -E touch ${STAMP_FILE}
+		DEPENDS ${SPV_FILES} ${MANIFEST_FILE} generate_shader
+		COMMENT "Generating shader headers of ${TARGET_NAME}")
+
+	# the permutations of the shaders listed in variants.txt, compiled in parallel by generate_shader
+	# into one header per shader in which permutations with identical SPIR-V share their code
+	set(VARIANT_MANIFEST ${SHADER_DIR}/variants.txt)
+	if(EXISTS ${VARIANT_MANIFEST})
+		set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${VARIANT_MANIFEST})
+		file(STRINGS ${VARIANT_MANIFEST} VARIANT_LINES REGEX "^[^#=]+:")
+		set(VARIANT_SPV_DIR ${SPV_DIR}/variants)
+		set(VARIANT_STAMP_FILE ${CMAKE_CURRENT_BINARY_DIR}/${TARGET_NAME}_variants.stamp)
+		set(VARIANT_SOURCES "")
+		set(VARIANT_HEADERS "")
+		set(VARIANT_EMBED_FILES "")
+		foreach(VARIANT_LINE IN LISTS VARIANT_LINES)
+			string(REGEX REPLACE ":.*" "" VARIANT_SHADER "${VARIANT_LINE}")
+			string(STRIP ${VARIANT_SHADER} VARIANT_SHADER)
+			get_filename_component(VARIANT_NAME ${VARIANT_SHADER} NAME)
+			string(REPLACE "." "_" VARIANT_NAME ${VARIANT_NAME})
+			list(APPEND VARIANT_SOURCES ${SHADER_DIR}/${VARIANT_SHADER})
+			list(APPEND VARIANT_HEADERS ${HEADER_DIR}/${VARIANT_NAME}_variants.hpp)
+			if(EMBED_SHADERS)
+				list(APPEND VARIANT_EMBED_FILES ${HEADER_DIR}/${VARIANT_NAME}_variants.cpp)
+			endif()
+		endforeach()
+
+		# embedded modules are the compiled SPIR-V files, an embed source whose file names did
+		# not change is assembled again whenever the variants were compiled
+		set(VARIANT_EMBED_OPTIONS "")
+		if(EMBED_SHADERS)
+			set(VARIANT_EMBED_OPTIONS --embed-dir ${HEADER_DIR})
+			set_source_files_properties(${VARIANT_EMBED_FILES} PROPERTIES OBJECT_DEPENDS ${VARIANT_STAMP_FILE})
+			target_sources(${TARGET_NAME} PRIVATE ${VARIANT_EMBED_FILES})
+		endif()
+
+		file(MAKE_DIRECTORY ${VARIANT_SPV_DIR})
+		add_custom_command(OUTPUT ${VARIANT_STAMP_FILE} ${VARIANT_EMBED_FILES}
+			BYPRODUCTS ${VARIANT_HEADERS}
+			COMMAND ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/generate_shader --variants ${VARIANT_MANIFEST}
+				--compiler ${GLSL_COMPILER_BIN} --spirv-dir ${VARIANT_SPV_DIR} --header-dir ${HEADER_DIR} ${VARIANT_EMBED_OPTIONS}
+			COMMAND ${CMAKE_COMMAND} -E touch ${VARIANT_STAMP_FILE}
+			DEPENDS ${VARIANT_MANIFEST} ${VARIANT_SOURCES} generate_shader
+			COMMENT "Compiling shader variants of ${TARGET_NAME}")
+		list(APPEND STAMP_FILE ${VARIANT_STAMP_FILE})
+	endif()
+
+	add_custom_target(${TARGET_NAME}_shaders DEPENDS ${STAMP_FILE})
+	add_dependencies(${TARGET_NAME} ${TARGET_NAME}_shaders)
+
 	target_include_directories(${TARGET_NAME}
 		PUBLIC ${HEADER_DIR})
 
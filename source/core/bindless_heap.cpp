@@ -0,0 +1,238 @@
+#include "bindless_heap.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace vkr
+{
+	namespace
+	{
+		constexpr uint64_t SlotMask = 0xffffffffull;
+
+		BindlessHeapCreateInfo clampToLimits(const Device& device, BindlessHeapCreateInfo createInfo)
+		{
+			auto properties = device.getPhysicalDevice().getProperties2<vk::PhysicalDeviceProperties2,
+				vk::PhysicalDeviceVulkan12Properties>();
+			const auto& limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+			auto clamp = [](uint32_t count, uint32_t perStage, uint32_t perSet)
+				{
+					return std::clamp(count, 1u, std::min(perStage, perSet));
+				};
+
+			createInfo.sampledImageCount = clamp(createInfo.sampledImageCount,
+				limits.maxPerStageDescriptorUpdateAfterBindSampledImages, limits.maxDescriptorSetUpdateAfterBindSampledImages);
+			createInfo.storageBufferCount = clamp(createInfo.storageBufferCount,
+				limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers, limits.maxDescriptorSetUpdateAfterBindStorageBuffers);
+			createInfo.samplerCount = clamp(createInfo.samplerCount,
+				limits.maxPerStageDescriptorUpdateAfterBindSamplers, limits.maxDescriptorSetUpdateAfterBindSamplers);
+			return createInfo;
+		}
+
+		vk::raii::DescriptorSetLayout createLayout(const Device& device, const BindlessHeapCreateInfo& createInfo)
+		{
+			std::array bindings{
+				vk::DescriptorSetLayoutBinding{ BindlessHeap::SampledImageBinding, vk::DescriptorType::eSampledImage,
+					createInfo.sampledImageCount, vk::ShaderStageFlagBits::eAll },
+				vk::DescriptorSetLayoutBinding{ BindlessHeap::StorageBufferBinding, vk::DescriptorType::eStorageBuffer,
+					createInfo.storageBufferCount, vk::ShaderStageFlagBits::eAll },
+				vk::DescriptorSetLayoutBinding{ BindlessHeap::SamplerBinding, vk::DescriptorType::eSampler,
+					createInfo.samplerCount, vk::ShaderStageFlagBits::eAll },
+			};
+
+			// slots are written while earlier submissions still use the set, and only
+			// the slots a shader actually reaches have to be valid
+			vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::eUpdateAfterBind
+				| vk::DescriptorBindingFlagBits::ePartiallyBound
+				| vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+			std::array<vk::DescriptorBindingFlags, bindings.size()> allBindingFlags;
+			allBindingFlags.fill(bindingFlags);
+
+			vk::StructureChain<vk::DescriptorSetLayoutCreateInfo, vk::DescriptorSetLayoutBindingFlagsCreateInfo> layoutCreateInfo{
+				vk::DescriptorSetLayoutCreateInfo{ vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool, bindings },
+				vk::DescriptorSetLayoutBindingFlagsCreateInfo{ allBindingFlags } };
+			return vk::raii::DescriptorSetLayout{ device, layoutCreateInfo.get<vk::DescriptorSetLayoutCreateInfo>() };
+		}
+
+		vk::raii::DescriptorPool createPool(const Device& device, const BindlessHeapCreateInfo& createInfo)
+		{
+			std::array poolSizes{
+				vk::DescriptorPoolSize{ vk::DescriptorType::eSampledImage, createInfo.sampledImageCount },
+				vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, createInfo.storageBufferCount },
+				vk::DescriptorPoolSize{ vk::DescriptorType::eSampler, createInfo.samplerCount },
+			};
+			return vk::raii::DescriptorPool{ device,
+				vk::DescriptorPoolCreateInfo{ vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind, 1, poolSizes } };
+		}
+	}
+
+	SlotAllocator::SlotAllocator(uint32_t capacity)
+		:capacity{ std::min(capacity, InvalidSlot) },
+		freeHead{ InvalidSlot },
+		nextFree{ std::make_unique<std::atomic<uint32_t>[]>(this->capacity) } {}
+
+	std::optional<uint32_t> SlotAllocator::allocate() noexcept
+	{
+		uint64_t head = freeHead.load(std::memory_order_acquire);
+		while (static_cast<uint32_t>(head & SlotMask) != InvalidSlot)
+		{
+			uint32_t slot = static_cast<uint32_t>(head & SlotMask);
+			// may read a link another thread is rewriting, the tag then makes the exchange fail
+			uint64_t next = nextFree[slot].load(std::memory_order_relaxed);
+			uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+			if (freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+			{
+				usedCount.fetch_add(1, std::memory_order_relaxed);
+				return slot;
+			}
+		}
+
+		uint32_t unused = unusedBegin.load(std::memory_order_relaxed);
+		while (unused < capacity)
+		{
+			if (unusedBegin.compare_exchange_weak(unused, unused + 1, std::memory_order_relaxed))
+			{
+				usedCount.fetch_add(1, std::memory_order_relaxed);
+				return unused;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	void SlotAllocator::free(uint32_t slot) noexcept
+	{
+		uint64_t head = freeHead.load(std::memory_order_relaxed);
+		uint64_t newHead;
+		do
+		{
+			nextFree[slot].store(static_cast<uint32_t>(head & SlotMask), std::memory_order_relaxed);
+			newHead = (((head >> 32) + 1) << 32) | slot;
+		} while (!freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+
+		usedCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	BindlessHeap::BindlessHeap(const Device& device, const BindlessHeapCreateInfo& createInfo)
+		:device{ &device },
+		capacities{ clampToLimits(device, createInfo) },
+		sampledImageSlots{ capacities.sampledImageCount },
+		storageBufferSlots{ capacities.storageBufferCount },
+		samplerSlots{ capacities.samplerCount },
+		layout{ createLayout(device, capacities) },
+		descriptorPool{ createPool(device, capacities) }
+	{
+		vk::DescriptorSetLayout setLayout = *layout;
+		auto descriptorSets = vk::Device{ *device }.allocateDescriptorSets(
+			vk::DescriptorSetAllocateInfo{ *descriptorPool, setLayout }, *device.getDispatcher());
+		descriptorSet = descriptorSets.front();
+	}
+
+	uint32_t BindlessHeap::addSampledImage(vk::ImageView imageView, vk::ImageLayout imageLayout)
+	{
+		uint32_t index = allocateSlot(sampledImageSlots, "sampled image");
+
+		std::unique_lock lock{ mutex };
+		pendingImageWrites.push_back({ SampledImageBinding, index, vk::DescriptorImageInfo{ {}, imageView, imageLayout } });
+		return index;
+	}
+
+	uint32_t BindlessHeap::addStorageBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize range)
+	{
+		uint32_t index = allocateSlot(storageBufferSlots, "storage buffer");
+
+		std::unique_lock lock{ mutex };
+		pendingBufferWrites.push_back({ index, vk::DescriptorBufferInfo{ buffer, offset, range } });
+		return index;
+	}
+
+	uint32_t BindlessHeap::addSampler(vk::Sampler sampler)
+	{
+		uint32_t index = allocateSlot(samplerSlots, "sampler");
+
+		std::unique_lock lock{ mutex };
+		pendingImageWrites.push_back({ SamplerBinding, index, vk::DescriptorImageInfo{ sampler } });
+		return index;
+	}
+
+	// partially bound slots may keep a stale descriptor, shaders no longer index them;
+	// a write still queued for the slot is dropped before the slot can be handed out again,
+	// otherwise the next flush would write it over the slot's new descriptor
+	void BindlessHeap::removeSampledImage(uint32_t index) noexcept
+	{
+		dropImageWrites(SampledImageBinding, index);
+		sampledImageSlots.free(index);
+	}
+
+	void BindlessHeap::removeStorageBuffer(uint32_t index) noexcept
+	{
+		{
+			std::unique_lock lock{ mutex };
+			std::erase_if(pendingBufferWrites, [index](const PendingBufferWrite& write){ return write.index == index; });
+		}
+		storageBufferSlots.free(index);
+	}
+
+	void BindlessHeap::removeSampler(uint32_t index) noexcept
+	{
+		dropImageWrites(SamplerBinding, index);
+		samplerSlots.free(index);
+	}
+
+	void BindlessHeap::flush()
+	{
+		// the set is externally synchronized for updates, so they stay under the lock
+		std::unique_lock lock{ mutex };
+		if (pendingImageWrites.empty() && pendingBufferWrites.empty())
+			return;
+
+		std::vector<vk::WriteDescriptorSet> writes;
+		writes.reserve(pendingImageWrites.size() + pendingBufferWrites.size());
+		for (const auto& write : pendingImageWrites)
+		{
+			auto type = write.binding == SamplerBinding ? vk::DescriptorType::eSampler : vk::DescriptorType::eSampledImage;
+			writes.push_back(vk::WriteDescriptorSet{ descriptorSet, write.binding, write.index, 1, type, &write.imageInfo });
+		}
+		for (const auto& write : pendingBufferWrites)
+		{
+			writes.push_back(vk::WriteDescriptorSet{ descriptorSet, StorageBufferBinding, write.index, 1,
+				vk::DescriptorType::eStorageBuffer, nullptr, &write.bufferInfo });
+		}
+
+		device->updateDescriptorSets(writes, {});
+		pendingImageWrites.clear();
+		pendingBufferWrites.clear();
+	}
+
+	void BindlessHeap::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		// VK_EXT_descriptor_indexing is core since 1.2, its features live in Vulkan12Features
+		auto& features = createInfo.enabledFeatures12;
+		features.setDescriptorIndexing(true);
+		features.setRuntimeDescriptorArray(true);
+		features.setShaderSampledImageArrayNonUniformIndexing(true);
+		features.setShaderStorageBufferArrayNonUniformIndexing(true);
+		features.setDescriptorBindingSampledImageUpdateAfterBind(true);
+		features.setDescriptorBindingStorageBufferUpdateAfterBind(true);
+		features.setDescriptorBindingPartiallyBound(true);
+		features.setDescriptorBindingUpdateUnusedWhilePending(true);
+	}
+
+	void BindlessHeap::dropImageWrites(uint32_t binding, uint32_t index) noexcept
+	{
+		std::unique_lock lock{ mutex };
+		std::erase_if(pendingImageWrites, [binding, index](const PendingImageWrite& write)
+			{
+				return write.binding == binding && write.index == index;
+			});
+	}
+
+	uint32_t BindlessHeap::allocateSlot(SlotAllocator& slots, const char* name)
+	{
+		auto slot = slots.allocate();
+		if (!slot)
+			throw std::runtime_error(std::format("Bindless heap is out of {} slots ({} in use)", name, slots.getCapacity()));
+		return *slot;
+	}
+
+}// namespace vkr
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <atomic>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace vkr
+{
+	// lock free allocator of indices in [0, capacity), freed indices are kept on a
+	// Treiber stack whose head carries a tag against ABA, indices that were never
+	// handed out come from a bump counter so construction does not touch every slot
+	class SlotAllocator
+	{
+	public:
+		explicit SlotAllocator(uint32_t capacity);
+
+		SlotAllocator(const SlotAllocator&) = delete;
+		SlotAllocator& operator=(const SlotAllocator&) = delete;
+
+		// returns no value if every slot is in use
+		std::optional<uint32_t> allocate() noexcept;
+		void free(uint32_t slot) noexcept;
+
+		inline uint32_t getCapacity() const noexcept { return capacity; }
+		inline uint32_t getUsedCount() const noexcept { return usedCount.load(std::memory_order_relaxed); }
+
+	private:
+		static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+		uint32_t capacity;
+		// tag in the high half, slot in the low half
+		std::atomic<uint64_t> freeHead;
+		std::unique_ptr<std::atomic<uint32_t>[]> nextFree;
+		std::atomic<uint32_t> unusedBegin = 0;
+		std::atomic<uint32_t> usedCount = 0;
+	};
+
+	struct BindlessHeapCreateInfo
+	{
+		uint32_t sampledImageCount = 1 << 16;
+		uint32_t storageBufferCount = 1 << 16;
+		uint32_t samplerCount = 1 << 10;
+	};
+
+	// one update after bind descriptor set holding every sampled image, storage buffer
+	// and sampler, shaders index binding 0, 1 and 2 with the returned 32-bit indices;
+	// writes are queued and issued together by flush, which has to happen before the
+	// submission that reads them
+	class BindlessHeap
+	{
+	public:
+		static constexpr uint32_t SampledImageBinding = 0;
+		static constexpr uint32_t StorageBufferBinding = 1;
+		static constexpr uint32_t SamplerBinding = 2;
+
+		explicit BindlessHeap(const Device& device, const BindlessHeapCreateInfo& createInfo = {});
+
+		BindlessHeap(const BindlessHeap&) = delete;
+		BindlessHeap& operator=(const BindlessHeap&) = delete;
+
+		uint32_t addSampledImage(vk::ImageView imageView,
+			vk::ImageLayout imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal);
+		uint32_t addStorageBuffer(vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = VK_WHOLE_SIZE);
+		uint32_t addSampler(vk::Sampler sampler);
+
+		// the index may be handed out again right away, only remove what the gpu no longer reads
+		void removeSampledImage(uint32_t index) noexcept;
+		void removeStorageBuffer(uint32_t index) noexcept;
+		void removeSampler(uint32_t index) noexcept;
+
+		void flush();
+
+		inline const vk::raii::DescriptorSetLayout& getLayout() const noexcept { return layout; }
+		inline vk::DescriptorSet getDescriptorSet() const noexcept { return descriptorSet; }
+
+		inline const BindlessHeapCreateInfo& getCapacities() const noexcept { return capacities; }
+		inline const SlotAllocator& getSampledImageSlots() const noexcept { return sampledImageSlots; }
+		inline const SlotAllocator& getStorageBufferSlots() const noexcept { return storageBufferSlots; }
+		inline const SlotAllocator& getSamplerSlots() const noexcept { return samplerSlots; }
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		struct PendingImageWrite
+		{
+			uint32_t binding;
+			uint32_t index;
+			vk::DescriptorImageInfo imageInfo;
+		};
+
+		struct PendingBufferWrite
+		{
+			uint32_t index;
+			vk::DescriptorBufferInfo bufferInfo;
+		};
+
+		const Device* device;
+		// requested counts clamped to the device's update after bind limits
+		BindlessHeapCreateInfo capacities;
+		SlotAllocator sampledImageSlots;
+		SlotAllocator storageBufferSlots;
+		SlotAllocator samplerSlots;
+
+		vk::raii::DescriptorSetLayout layout;
+		vk::raii::DescriptorPool descriptorPool;
+		vk::DescriptorSet descriptorSet;
+
+		std::vector<PendingImageWrite> pendingImageWrites;
+		std::vector<PendingBufferWrite> pendingBufferWrites;
+		std::mutex mutex;
+
+		void dropImageWrites(uint32_t binding, uint32_t index) noexcept;
+		static uint32_t allocateSlot(SlotAllocator& slots, const char* name);
+	};
+
+}// namespace vkr
@@ -0,0 +1,100 @@
+#include "command_pool.hpp"
+
+namespace vkr
+{
+	namespace
+	{
+		constexpr uint32_t CommandBufferAllocateCount = 8;
+	}
+
+	void CommandPoolManager::FramePool::reset()
+	{
+		commandPool.reset();
+		usedCount[0] = 0;
+		usedCount[1] = 0;
+	}
+
+	CommandPoolManager::CommandPoolManager(const Device& device, uint32_t framesInFlight)
+		:device{ &device },
+		frames{ device, framesInFlight }
+	{
+		for (const auto& queueFamily : device.getQueueFamilies())
+		{
+			queueFamilyIndices.push_back(queueFamily.getQueueFamilyIndex());
+		}
+	}
+
+	vk::CommandBuffer CommandPoolManager::acquire(uint32_t queueFamilyIndex, vk::CommandBufferLevel level)
+	{
+		auto& pools = threadPools.get([this]{ return createThreadPools(); });
+		auto& framePool = pools.framePools[getQueueFamilySlot(queueFamilyIndex) * getFramesInFlight() + getFrameIndex()];
+
+		auto levelIndex = level == vk::CommandBufferLevel::ePrimary ? 0 : 1;
+		auto& commandBuffers = framePool.commandBuffers[levelIndex];
+		auto& usedCount = framePool.usedCount[levelIndex];
+
+		if (usedCount == commandBuffers.size())
+		{
+			vk::raii::CommandBuffers newCommandBuffers{ *device,
+				vk::CommandBufferAllocateInfo{ *framePool.commandPool, level, CommandBufferAllocateCount } };
+			for (auto& commandBuffer : newCommandBuffers)
+			{
+				// the pool owns them from now on
+				commandBuffers.push_back(commandBuffer.release());
+			}
+		}
+
+		return commandBuffers[usedCount++];
+	}
+
+	void CommandPoolManager::beginFrame(const vk::raii::Semaphore& timelineSemaphore)
+	{
+		frames.advance(timelineSemaphore, [this](uint32_t frameIndex)
+			{
+				threadPools.forEach([&](ThreadPools& pools)
+					{
+						for (uint32_t slot = 0; slot < queueFamilyIndices.size(); slot++)
+						{
+							pools.framePools[slot * getFramesInFlight() + frameIndex].reset();
+						}
+					});
+			});
+	}
+
+	void CommandPoolManager::endFrame(uint64_t timelineValue)
+	{
+		frames.setRetireValue(timelineValue);
+	}
+
+	void CommandPoolManager::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures12.setTimelineSemaphore(true);
+	}
+
+	std::unique_ptr<CommandPoolManager::ThreadPools> CommandPoolManager::createThreadPools()
+	{
+		auto pools = std::make_unique<ThreadPools>();
+		pools->framePools.reserve(queueFamilyIndices.size() * getFramesInFlight());
+		for (auto queueFamilyIndex : queueFamilyIndices)
+		{
+			for (uint32_t index = 0; index < getFramesInFlight(); index++)
+			{
+				vk::CommandPoolCreateInfo createInfo{ vk::CommandPoolCreateFlagBits::eTransient, queueFamilyIndex };
+				pools->framePools.push_back(FramePool{ vk::raii::CommandPool{ *device, createInfo } });
+			}
+		}
+
+		return pools;
+	}
+
+	uint32_t CommandPoolManager::getQueueFamilySlot(uint32_t queueFamilyIndex) const
+	{
+		for (uint32_t slot = 0; slot < queueFamilyIndices.size(); slot++)
+		{
+			if (queueFamilyIndices[slot] == queueFamilyIndex)
+				return slot;
+		}
+		throw std::runtime_error("Queue family was not created with the device");
+	}
+
+}// namespace vkr
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "frame_ring.hpp"
+#include "thread_registry.hpp"
+
+#include <memory>
+
+namespace vkr
+{
+	// hands out command buffers from per (thread, queue family, frame in flight) pools,
+	// whole pools are reset when their frame retires, buffers are never freed one by one
+	class CommandPoolManager
+	{
+	public:
+		CommandPoolManager(const Device& device, uint32_t framesInFlight);
+
+		CommandPoolManager(const CommandPoolManager&) = delete;
+		CommandPoolManager& operator=(const CommandPoolManager&) = delete;
+
+		// lock free after the calling thread's first request
+		vk::CommandBuffer acquire(uint32_t queueFamilyIndex,
+			vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
+
+		// moves to the next frame slot, waits until the timeline reaches the value
+		// recorded by endFrame for that slot and resets all its pools
+		void beginFrame(const vk::raii::Semaphore& timelineSemaphore);
+
+		// value the current frame's submissions signal on the timeline
+		void endFrame(uint64_t timelineValue);
+
+		inline uint32_t getFrameIndex() const noexcept { return frames.getIndex(); }
+		inline uint32_t getFramesInFlight() const noexcept { return frames.getSize(); }
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		struct FramePool
+		{
+			vk::raii::CommandPool commandPool;
+			std::vector<vk::CommandBuffer> commandBuffers[2];
+			size_t usedCount[2] = {};
+
+			void reset();
+		};
+
+		struct ThreadPools
+		{
+			// indexed by queueFamilySlot * framesInFlight + frameIndex
+			std::vector<FramePool> framePools;
+		};
+
+		const Device* device;
+		std::vector<uint32_t> queueFamilyIndices;
+		FrameRing frames;
+
+		ThreadRegistry<ThreadPools> threadPools;
+
+		std::unique_ptr<ThreadPools> createThreadPools();
+		uint32_t getQueueFamilySlot(uint32_t queueFamilyIndex) const;
+	};
+
+}// namespace vkr
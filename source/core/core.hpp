@@ -2,4 +2,23 @@
 
 #include "instance.hpp"
 #include "queue.hpp"
-#include "device.hpp"
\ No newline at end of file
+#include "memory_allocator.hpp"
+#include "sync_pool.hpp"
+#include "device.hpp"
+#include "submit_batcher.hpp"
+#include "command_pool.hpp"
+#include "staging_ring.hpp"
+#include "upload_pipeline.hpp"
+#include "pipeline_cache.hpp"
+#include "pipeline_description.hpp"
+#include "pipeline_compiler.hpp"
+#include "pipeline_registry.hpp"
+#include "descriptor_allocator.hpp"
+#include "bindless_heap.hpp"
+#include "render_graph.hpp"
+#include "render_graph_executor.hpp"
+#include "gpu_profiler.hpp"
+#include "query_manager.hpp"
+#include "shader_layout.hpp"
+#include "shader_library.hpp"
+#include "spirv_file.hpp"
\ No newline at end of file
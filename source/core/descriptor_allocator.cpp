@@ -0,0 +1,242 @@
+#include "descriptor_allocator.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace vkr
+{
+	namespace
+	{
+		bool sameBinding(const vk::DescriptorSetLayoutBinding& lhs, const vk::DescriptorSetLayoutBinding& rhs)
+		{
+			return lhs.binding == rhs.binding
+				&& lhs.descriptorType == rhs.descriptorType
+				&& lhs.descriptorCount == rhs.descriptorCount
+				&& lhs.stageFlags == rhs.stageFlags
+				&& (lhs.pImmutableSamplers == nullptr) == (rhs.pImmutableSamplers == nullptr);
+		}
+
+		size_t hashLayout(std::span<const vk::DescriptorSetLayoutBinding> bindings,
+			std::span<const vk::Sampler> immutableSamplers, vk::DescriptorSetLayoutCreateFlags flags)
+		{
+			size_t seed = 0;
+			auto combine = [&seed](uint64_t value)
+				{
+					seed ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+				};
+
+			combine(static_cast<VkDescriptorSetLayoutCreateFlags>(flags));
+			for (const auto& binding : bindings)
+			{
+				combine(binding.binding);
+				combine(static_cast<uint64_t>(binding.descriptorType));
+				combine(binding.descriptorCount);
+				combine(static_cast<VkShaderStageFlags>(binding.stageFlags));
+				combine(binding.pImmutableSamplers != nullptr);
+			}
+			for (auto sampler : immutableSamplers)
+			{
+				combine(reinterpret_cast<uint64_t>(static_cast<VkSampler>(sampler)));
+			}
+			return seed;
+		}
+	}
+
+	DescriptorLayout::DescriptorLayout(const Device& device, std::vector<vk::DescriptorSetLayoutBinding> bindings,
+		std::vector<vk::Sampler> immutableSamplers, vk::DescriptorSetLayoutCreateFlags flags)
+		:layout{ nullptr },
+		bindings{ std::move(bindings) },
+		immutableSamplers{ std::move(immutableSamplers) },
+		flags{ flags }
+	{
+		size_t samplerOffset = 0;
+		for (auto& binding : this->bindings)
+		{
+			if (binding.pImmutableSamplers)
+			{
+				binding.pImmutableSamplers = this->immutableSamplers.data() + samplerOffset;
+				samplerOffset += binding.descriptorCount;
+			}
+
+			auto typeIndex = static_cast<uint32_t>(binding.descriptorType);
+			if (typeIndex >= DescriptorTypeCount)
+				throw std::runtime_error(std::format("Descriptor type {} is not supported by descriptor pools",
+					vk::to_string(binding.descriptorType)));
+			descriptorCounts[typeIndex] += binding.descriptorCount;
+		}
+
+		layout = vk::raii::DescriptorSetLayout{ device, vk::DescriptorSetLayoutCreateInfo{ flags, this->bindings } };
+	}
+
+	DescriptorLayoutCache::DescriptorLayoutCache(const Device& device)
+		:device{ &device } {}
+
+	const DescriptorLayout& DescriptorLayoutCache::getLayout(std::span<const vk::DescriptorSetLayoutBinding> bindings,
+		vk::DescriptorSetLayoutCreateFlags flags)
+	{
+		std::vector<vk::DescriptorSetLayoutBinding> sortedBindings{ bindings.begin(), bindings.end() };
+		std::ranges::sort(sortedBindings, {}, &vk::DescriptorSetLayoutBinding::binding);
+
+		std::vector<vk::Sampler> immutableSamplers;
+		for (const auto& binding : sortedBindings)
+		{
+			if (binding.pImmutableSamplers)
+				immutableSamplers.insert(immutableSamplers.end(),
+					binding.pImmutableSamplers, binding.pImmutableSamplers + binding.descriptorCount);
+		}
+
+		size_t hash = hashLayout(sortedBindings, immutableSamplers, flags);
+
+		std::unique_lock lock{ mutex };
+
+		auto [begin, end] = layouts.equal_range(hash);
+		for (auto iter = begin; iter != end; iter++)
+		{
+			const auto& layout = *iter->second;
+			if (layout.flags == flags
+				&& layout.immutableSamplers == immutableSamplers
+				&& std::ranges::equal(layout.bindings, sortedBindings, sameBinding))
+				return layout;
+		}
+
+		auto layout = std::make_unique<DescriptorLayout>(*device, std::move(sortedBindings), std::move(immutableSamplers), flags);
+		return *layouts.emplace(hash, std::move(layout))->second;
+	}
+
+	size_t DescriptorLayoutCache::size() const
+	{
+		std::unique_lock lock{ mutex };
+		return layouts.size();
+	}
+
+	void DescriptorAllocator::PoolUsage::add(const DescriptorLayout& layout)
+	{
+		setCount++;
+		for (uint32_t type = 0; type < DescriptorTypeCount; type++)
+		{
+			descriptorCounts[type] += layout.getDescriptorCounts()[type];
+		}
+	}
+
+	void DescriptorAllocator::FrameChain::reset()
+	{
+		// a single pool held the whole frame, keep it; otherwise the next frame gets
+		// one pool large enough for everything this frame needed
+		if (pools.size() > 1)
+		{
+			nextCapacity = frameUsage;
+			pools.clear();
+		}
+		else if (!pools.empty())
+		{
+			pools.front().reset();
+		}
+
+		poolIndex = 0;
+		frameUsage = {};
+	}
+
+	DescriptorAllocator::DescriptorAllocator(const Device& device, uint32_t framesInFlight, uint32_t initialSetCount)
+		:device{ &device },
+		initialSetCount{ std::max(initialSetCount, 1u) },
+		frames{ device, framesInFlight } {}
+
+	vk::DescriptorSet DescriptorAllocator::allocate(const DescriptorLayout& layout)
+	{
+		auto& chain = threadChains.get([this]{ return createThreadChains(); }).frameChains[getFrameIndex()];
+		VkDescriptorSetLayout setLayout = *layout;
+
+		while (true)
+		{
+			bool freshPool = chain.poolIndex == chain.pools.size();
+			if (freshPool)
+				createPool(chain, layout);
+
+			VkDescriptorSetAllocateInfo allocateInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, nullptr,
+				*chain.pools[chain.poolIndex], 1, &setLayout };
+			VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+			// the C entry point reports a full pool as a result instead of an exception
+			auto result = static_cast<vk::Result>(device->getDispatcher()->vkAllocateDescriptorSets(
+				static_cast<VkDevice>(**device), &allocateInfo, &descriptorSet));
+
+			if (result == vk::Result::eSuccess)
+			{
+				chain.frameUsage.add(layout);
+				return descriptorSet;
+			}
+
+			if ((result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool) || freshPool)
+				throw std::runtime_error(std::format("Failed to allocate descriptor set: {}", vk::to_string(result)));
+
+			chain.poolIndex++;
+		}
+	}
+
+	void DescriptorAllocator::beginFrame(const vk::raii::Semaphore& timelineSemaphore)
+	{
+		frames.advance(timelineSemaphore, [this](uint32_t frameIndex)
+			{
+				threadChains.forEach([frameIndex](ThreadChains& chains)
+					{
+						chains.frameChains[frameIndex].reset();
+					});
+			});
+	}
+
+	void DescriptorAllocator::endFrame(uint64_t timelineValue)
+	{
+		frames.setRetireValue(timelineValue);
+	}
+
+	void DescriptorAllocator::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures12.setTimelineSemaphore(true);
+	}
+
+	std::unique_ptr<DescriptorAllocator::ThreadChains> DescriptorAllocator::createThreadChains()
+	{
+		auto chains = std::make_unique<ThreadChains>();
+		chains->frameChains.resize(getFramesInFlight());
+		return chains;
+	}
+
+	void DescriptorAllocator::createPool(FrameChain& chain, const DescriptorLayout& layout)
+	{
+		PoolUsage capacity;
+		if (chain.pools.empty() && chain.nextCapacity.setCount > 0)
+		{
+			// leave headroom so a frame slightly larger than the last one still fits
+			capacity.setCount = chain.nextCapacity.setCount + chain.nextCapacity.setCount / 4;
+			for (uint32_t type = 0; type < DescriptorTypeCount; type++)
+			{
+				capacity.descriptorCounts[type] = chain.nextCapacity.descriptorCounts[type]
+					+ chain.nextCapacity.descriptorCounts[type] / 4;
+			}
+		}
+		else
+		{
+			// spread the frame's usage so far, or the requesting layout, over twice the last pool
+			capacity.setCount = chain.pools.empty() ? initialSetCount : chain.lastPoolCapacity.setCount * 2;
+			const auto& usage = chain.frameUsage.setCount > 0 ? chain.frameUsage : PoolUsage{ 1, layout.getDescriptorCounts() };
+			for (uint32_t type = 0; type < DescriptorTypeCount; type++)
+			{
+				uint64_t count = static_cast<uint64_t>(usage.descriptorCounts[type]) * capacity.setCount / usage.setCount;
+				capacity.descriptorCounts[type] = static_cast<uint32_t>(count);
+			}
+		}
+
+		std::vector<vk::DescriptorPoolSize> poolSizes;
+		for (uint32_t type = 0; type < DescriptorTypeCount; type++)
+		{
+			// the requesting layout always fits into a fresh pool
+			uint32_t count = std::max(capacity.descriptorCounts[type], layout.getDescriptorCounts()[type]);
+			if (count > 0)
+				poolSizes.emplace_back(static_cast<vk::DescriptorType>(type), count);
+		}
+
+		chain.pools.emplace_back(*device, vk::DescriptorPoolCreateInfo{ {}, capacity.setCount, poolSizes });
+		chain.lastPoolCapacity = capacity;
+		createdPoolCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+}// namespace vkr
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "frame_ring.hpp"
+#include "thread_registry.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
+namespace vkr
+{
+	// descriptor counts indexed by vk::DescriptorType, the core types up to input attachment
+	constexpr uint32_t DescriptorTypeCount = static_cast<uint32_t>(vk::DescriptorType::eInputAttachment) + 1;
+	using DescriptorCounts = std::array<uint32_t, DescriptorTypeCount>;
+
+	class DescriptorLayout
+	{
+	public:
+		DescriptorLayout(const Device& device, std::vector<vk::DescriptorSetLayoutBinding> bindings,
+			std::vector<vk::Sampler> immutableSamplers, vk::DescriptorSetLayoutCreateFlags flags);
+
+		inline vk::DescriptorSetLayout operator*() const noexcept { return *layout; }
+		inline const vk::raii::DescriptorSetLayout& getLayout() const noexcept { return layout; }
+		inline const DescriptorCounts& getDescriptorCounts() const noexcept { return descriptorCounts; }
+
+	private:
+		friend class DescriptorLayoutCache;
+
+		vk::raii::DescriptorSetLayout layout;
+		// sorted by binding, pImmutableSamplers point into immutableSamplers
+		std::vector<vk::DescriptorSetLayoutBinding> bindings;
+		std::vector<vk::Sampler> immutableSamplers;
+		vk::DescriptorSetLayoutCreateFlags flags;
+		DescriptorCounts descriptorCounts{};
+	};
+
+	// creates one VkDescriptorSetLayout per distinct set of bindings, the order the
+	// bindings are given in does not matter
+	class DescriptorLayoutCache
+	{
+	public:
+		explicit DescriptorLayoutCache(const Device& device);
+
+		DescriptorLayoutCache(const DescriptorLayoutCache&) = delete;
+		DescriptorLayoutCache& operator=(const DescriptorLayoutCache&) = delete;
+
+		const DescriptorLayout& getLayout(std::span<const vk::DescriptorSetLayoutBinding> bindings,
+			vk::DescriptorSetLayoutCreateFlags flags = {});
+
+		size_t size() const;
+
+	private:
+		const Device* device;
+		std::unordered_multimap<size_t, std::unique_ptr<DescriptorLayout>> layouts;
+		mutable std::mutex mutex;
+	};
+
+	// hands out descriptor sets from per (thread, frame in flight) chains of pools, whole
+	// pools are reset when their frame retires, sets are never freed one by one; a chain
+	// that overflowed into several pools is replaced by one pool sized for that frame's usage
+	class DescriptorAllocator
+	{
+	public:
+		DescriptorAllocator(const Device& device, uint32_t framesInFlight, uint32_t initialSetCount = 256);
+
+		DescriptorAllocator(const DescriptorAllocator&) = delete;
+		DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+		// lock free after the calling thread's first request
+		vk::DescriptorSet allocate(const DescriptorLayout& layout);
+
+		// moves to the next frame slot, waits until the timeline reaches the value
+		// recorded by endFrame for that slot and resets all its pools
+		void beginFrame(const vk::raii::Semaphore& timelineSemaphore);
+
+		// value the current frame's submissions signal on the timeline
+		void endFrame(uint64_t timelineValue);
+
+		inline uint32_t getFrameIndex() const noexcept { return frames.getIndex(); }
+		inline uint32_t getFramesInFlight() const noexcept { return frames.getSize(); }
+		// number of descriptor pools created so far, stays flat once the chains are sized
+		inline uint64_t getCreatedPoolCount() const noexcept { return createdPoolCount.load(std::memory_order_relaxed); }
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		struct PoolUsage
+		{
+			uint32_t setCount = 0;
+			DescriptorCounts descriptorCounts{};
+
+			void add(const DescriptorLayout& layout);
+		};
+
+		struct FrameChain
+		{
+			std::vector<vk::raii::DescriptorPool> pools;
+			size_t poolIndex = 0;
+			PoolUsage lastPoolCapacity;
+			PoolUsage frameUsage;
+			// capacity of the first pool after an overflowing frame
+			PoolUsage nextCapacity;
+
+			void reset();
+		};
+
+		struct ThreadChains
+		{
+			std::vector<FrameChain> frameChains;
+		};
+
+		const Device* device;
+		uint32_t initialSetCount;
+		FrameRing frames;
+		std::atomic<uint64_t> createdPoolCount = 0;
+
+		ThreadRegistry<ThreadChains> threadChains;
+
+		std::unique_ptr<ThreadChains> createThreadChains();
+		void createPool(FrameChain& chain, const DescriptorLayout& layout);
+	};
+
+}// namespace vkr
@@ -13,7 +13,14 @@ namespace vkr
 
 	Device::Device(const vk::raii::PhysicalDevice& physicalDevice, const DeviceCreateInfo& createInfo, std::span<const vk::DeviceQueueCreateInfo> queueCreateInfos)
 		:vk::raii::Device{ getDevice(physicalDevice, createInfo, queueCreateInfos) },
-		queueFamilies{ *this, queueCreateInfos }
+		physicalDevice{ physicalDevice },
+		enabledFeatures{ createInfo.enabledFeatures },
+		queueFamilies{ *this, queueCreateInfos },
+		memoryAllocator{ physicalDevice.getMemoryProperties(),
+			physicalDevice.getProperties().limits.bufferImageGranularity,
+			getMemoryCallbacks() },
+		fencePool{ *this },
+		semaphorePool{ *this }
 	{
 		std::cout << "Success to create device\n";
 	}
@@ -35,10 +42,41 @@ namespace vkr
 		vk::DeviceCreateInfo createInfo;
 		createInfo.setPEnabledLayerNames(deviceCreateInfo.enabledLayers);
 		createInfo.setPEnabledExtensionNames(deviceCreateInfo.enabledExtensions);
-		createInfo.setPEnabledFeatures(&deviceCreateInfo.enabledFeatures);
 		createInfo.setQueueCreateInfos(queueCreateInfos);
 
-		return vk::raii::Device{ physicalDevice, createInfo };
+		vk::StructureChain<vk::DeviceCreateInfo,
+			vk::PhysicalDeviceFeatures2,
+			vk::PhysicalDeviceVulkan12Features,
+			vk::PhysicalDeviceVulkan13Features> createInfoChain{
+				createInfo,
+				vk::PhysicalDeviceFeatures2{ deviceCreateInfo.enabledFeatures },
+				deviceCreateInfo.enabledFeatures12,
+				deviceCreateInfo.enabledFeatures13 };
+
+		return vk::raii::Device{ physicalDevice, createInfoChain.get<vk::DeviceCreateInfo>() };
+	}
+
+	MemoryCallbacks Device::getMemoryCallbacks() const
+	{
+		MemoryCallbacks callbacks;
+		callbacks.allocate = [this](const vk::MemoryAllocateInfo& allocateInfo) -> vk::DeviceMemory
+			{
+				vk::raii::DeviceMemory memory{ *this, allocateInfo };
+				return memory.release();
+			};
+		callbacks.free = [this](vk::DeviceMemory memory)
+			{
+				// adopting the handle frees it when the wrapper goes out of scope
+				vk::raii::DeviceMemory{ *this, static_cast<VkDeviceMemory>(memory) };
+			};
+		callbacks.map = [this](vk::DeviceMemory memory) -> void*
+			{
+				vk::raii::DeviceMemory deviceMemory{ *this, static_cast<VkDeviceMemory>(memory) };
+				void* data = deviceMemory.mapMemory(0, VK_WHOLE_SIZE);
+				deviceMemory.release();
+				return data;
+			};
+		return callbacks;
 	}
 
 }// namespace vkr
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "queue.hpp"
+#include "memory_allocator.hpp"
+#include "sync_pool.hpp"
 
 namespace vkr
 {
@@ -11,6 +13,8 @@ namespace vkr
 		std::vector<const char*> enabledLayers;
 		std::vector<const char*> enabledExtensions;
 		vk::PhysicalDeviceFeatures enabledFeatures;
+		vk::PhysicalDeviceVulkan12Features enabledFeatures12;
+		vk::PhysicalDeviceVulkan13Features enabledFeatures13;
 	};
 
 	class Device : public vk::raii::Device
@@ -36,23 +40,48 @@ namespace vkr
 			const DeviceCreateInfo& createInfo,
 			std::span<QueueRequirement> queueRequirements);
 
+		inline auto& getPhysicalDevice() const { return physicalDevice; }
 		inline auto& getQueueFamilies() const { return queueFamilies; }
+		// core features the device was created with, for components whose features are optional
+		inline const vk::PhysicalDeviceFeatures& getEnabledFeatures() const noexcept { return enabledFeatures; }
+		inline MemoryAllocator& getMemoryAllocator() noexcept { return memoryAllocator; }
+		inline const MemoryAllocator& getMemoryAllocator() const noexcept { return memoryAllocator; }
+		// the pools lock internally, they can be used through a const device
+		inline FencePool& getFencePool() const noexcept { return fencePool; }
+		inline SemaphorePool& getSemaphorePool() const noexcept { return semaphorePool; }
 
 	private:
+		vk::raii::PhysicalDevice physicalDevice;
+		vk::PhysicalDeviceFeatures enabledFeatures;
 		QueueFamilies queueFamilies;
+		MemoryAllocator memoryAllocator;
+		mutable FencePool fencePool;
+		mutable SemaphorePool semaphorePool;
 
 		vk::raii::Device getDevice(const vk::raii::PhysicalDevice& physicalDevice,
 			const DeviceCreateInfo& createInfo,
 			std::span<const vk::DeviceQueueCreateInfo> queueCreateInfos) const;
+
+		MemoryCallbacks getMemoryCallbacks() const;
 	};
 
+	// components with optional features take the physical device to enable only what it supports
+	template<class T>
+	void setDeviceCreateInfo(DeviceCreateInfo& createInfo, const vk::raii::PhysicalDevice& physicalDevice)
+	{
+		if constexpr (requires{ T::setDeviceCreateInfo(createInfo, physicalDevice); })
+			T::setDeviceCreateInfo(createInfo, physicalDevice);
+		else
+			T::setDeviceCreateInfo(createInfo);
+	}
+
 	//if sizeof...(args) is 0, it's GPU only mode
 	template<class ... Ts>
 	Device createDevice(const vk::raii::PhysicalDevice& physicalDevice, auto&& ... args)
 		requires requires{ Device{ physicalDevice, DeviceCreateInfo{}, args... }; }
 	{
 		DeviceCreateInfo createInfo{};
-		(Ts::setDeviceCreateInfo(createInfo), ...);
+		(setDeviceCreateInfo<Ts>(createInfo, physicalDevice), ...);
 		return Device{ physicalDevice, createInfo, args... };
 	}
 
@@ -0,0 +1,19 @@
+#include "frame_ring.hpp"
+
+namespace vkr
+{
+	FrameRing::FrameRing(const Device& device, uint32_t framesInFlight)
+		:device{ &device },
+		retireValues(std::max(framesInFlight, 1u), 0) {}
+
+	void FrameRing::waitForRetirement(const vk::raii::Semaphore& timelineSemaphore, uint32_t slot) const
+	{
+		vk::Semaphore semaphore = *timelineSemaphore;
+		vk::SemaphoreWaitInfo waitInfo;
+		waitInfo.setSemaphores(semaphore);
+		waitInfo.setValues(retireValues[slot]);
+		if (device->waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+			throw std::runtime_error("Failed to wait for frame retirement");
+	}
+
+}// namespace vkr
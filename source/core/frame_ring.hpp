@@ -0,0 +1,45 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace vkr
+{
+	// the frame in flight slots of per frame resources, a slot is reused once the timeline
+	// reached the value the last frame recorded in it signals
+	class FrameRing
+	{
+	public:
+		FrameRing(const Device& device, uint32_t framesInFlight);
+
+		FrameRing(const FrameRing&) = delete;
+		FrameRing& operator=(const FrameRing&) = delete;
+
+		// waits until the next slot retired, lets resetSlot(index) reset its resources and
+		// only then makes it the current slot
+		template<class F>
+		void advance(const vk::raii::Semaphore& timelineSemaphore, F&& resetSlot)
+		{
+			uint32_t nextIndex = (getIndex() + 1) % getSize();
+			waitForRetirement(timelineSemaphore, nextIndex);
+			resetSlot(nextIndex);
+			index.store(nextIndex, std::memory_order_release);
+		}
+
+		// value the current slot's submissions signal on the timeline
+		inline void setRetireValue(uint64_t timelineValue) { retireValues[getIndex()] = timelineValue; }
+
+		inline uint32_t getIndex() const noexcept { return index.load(std::memory_order_acquire); }
+		inline uint32_t getSize() const noexcept { return static_cast<uint32_t>(retireValues.size()); }
+
+	private:
+		const Device* device;
+		std::vector<uint64_t> retireValues;
+		std::atomic<uint32_t> index = 0;
+
+		void waitForRetirement(const vk::raii::Semaphore& timelineSemaphore, uint32_t slot) const;
+	};
+
+}// namespace vkr
@@ -0,0 +1,152 @@
+#include "gpu_profiler.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace vkr
+{
+	namespace
+	{
+		void writeJsonString(std::ostream& stream, std::string_view string)
+		{
+			stream << '"';
+			for (char c : string)
+			{
+				if (c == '"' || c == '\\')
+					stream << '\\' << c;
+				else if (static_cast<unsigned char>(c) < 0x20)
+					stream << std::format("\\u{:04x}", static_cast<uint32_t>(c));
+				else
+					stream << c;
+			}
+			stream << '"';
+		}
+	}
+
+	GpuProfiler::GpuProfiler(const Device& device, const Queue& queue, uint32_t framesInFlight, uint32_t maxZonesPerFrame)
+		:queueFamilyIndex{ queue.getQueueFamilyIndex() },
+		maxZonesPerFrame{ maxZonesPerFrame },
+		timestampPeriod{ device.getPhysicalDevice().getProperties().limits.timestampPeriod }
+	{
+		auto validBits = device.getPhysicalDevice().getQueueFamilyProperties()[queueFamilyIndex].timestampValidBits;
+		if (validBits == 0)
+			throw std::runtime_error(std::format("Queue family {} does not support timestamps", queueFamilyIndex));
+		timestampMask = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+
+		vk::QueryPoolCreateInfo createInfo{ {}, vk::QueryType::eTimestamp, 2 * maxZonesPerFrame };
+		for (uint32_t index = 0; index < std::max(framesInFlight, 1u); index++)
+		{
+			auto& frameQueries = frames.emplace_back(new FrameQueries{ vk::raii::QueryPool{ device, createInfo } });
+			frameQueries->names.resize(maxZonesPerFrame);
+			frameQueries->queryPool.reset(0, 2 * maxZonesPerFrame);
+		}
+	}
+
+	void GpuProfiler::beginFrame()
+	{
+		frameIndex = (frameIndex + 1) % static_cast<uint32_t>(frames.size());
+		frameNumber++;
+
+		auto& frameQueries = *frames[frameIndex];
+		resolveFrame(frameQueries);
+		frameQueries.frame = frameNumber;
+	}
+
+	uint32_t GpuProfiler::beginZone(const vk::raii::CommandBuffer& commandBuffer, std::string_view name,
+		vk::PipelineStageFlags2 stage)
+	{
+		auto& frameQueries = *frames[frameIndex];
+		uint32_t zone = frameQueries.zoneCount.fetch_add(1, std::memory_order_relaxed);
+		if (zone >= maxZonesPerFrame)
+		{
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return UINT32_MAX;
+		}
+
+		frameQueries.names[zone] = name;
+		commandBuffer.writeTimestamp2(stage, *frameQueries.queryPool, 2 * zone);
+		return zone;
+	}
+
+	void GpuProfiler::endZone(const vk::raii::CommandBuffer& commandBuffer, uint32_t zone, vk::PipelineStageFlags2 stage)
+	{
+		if (zone == UINT32_MAX)
+			return;
+
+		commandBuffer.writeTimestamp2(stage, *frames[frameIndex]->queryPool, 2 * zone + 1);
+	}
+
+	void GpuProfiler::resolve()
+	{
+		for (auto& frameQueries : frames)
+		{
+			resolveFrame(*frameQueries);
+		}
+	}
+
+	void GpuProfiler::writeChromeTrace(std::ostream& stream) const
+	{
+		stream << "{\"traceEvents\":[";
+		for (size_t index = 0; index < zones.size(); index++)
+		{
+			const auto& zone = zones[index];
+			stream << (index ? ",\n" : "\n") << "{\"name\":";
+			writeJsonString(stream, zone.name);
+			stream << std::format(",\"cat\":\"gpu\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":{},\"args\":{{\"frame\":{}}}}}",
+				zone.beginMicroseconds, zone.durationMicroseconds, queueFamilyIndex, zone.frame);
+		}
+		stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+	}
+
+	void GpuProfiler::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures12.setHostQueryReset(true);
+		createInfo.enabledFeatures13.setSynchronization2(true);
+	}
+
+	void GpuProfiler::resolveFrame(FrameQueries& frameQueries)
+	{
+		uint32_t zoneCount = std::min(frameQueries.zoneCount.load(std::memory_order_relaxed), maxZonesPerFrame);
+		if (zoneCount == 0)
+			return;
+
+		// value and availability per query, zones never submitted stay unavailable and are skipped
+		uint32_t queryCount = 2 * zoneCount;
+		auto values = frameQueries.queryPool.getResults<uint64_t>(0, queryCount,
+			queryCount * 2 * sizeof(uint64_t), 2 * sizeof(uint64_t),
+			vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability).second;
+
+		auto isAvailable = [&](uint32_t zone) { return values[4 * zone + 1] && values[4 * zone + 3]; };
+
+		// zones recorded on several threads are not in time order, the earliest of the first
+		// resolved frame is the origin of the trace
+		if (firstTimestamp == UINT64_MAX)
+		{
+			for (uint32_t zone = 0; zone < zoneCount; zone++)
+			{
+				if (isAvailable(zone))
+					firstTimestamp = std::min(firstTimestamp, values[4 * zone] & timestampMask);
+			}
+		}
+
+		for (uint32_t zone = 0; zone < zoneCount; zone++)
+		{
+			if (!isAvailable(zone))
+				continue;
+
+			uint64_t beginTicks = values[4 * zone] & timestampMask;
+			uint64_t endTicks = values[4 * zone + 2] & timestampMask;
+			// the counter wraps after its valid bits
+			uint64_t durationTicks = (endTicks - beginTicks) & timestampMask;
+			auto beginOffset = static_cast<int64_t>(beginTicks - firstTimestamp);
+
+			zones.push_back(GpuZone{ std::move(frameQueries.names[zone]), frameQueries.frame,
+				static_cast<double>(beginOffset) * timestampPeriod / 1000.0,
+				static_cast<double>(durationTicks) * timestampPeriod / 1000.0 });
+		}
+
+		frameQueries.queryPool.reset(0, queryCount);
+		frameQueries.zoneCount.store(0, std::memory_order_relaxed);
+	}
+
+}// namespace vkr
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace vkr
+{
+	struct GpuZone
+	{
+		std::string name;
+		uint64_t frame = 0;
+		// relative to the first resolved timestamp of the profiler
+		double beginMicroseconds = 0.0;
+		double durationMicroseconds = 0.0;
+	};
+
+	// times command buffer regions of one queue with timestamp queries, one query pool per frame
+	// in flight; a frame's results are read when its slot comes around again, by then the frame
+	// retired and the read never waits
+	class GpuProfiler
+	{
+	public:
+		// ends its zone when destroyed
+		class Scope
+		{
+		public:
+			Scope(GpuProfiler& profiler, const vk::raii::CommandBuffer& commandBuffer, std::string_view name)
+				:profiler{ &profiler }, commandBuffer{ &commandBuffer }, zone{ profiler.beginZone(commandBuffer, name) } {}
+			~Scope() noexcept { profiler->endZone(*commandBuffer, zone); }
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			GpuProfiler* profiler;
+			const vk::raii::CommandBuffer* commandBuffer;
+			uint32_t zone;
+		};
+
+		// zones go into command buffers submitted to queue
+		GpuProfiler(const Device& device, const Queue& queue, uint32_t framesInFlight, uint32_t maxZonesPerFrame = 1024);
+
+		GpuProfiler(const GpuProfiler&) = delete;
+		GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+		// moves to the next frame slot and resolves the zones it held, the frame that last
+		// used the slot must have retired, as after CommandPoolManager::beginFrame
+		void beginFrame();
+
+		// safe from several recording threads; returns UINT32_MAX once the frame is out of zones
+		uint32_t beginZone(const vk::raii::CommandBuffer& commandBuffer, std::string_view name,
+			vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eTopOfPipe);
+		void endZone(const vk::raii::CommandBuffer& commandBuffer, uint32_t zone,
+			vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eBottomOfPipe);
+
+		// resolves every frame slot, only once the queue is idle
+		void resolve();
+
+		inline const std::vector<GpuZone>& getZones() const noexcept { return zones; }
+		inline void clearZones() noexcept { zones.clear(); }
+		// zones that did not fit into their frame
+		inline uint64_t getDroppedCount() const noexcept { return droppedCount.load(std::memory_order_relaxed); }
+
+		// trace event format, loads in chrome://tracing and Perfetto
+		void writeChromeTrace(std::ostream& stream) const;
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		struct FrameQueries
+		{
+			vk::raii::QueryPool queryPool;
+			std::vector<std::string> names;
+			std::atomic<uint32_t> zoneCount = 0;
+			uint64_t frame = 0;
+		};
+
+		uint32_t queueFamilyIndex;
+		uint32_t maxZonesPerFrame;
+		uint64_t timestampMask;
+		// nanoseconds per tick
+		double timestampPeriod;
+		uint64_t firstTimestamp = UINT64_MAX;
+
+		std::vector<std::unique_ptr<FrameQueries>> frames;
+		uint32_t frameIndex = 0;
+		uint64_t frameNumber = 0;
+		std::vector<GpuZone> zones;
+		std::atomic<uint64_t> droppedCount = 0;
+
+		void resolveFrame(FrameQueries& frameQueries);
+	};
+
+}// namespace vkr
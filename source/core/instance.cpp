@@ -4,9 +4,10 @@
 
 namespace vkr
 {
-	Instance::Instance(std::span<const char* const> enabledLayers, std::span<const char* const> enabledExtensions)
+	Instance::Instance(std::span<const char* const> enabledLayers, std::span<const char* const> enabledExtensions,
+		uint32_t apiVersion)
 		:context{},
-		instance{ getInstance(enabledLayers,enabledExtensions) },
+		instance{ getInstance(enabledLayers, enabledExtensions, apiVersion) },
 #ifdef VULKAN_RENDERER_DEBUG
 		debugMessenger{ instance, getDebugUtilsCreateInfo() }
 #else
@@ -17,7 +18,7 @@ namespace vkr
 	}
 
 	Instance::Instance(const InstanceCreateInfo& createInfo)
-		:Instance{ createInfo.enabledLayers, createInfo.enabledExtensions } {}
+		:Instance{ createInfo.enabledLayers, createInfo.enabledExtensions, createInfo.apiVersion } {}
 
 	vk::raii::PhysicalDevice Instance::getPhysicalDevice(uint32_t index) const
 	{
@@ -60,9 +61,14 @@ namespace vkr
 
 	vk::raii::Instance Instance::getInstance(
 		std::span<const char* const> enabledLayers, 
-		std::span<const char* const> enabledExtensions)const
+		std::span<const char* const> enabledExtensions,
+		uint32_t apiVersion)const
 	{
+		vk::ApplicationInfo applicationInfo;
+		applicationInfo.setApiVersion(apiVersion);
+
 		vk::InstanceCreateInfo createInfo;
+		createInfo.setPApplicationInfo(&applicationInfo);
 		createInfo.setPEnabledLayerNames(enabledLayers);
 		createInfo.setPEnabledExtensionNames(enabledExtensions);
 #ifdef VULKAN_RENDERER_DEBUG
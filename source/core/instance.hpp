@@ -12,12 +12,14 @@ namespace vkr
 
 		std::vector<const char*> enabledLayers;
 		std::vector<const char*> enabledExtensions;
+		uint32_t apiVersion = VK_API_VERSION_1_3;
 	};
 
 	class Instance
 	{
 	public:
-		Instance(std::span<const char* const> enabledLayers, std::span<const char* const> enabledExtensions);
+		Instance(std::span<const char* const> enabledLayers, std::span<const char* const> enabledExtensions,
+			uint32_t apiVersion = VK_API_VERSION_1_3);
 		Instance(const InstanceCreateInfo& createInfo);
 
 		inline operator vk::raii::Instance& () noexcept { return instance; }
@@ -35,7 +37,8 @@ namespace vkr
 		vk::raii::Instance instance;
 		vk::raii::DebugUtilsMessengerEXT debugMessenger;
 
-		vk::raii::Instance getInstance(std::span<const char* const> enabledLayers, std::span<const char* const> enabledExtensions)const;
+		vk::raii::Instance getInstance(std::span<const char* const> enabledLayers, std::span<const char* const> enabledExtensions,
+			uint32_t apiVersion)const;
 		vk::DebugUtilsMessengerCreateInfoEXT getDebugUtilsCreateInfo() const;
 	};
 
@@ -0,0 +1,459 @@
+#include "memory_allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace vkr
+{
+	struct TlsfAllocator::Range
+	{
+		vk::DeviceSize offset;
+		vk::DeviceSize size;
+		bool free = true;
+		Range* prevPhysical = nullptr;
+		Range* nextPhysical = nullptr;
+		Range* prevFree = nullptr;
+		Range* nextFree = nullptr;
+	};
+
+	namespace
+	{
+		inline vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) noexcept
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+	TlsfAllocator::TlsfAllocator(vk::DeviceSize size)
+		:size{ size }
+	{
+		firstRange = new Range{ 0, size };
+		insertFreeRange(firstRange);
+	}
+
+	TlsfAllocator::~TlsfAllocator() noexcept
+	{
+		while (firstRange)
+		{
+			auto next = firstRange->nextPhysical;
+			delete firstRange;
+			firstRange = next;
+		}
+	}
+
+	TlsfAllocator::Allocation TlsfAllocator::allocate(vk::DeviceSize allocationSize, vk::DeviceSize alignment)
+	{
+		alignment = std::max<vk::DeviceSize>(alignment, 1);
+		allocationSize = std::max<vk::DeviceSize>(allocationSize, 1);
+
+		auto range = findFreeRange(allocationSize + alignment - 1);
+		if (!range)
+			return {};
+		removeFreeRange(range);
+
+		auto alignedOffset = alignUp(range->offset, alignment);
+		if (alignedOffset != range->offset)
+		{
+			auto padding = range;
+			range = splitRange(range, alignedOffset);
+			insertFreeRange(padding);
+		}
+
+		auto endOffset = alignUp(range->offset + allocationSize, MinRangeSize);
+		if (range->offset + range->size >= endOffset + MinRangeSize)
+		{
+			insertFreeRange(splitRange(range, endOffset));
+		}
+
+		range->free = false;
+		allocationCount++;
+		return { range->offset, range->size, range };
+	}
+
+	void TlsfAllocator::free(const Allocation& allocation)
+	{
+		auto range = allocation.range;
+		if (!range)
+			return;
+		// a freed range may be merged and deleted already, so a second free cannot be told
+		// apart by reading it; debug builds look the pointer up among the live ranges instead
+		assert(isAllocated(range));
+
+		range->free = true;
+		allocationCount--;
+
+		if (range->prevPhysical && range->prevPhysical->free)
+		{
+			auto prev = range->prevPhysical;
+			removeFreeRange(prev);
+			mergeRange(prev, range);
+			range = prev;
+		}
+		if (range->nextPhysical && range->nextPhysical->free)
+		{
+			removeFreeRange(range->nextPhysical);
+			mergeRange(range, range->nextPhysical);
+		}
+		insertFreeRange(range);
+	}
+
+	vk::DeviceSize TlsfAllocator::getLargestFreeSize() const noexcept
+	{
+		if (!firstLevelBitmap)
+			return 0;
+
+		uint32_t firstLevel = 63 - std::countl_zero(firstLevelBitmap);
+		uint32_t secondLevel = 31 - std::countl_zero(secondLevelBitmaps[firstLevel]);
+
+		vk::DeviceSize largest = 0;
+		for (auto range = freeLists[firstLevel][secondLevel]; range; range = range->nextFree)
+		{
+			largest = std::max(largest, range->size);
+		}
+		return largest;
+	}
+
+	std::pair<uint32_t, uint32_t> TlsfAllocator::mapping(vk::DeviceSize size) noexcept
+	{
+		if (size < (1ull << SmallSizeBits))
+			return { 0, static_cast<uint32_t>(size >> (SmallSizeBits - SecondLevelBits)) };
+
+		uint32_t mostSignificantBit = 63 - std::countl_zero(size);
+		uint32_t firstLevel = mostSignificantBit - SmallSizeBits + 1;
+		uint32_t secondLevel = static_cast<uint32_t>(size >> (mostSignificantBit - SecondLevelBits)) & (SecondLevelCount - 1);
+		return { firstLevel, secondLevel };
+	}
+
+	TlsfAllocator::Range* TlsfAllocator::findFreeRange(vk::DeviceSize size) const noexcept
+	{
+		// round up to the next list so every range found there is large enough
+		if (size < (1ull << SmallSizeBits))
+		{
+			size = alignUp(size, 1ull << (SmallSizeBits - SecondLevelBits));
+		}
+		else
+		{
+			uint32_t mostSignificantBit = 63 - std::countl_zero(size);
+			vk::DeviceSize roundedSize = size + (1ull << (mostSignificantBit - SecondLevelBits)) - 1;
+			if (roundedSize < size)
+				return nullptr;
+			size = roundedSize;
+		}
+
+		auto [firstLevel, secondLevel] = mapping(size);
+		if (firstLevel >= FirstLevelCount)
+			return nullptr;
+
+		uint32_t secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+		if (!secondLevelMap)
+		{
+			if (firstLevel + 1 >= FirstLevelCount)
+				return nullptr;
+			uint64_t firstLevelMap = firstLevelBitmap & (~0ull << (firstLevel + 1));
+			if (!firstLevelMap)
+				return nullptr;
+			firstLevel = std::countr_zero(firstLevelMap);
+			secondLevelMap = secondLevelBitmaps[firstLevel];
+		}
+		secondLevel = std::countr_zero(secondLevelMap);
+
+		return freeLists[firstLevel][secondLevel];
+	}
+
+	bool TlsfAllocator::isAllocated(const Range* range) const noexcept
+	{
+		for (auto physical = firstRange; physical; physical = physical->nextPhysical)
+		{
+			if (physical == range)
+				return !physical->free;
+		}
+		return false;
+	}
+
+	void TlsfAllocator::insertFreeRange(Range* range) noexcept
+	{
+		auto [firstLevel, secondLevel] = mapping(range->size);
+		auto& head = freeLists[firstLevel][secondLevel];
+
+		range->free = true;
+		range->prevFree = nullptr;
+		range->nextFree = head;
+		if (head)
+			head->prevFree = range;
+		head = range;
+
+		firstLevelBitmap |= 1ull << firstLevel;
+		secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+		freeSize += range->size;
+		freeRangeCount++;
+	}
+
+	void TlsfAllocator::removeFreeRange(Range* range) noexcept
+	{
+		auto [firstLevel, secondLevel] = mapping(range->size);
+		auto& head = freeLists[firstLevel][secondLevel];
+
+		if (range->prevFree)
+			range->prevFree->nextFree = range->nextFree;
+		else
+			head = range->nextFree;
+		if (range->nextFree)
+			range->nextFree->prevFree = range->prevFree;
+		range->prevFree = nullptr;
+		range->nextFree = nullptr;
+
+		if (!head)
+		{
+			secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+			if (!secondLevelBitmaps[firstLevel])
+				firstLevelBitmap &= ~(1ull << firstLevel);
+		}
+		freeSize -= range->size;
+		freeRangeCount--;
+	}
+
+	TlsfAllocator::Range* TlsfAllocator::splitRange(Range* range, vk::DeviceSize offset)
+	{
+		auto next = new Range{ offset, range->offset + range->size - offset };
+		next->prevPhysical = range;
+		next->nextPhysical = range->nextPhysical;
+		if (next->nextPhysical)
+			next->nextPhysical->prevPhysical = next;
+		range->nextPhysical = next;
+		range->size = offset - range->offset;
+		return next;
+	}
+
+	void TlsfAllocator::mergeRange(Range* range, Range* next) noexcept
+	{
+		range->size += next->size;
+		range->nextPhysical = next->nextPhysical;
+		if (range->nextPhysical)
+			range->nextPhysical->prevPhysical = range;
+		delete next;
+	}
+
+	std::optional<uint32_t> findMemoryTypeIndex(const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+		uint32_t memoryTypeBits, vk::MemoryPropertyFlags requiredFlags, vk::MemoryPropertyFlags preferredFlags)
+	{
+		std::optional<uint32_t> bestIndex;
+		int bestScore = -1;
+		for (uint32_t index = 0; index < memoryProperties.memoryTypeCount; index++)
+		{
+			auto flags = memoryProperties.memoryTypes[index].propertyFlags;
+			if (!(memoryTypeBits & (1u << index)) || (flags & requiredFlags) != requiredFlags)
+				continue;
+
+			// preferred flags count most, flags nobody asked for are a small penalty
+			auto preferred = static_cast<uint32_t>(flags & preferredFlags);
+			auto unwanted = static_cast<uint32_t>(flags & ~(requiredFlags | preferredFlags));
+			int score = std::popcount(preferred) * 16 - std::popcount(unwanted);
+			if (score > bestScore)
+			{
+				bestScore = score;
+				bestIndex = index;
+			}
+		}
+		return bestIndex;
+	}
+
+	MemoryAllocator::MemoryAllocator(const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+		vk::DeviceSize bufferImageGranularity, MemoryCallbacks callbacks, vk::DeviceSize blockSize)
+		:memoryProperties{ memoryProperties },
+		bufferImageGranularity{ std::max<vk::DeviceSize>(bufferImageGranularity, 1) },
+		callbacks{ std::move(callbacks) }
+	{
+		for (uint32_t index = 0; index < memoryProperties.memoryTypeCount; index++)
+		{
+			// small heaps get smaller blocks so a single block can not exhaust them
+			auto heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[index].heapIndex].size;
+			blockSizes[index] = std::min(blockSize, std::bit_floor(std::max<vk::DeviceSize>(heapSize / 8, 1)));
+		}
+	}
+
+	MemoryAllocator::~MemoryAllocator() noexcept
+	{
+		for (auto& typeBlocks : blocks)
+		{
+			for (auto& block : typeBlocks)
+			{
+				destroyBlock(*block);
+			}
+		}
+	}
+
+	MemoryAllocation MemoryAllocator::allocate(const vk::MemoryRequirements& requirements, const AllocationCreateInfo& createInfo)
+	{
+		auto memoryTypeIndex = getMemoryTypeIndex(requirements.memoryTypeBits, createInfo.usage);
+
+		if (createInfo.dedicated || requirements.size > blockSizes[memoryTypeIndex] / 2)
+			return allocateDedicated(requirements, createInfo, memoryTypeIndex);
+
+		// without a granularity requirement linear and optimal resources may share blocks
+		auto tiling = bufferImageGranularity > 1 ? createInfo.tiling : ResourceTiling::eLinear;
+
+		std::unique_lock lock{ mutex };
+
+		auto tryAllocate = [&](MemoryBlock& block) -> MemoryAllocation
+			{
+				auto range = block.allocator.allocate(requirements.size, requirements.alignment);
+				if (!range)
+					return {};
+
+				MemoryAllocation allocation;
+				allocation.memory = block.memory;
+				allocation.offset = range.offset;
+				allocation.size = requirements.size;
+				allocation.memoryTypeIndex = memoryTypeIndex;
+				allocation.mappedData = block.mappedData ? static_cast<std::byte*>(block.mappedData) + range.offset : nullptr;
+				allocation.block = &block;
+				allocation.range = range;
+				return allocation;
+			};
+
+		for (auto& block : blocks[memoryTypeIndex])
+		{
+			if (block->tiling != tiling)
+				continue;
+			if (auto allocation = tryAllocate(*block))
+				return allocation;
+		}
+
+		auto allocation = tryAllocate(createBlock(memoryTypeIndex, tiling));
+		if (!allocation)
+			throw std::runtime_error("Failed to sub allocate device memory");
+		return allocation;
+	}
+
+	void MemoryAllocator::free(const MemoryAllocation& allocation)
+	{
+		if (!allocation)
+			return;
+
+		std::unique_lock lock{ mutex };
+
+		if (!allocation.block)
+		{
+			callbacks.free(allocation.memory);
+			dedicatedAllocationCount--;
+			dedicatedBytes -= allocation.size;
+			return;
+		}
+
+		auto& block = *static_cast<MemoryBlock*>(allocation.block);
+		block.allocator.free(allocation.range);
+
+		// keep one empty block per memory type around to avoid allocation churn
+		if (block.allocator.empty())
+		{
+			auto& typeBlocks = blocks[block.memoryTypeIndex];
+			auto emptyCount = std::ranges::count_if(typeBlocks,
+				[](const auto& typeBlock) { return typeBlock->allocator.empty(); });
+			if (emptyCount > 1)
+			{
+				destroyBlock(block);
+				std::erase_if(typeBlocks, [&](const auto& typeBlock) { return typeBlock.get() == &block; });
+			}
+		}
+	}
+
+	uint32_t MemoryAllocator::getMemoryTypeIndex(uint32_t memoryTypeBits, MemoryUsage usage) const
+	{
+		vk::MemoryPropertyFlags requiredFlags;
+		vk::MemoryPropertyFlags preferredFlags;
+		switch (usage)
+		{
+		case MemoryUsage::eGpuOnly:
+			preferredFlags = vk::MemoryPropertyFlagBits::eDeviceLocal;
+			break;
+		case MemoryUsage::eCpuToGpu:
+			requiredFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+			break;
+		case MemoryUsage::eGpuToCpu:
+			requiredFlags = vk::MemoryPropertyFlagBits::eHostVisible;
+			preferredFlags = vk::MemoryPropertyFlagBits::eHostCached;
+			break;
+		}
+
+		auto index = findMemoryTypeIndex(memoryProperties, memoryTypeBits, requiredFlags, preferredFlags);
+		if (!index)
+			throw std::runtime_error("Failed to find suitable memory type");
+		return *index;
+	}
+
+	MemoryStatistics MemoryAllocator::getStatistics() const
+	{
+		std::unique_lock lock{ mutex };
+
+		MemoryStatistics statistics;
+		vk::DeviceSize largestFreeBytes = 0;
+		for (const auto& typeBlocks : blocks)
+		{
+			for (const auto& block : typeBlocks)
+			{
+				const auto& allocator = block->allocator;
+				statistics.blockCount++;
+				statistics.allocationCount += allocator.getAllocationCount();
+				statistics.blockBytes += allocator.getSize();
+				statistics.allocatedBytes += allocator.getSize() - allocator.getFreeSize();
+				statistics.freeBytes += allocator.getFreeSize();
+				statistics.largestFreeRange = std::max(statistics.largestFreeRange, allocator.getLargestFreeSize());
+				largestFreeBytes += allocator.getLargestFreeSize();
+			}
+		}
+		statistics.dedicatedAllocationCount = dedicatedAllocationCount;
+		statistics.dedicatedBytes = dedicatedBytes;
+		if (statistics.freeBytes)
+		{
+			statistics.fragmentation = 1.0f -
+				static_cast<float>(largestFreeBytes) / static_cast<float>(statistics.freeBytes);
+		}
+		return statistics;
+	}
+
+	bool MemoryAllocator::isHostVisible(uint32_t memoryTypeIndex) const noexcept
+	{
+		return bool(memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible);
+	}
+
+	MemoryAllocation MemoryAllocator::allocateDedicated(const vk::MemoryRequirements& requirements,
+		const AllocationCreateInfo& createInfo, uint32_t memoryTypeIndex)
+	{
+		vk::MemoryDedicatedAllocateInfo dedicatedInfo{ createInfo.dedicatedImage, createInfo.dedicatedBuffer };
+		vk::MemoryAllocateInfo allocateInfo{ requirements.size, memoryTypeIndex };
+		if (createInfo.dedicatedImage || createInfo.dedicatedBuffer)
+			allocateInfo.setPNext(&dedicatedInfo);
+
+		MemoryAllocation allocation;
+		allocation.memory = callbacks.allocate(allocateInfo);
+		allocation.size = requirements.size;
+		allocation.memoryTypeIndex = memoryTypeIndex;
+		if (isHostVisible(memoryTypeIndex) && callbacks.map)
+			allocation.mappedData = callbacks.map(allocation.memory);
+
+		std::unique_lock lock{ mutex };
+		dedicatedAllocationCount++;
+		dedicatedBytes += requirements.size;
+		return allocation;
+	}
+
+	MemoryAllocator::MemoryBlock& MemoryAllocator::createBlock(uint32_t memoryTypeIndex, ResourceTiling tiling)
+	{
+		auto blockSize = blockSizes[memoryTypeIndex];
+		auto memory = callbacks.allocate(vk::MemoryAllocateInfo{ blockSize, memoryTypeIndex });
+
+		auto block = std::make_unique<MemoryBlock>(memory, memoryTypeIndex, tiling, blockSize);
+		if (isHostVisible(memoryTypeIndex) && callbacks.map)
+			block->mappedData = callbacks.map(memory);
+
+		blocks[memoryTypeIndex].push_back(std::move(block));
+		return *blocks[memoryTypeIndex].back();
+	}
+
+	void MemoryAllocator::destroyBlock(MemoryBlock& block) noexcept
+	{
+		callbacks.free(block.memory);
+	}
+
+}// namespace vkr
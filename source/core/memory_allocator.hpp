@@ -0,0 +1,187 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace vkr
+{
+	// two level segregated fit allocator over the range [0, size), it only does the
+	// bookkeeping, so it can be used for any kind of sub allocated range
+	class TlsfAllocator
+	{
+	public:
+		struct Range;
+
+		struct Allocation
+		{
+			vk::DeviceSize offset = 0;
+			vk::DeviceSize size = 0;
+			Range* range = nullptr;
+
+			inline explicit operator bool() const noexcept { return range != nullptr; }
+		};
+
+		explicit TlsfAllocator(vk::DeviceSize size);
+		~TlsfAllocator() noexcept;
+
+		TlsfAllocator(const TlsfAllocator&) = delete;
+		TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+		// returns an empty allocation if no free range is large enough
+		Allocation allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+		// every allocation is freed at most once
+		void free(const Allocation& allocation);
+
+		inline vk::DeviceSize getSize() const noexcept { return size; }
+		inline vk::DeviceSize getFreeSize() const noexcept { return freeSize; }
+		inline uint32_t getAllocationCount() const noexcept { return allocationCount; }
+		inline uint32_t getFreeRangeCount() const noexcept { return freeRangeCount; }
+		inline bool empty() const noexcept { return allocationCount == 0; }
+		vk::DeviceSize getLargestFreeSize() const noexcept;
+
+	private:
+		static constexpr uint32_t SecondLevelBits = 4;
+		static constexpr uint32_t SecondLevelCount = 1u << SecondLevelBits;
+		static constexpr uint32_t SmallSizeBits = 8;
+		static constexpr uint32_t FirstLevelCount = 64 - SmallSizeBits + 1;
+		static constexpr vk::DeviceSize MinRangeSize = 16;
+
+		vk::DeviceSize size;
+		vk::DeviceSize freeSize = 0;
+		uint32_t allocationCount = 0;
+		uint32_t freeRangeCount = 0;
+		Range* firstRange = nullptr;
+
+		uint64_t firstLevelBitmap = 0;
+		std::array<uint32_t, FirstLevelCount> secondLevelBitmaps{};
+		std::array<std::array<Range*, SecondLevelCount>, FirstLevelCount> freeLists{};
+
+		static std::pair<uint32_t, uint32_t> mapping(vk::DeviceSize size) noexcept;
+		Range* findFreeRange(vk::DeviceSize size) const noexcept;
+		bool isAllocated(const Range* range) const noexcept;
+		void insertFreeRange(Range* range) noexcept;
+		void removeFreeRange(Range* range) noexcept;
+		Range* splitRange(Range* range, vk::DeviceSize offset);
+		void mergeRange(Range* range, Range* next) noexcept;
+	};
+
+	enum class MemoryUsage
+	{
+		eGpuOnly,
+		eCpuToGpu,
+		eGpuToCpu,
+	};
+
+	// buffers and linear images must not share a bufferImageGranularity page with optimal images
+	enum class ResourceTiling
+	{
+		eLinear,
+		eOptimal,
+	};
+
+	struct AllocationCreateInfo
+	{
+		MemoryUsage usage = MemoryUsage::eGpuOnly;
+		ResourceTiling tiling = ResourceTiling::eLinear;
+		bool dedicated = false;
+		vk::Buffer dedicatedBuffer;
+		vk::Image dedicatedImage;
+	};
+
+	struct MemoryAllocation
+	{
+		vk::DeviceMemory memory;
+		vk::DeviceSize offset = 0;
+		vk::DeviceSize size = 0;
+		uint32_t memoryTypeIndex = 0;
+		void* mappedData = nullptr;
+
+		void* block = nullptr;
+		TlsfAllocator::Allocation range;
+
+		inline explicit operator bool() const noexcept { return bool(memory); }
+	};
+
+	struct MemoryStatistics
+	{
+		uint32_t blockCount = 0;
+		uint32_t allocationCount = 0;
+		uint32_t dedicatedAllocationCount = 0;
+		vk::DeviceSize blockBytes = 0;
+		vk::DeviceSize allocatedBytes = 0;
+		vk::DeviceSize dedicatedBytes = 0;
+		vk::DeviceSize freeBytes = 0;
+		vk::DeviceSize largestFreeRange = 0;
+
+		// 0 when the free memory of every block is one range, approaching 1 when it is scattered
+		float fragmentation = 0.0f;
+	};
+
+	// the only places device memory is touched, so the allocator can run against fake memory
+	struct MemoryCallbacks
+	{
+		std::function<vk::DeviceMemory(const vk::MemoryAllocateInfo&)> allocate;
+		std::function<void(vk::DeviceMemory)> free;
+		std::function<void* (vk::DeviceMemory)> map;
+	};
+
+	std::optional<uint32_t> findMemoryTypeIndex(const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+		uint32_t memoryTypeBits, vk::MemoryPropertyFlags requiredFlags, vk::MemoryPropertyFlags preferredFlags);
+
+	class MemoryAllocator
+	{
+	public:
+		static constexpr vk::DeviceSize DefaultBlockSize = 64ull << 20;
+
+		MemoryAllocator(const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+			vk::DeviceSize bufferImageGranularity,
+			MemoryCallbacks callbacks,
+			vk::DeviceSize blockSize = DefaultBlockSize);
+		~MemoryAllocator() noexcept;
+
+		MemoryAllocator(const MemoryAllocator&) = delete;
+		MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+		MemoryAllocation allocate(const vk::MemoryRequirements& requirements, const AllocationCreateInfo& createInfo = {});
+		void free(const MemoryAllocation& allocation);
+
+		uint32_t getMemoryTypeIndex(uint32_t memoryTypeBits, MemoryUsage usage) const;
+		MemoryStatistics getStatistics() const;
+
+		inline const vk::PhysicalDeviceMemoryProperties& getMemoryProperties() const noexcept { return memoryProperties; }
+
+	private:
+		struct MemoryBlock
+		{
+			MemoryBlock(vk::DeviceMemory memory, uint32_t memoryTypeIndex, ResourceTiling tiling, vk::DeviceSize size)
+				:memory{ memory }, memoryTypeIndex{ memoryTypeIndex }, tiling{ tiling }, allocator{ size } {}
+
+			vk::DeviceMemory memory;
+			uint32_t memoryTypeIndex;
+			ResourceTiling tiling;
+			TlsfAllocator allocator;
+			void* mappedData = nullptr;
+		};
+
+		vk::PhysicalDeviceMemoryProperties memoryProperties;
+		vk::DeviceSize bufferImageGranularity;
+		MemoryCallbacks callbacks;
+		std::array<vk::DeviceSize, VK_MAX_MEMORY_TYPES> blockSizes{};
+		std::array<std::vector<std::unique_ptr<MemoryBlock>>, VK_MAX_MEMORY_TYPES> blocks;
+		uint32_t dedicatedAllocationCount = 0;
+		vk::DeviceSize dedicatedBytes = 0;
+		mutable std::mutex mutex;
+
+		bool isHostVisible(uint32_t memoryTypeIndex) const noexcept;
+		MemoryAllocation allocateDedicated(const vk::MemoryRequirements& requirements,
+			const AllocationCreateInfo& createInfo, uint32_t memoryTypeIndex);
+		MemoryBlock& createBlock(uint32_t memoryTypeIndex, ResourceTiling tiling);
+		void destroyBlock(MemoryBlock& block) noexcept;
+	};
+
+}// namespace vkr
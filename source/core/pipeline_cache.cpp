@@ -0,0 +1,115 @@
+#include "pipeline_cache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <format>
+
+namespace vkr
+{
+	namespace
+	{
+		std::vector<std::byte> readCacheFile(const std::filesystem::path& path)
+		{
+			std::ifstream file{ path, std::ios::binary | std::ios::ate };
+			if (!file.is_open())
+				return {};
+
+			auto fileSize = file.tellg();
+			std::vector<std::byte> data(static_cast<size_t>(fileSize));
+			file.seekg(0, std::ios::beg);
+			file.read(reinterpret_cast<char*>(data.data()), fileSize);
+			return data;
+		}
+	}
+
+	PipelineCacheStore::PipelineCacheStore(const Device& device, std::filesystem::path path)
+		:device{ &device },
+		path{ std::move(path) },
+		initialData{ readCacheFile(this->path) },
+		pipelineCache{ nullptr }
+	{
+		if (!initialData.empty() && !isCompatible(initialData, device.getPhysicalDevice().getProperties()))
+		{
+			std::cout << std::format("Discard pipeline cache {} created by another device\n", this->path.string());
+			initialData.clear();
+		}
+		pipelineCache = createPipelineCache();
+	}
+
+	PipelineCacheStore::~PipelineCacheStore() noexcept
+	{
+		try
+		{
+			save();
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << std::format("Failed to save pipeline cache {}: {}\n", path.string(), e.what());
+		}
+	}
+
+	const vk::raii::PipelineCache& PipelineCacheStore::getPipelineCache()
+	{
+		std::unique_lock lock{ mutex };
+
+		auto iter = threadPipelineCaches.find(std::this_thread::get_id());
+		if (iter == threadPipelineCaches.end())
+			iter = threadPipelineCaches.emplace(std::this_thread::get_id(), createPipelineCache()).first;
+		return iter->second;
+	}
+
+	void PipelineCacheStore::save()
+	{
+		std::unique_lock lock{ mutex };
+
+		if (!threadPipelineCaches.empty())
+		{
+			std::vector<vk::PipelineCache> srcCaches;
+			for (const auto& [threadId, threadPipelineCache] : threadPipelineCaches)
+			{
+				srcCaches.push_back(*threadPipelineCache);
+			}
+			pipelineCache.merge(srcCaches);
+		}
+
+		auto data = pipelineCache.getData();
+
+		// a crash while writing must not leave a truncated cache behind
+		auto tempPath = path;
+		tempPath += ".tmp";
+		{
+			std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+			if (!file.is_open())
+				throw std::runtime_error(std::format("Failed to open {}", tempPath.string()));
+			file.write(reinterpret_cast<const char*>(data.data()), data.size());
+			if (!file)
+				throw std::runtime_error(std::format("Failed to write {}", tempPath.string()));
+		}
+		std::filesystem::rename(tempPath, path);
+	}
+
+	bool PipelineCacheStore::isCompatible(std::span<const std::byte> data, const vk::PhysicalDeviceProperties& properties)
+	{
+		vk::PipelineCacheHeaderVersionOne header;
+		if (data.size() < sizeof(header))
+			return false;
+		std::memcpy(&header, data.data(), sizeof(header));
+
+		return header.headerSize >= sizeof(header)
+			&& header.headerSize <= data.size()
+			&& header.headerVersion == vk::PipelineCacheHeaderVersion::eOne
+			&& header.vendorID == properties.vendorID
+			&& header.deviceID == properties.deviceID
+			&& header.pipelineCacheUUID == properties.pipelineCacheUUID;
+	}
+
+	vk::raii::PipelineCache PipelineCacheStore::createPipelineCache() const
+	{
+		vk::PipelineCacheCreateInfo createInfo;
+		createInfo.setInitialDataSize(initialData.size());
+		createInfo.setPInitialData(initialData.data());
+		return vk::raii::PipelineCache{ *device, createInfo };
+	}
+
+}// namespace vkr
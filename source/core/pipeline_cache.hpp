@@ -0,0 +1,46 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace vkr
+{
+	// pipeline cache backed by a file, loaded when the store is created and written
+	// back when it is destroyed, every thread creating pipelines gets its own cache
+	// which are merged on save
+	class PipelineCacheStore
+	{
+	public:
+		PipelineCacheStore(const Device& device, std::filesystem::path path);
+		~PipelineCacheStore() noexcept;
+
+		PipelineCacheStore(const PipelineCacheStore&) = delete;
+		PipelineCacheStore& operator=(const PipelineCacheStore&) = delete;
+
+		// cache of the calling thread
+		const vk::raii::PipelineCache& getPipelineCache();
+
+		// merges every thread's cache and replaces the file atomically
+		void save();
+
+		// false if there was no file or it was written by another device or driver
+		inline bool isLoaded() const noexcept { return !initialData.empty(); }
+
+		static bool isCompatible(std::span<const std::byte> data, const vk::PhysicalDeviceProperties& properties);
+
+	private:
+		const Device* device;
+		std::filesystem::path path;
+		std::vector<std::byte> initialData;
+		vk::raii::PipelineCache pipelineCache;
+		std::map<std::thread::id, vk::raii::PipelineCache> threadPipelineCaches;
+		std::mutex mutex;
+
+		vk::raii::PipelineCache createPipelineCache() const;
+	};
+
+}// namespace vkr
@@ -0,0 +1,128 @@
+#include "pipeline_compiler.hpp"
+
+#include <array>
+#include <unordered_map>
+
+namespace vkr
+{
+	namespace
+	{
+		// keeps the specialization infos alive while the create info points at them
+		struct ShaderStages
+		{
+			explicit ShaderStages(std::span<const ShaderStageDescription> descriptions)
+			{
+				specializationInfos.reserve(descriptions.size());
+				for (const auto& description : descriptions)
+				{
+					const auto& specializationInfo = specializationInfos.emplace_back(
+						static_cast<uint32_t>(description.specializationEntries.size()), description.specializationEntries.data(),
+						description.specializationData.size(), description.specializationData.data());
+					createInfos.emplace_back(vk::PipelineShaderStageCreateFlags{}, description.stage, description.module,
+						description.entryPoint.c_str(), description.specializationEntries.empty() ? nullptr : &specializationInfo);
+				}
+			}
+
+			std::vector<vk::SpecializationInfo> specializationInfos;
+			std::vector<vk::PipelineShaderStageCreateInfo> createInfos;
+		};
+	}
+
+	PipelineCompiler::PipelineCompiler(const Device& device, PipelineCacheStore* pipelineCacheStore)
+		:device{ &device },
+		pipelineCacheStore{ pipelineCacheStore } {}
+
+	vk::raii::Pipeline PipelineCompiler::createPipeline(const PipelineDescription& description) const
+	{
+		if (auto compute = std::get_if<ComputePipelineDescription>(&description))
+			return createComputePipeline(*compute);
+		return createGraphicsPipeline(std::get<GraphicsPipelineDescription>(description));
+	}
+
+	void PipelineCompiler::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures13.setDynamicRendering(true);
+	}
+
+	PipelineCompiler::PipelineList PipelineCompiler::Batch::resolve() const
+	{
+		PipelineList result;
+		result.reserve(uniqueIndices.size());
+		for (auto uniqueIndex : uniqueIndices)
+		{
+			result.push_back(pipelines[uniqueIndex]);
+		}
+		return result;
+	}
+
+	PipelineCompiler::Batch PipelineCompiler::deduplicate(std::vector<PipelineDescription> descriptions)
+	{
+		Batch batch;
+		batch.uniqueIndices.reserve(descriptions.size());
+
+		std::unordered_map<PipelineHash, uint32_t> uniqueByHash;
+		for (auto& description : descriptions)
+		{
+			auto [iter, inserted] = uniqueByHash.try_emplace(hashPipelineDescription(description),
+				static_cast<uint32_t>(batch.uniqueDescriptions.size()));
+			if (inserted)
+				batch.uniqueDescriptions.push_back(std::move(description));
+			batch.uniqueIndices.push_back(iter->second);
+		}
+
+		batch.pipelines.resize(batch.uniqueDescriptions.size());
+		return batch;
+	}
+
+	vk::raii::Pipeline PipelineCompiler::createComputePipeline(const ComputePipelineDescription& description) const
+	{
+		ShaderStages stages{ std::span{ &description.stage, 1 } };
+		vk::ComputePipelineCreateInfo createInfo{ {}, stages.createInfos.front(), description.layout };
+
+		if (pipelineCacheStore)
+			return vk::raii::Pipeline{ *device, pipelineCacheStore->getPipelineCache(), createInfo };
+		return vk::raii::Pipeline{ *device, nullptr, createInfo };
+	}
+
+	vk::raii::Pipeline PipelineCompiler::createGraphicsPipeline(const GraphicsPipelineDescription& description) const
+	{
+		ShaderStages stages{ description.stages };
+
+		vk::PipelineVertexInputStateCreateInfo vertexInputState{ {},
+			description.vertexBindings, description.vertexAttributes };
+		vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState{ {}, description.topology };
+		vk::PipelineViewportStateCreateInfo viewportState{ {}, 1, nullptr, 1, nullptr };
+
+		vk::PipelineRasterizationStateCreateInfo rasterizationState;
+		rasterizationState.setPolygonMode(description.polygonMode);
+		rasterizationState.setCullMode(description.cullMode);
+		rasterizationState.setFrontFace(description.frontFace);
+		rasterizationState.setLineWidth(1.0f);
+
+		vk::PipelineMultisampleStateCreateInfo multisampleState{ {}, description.samples };
+
+		vk::PipelineDepthStencilStateCreateInfo depthStencilState;
+		depthStencilState.setDepthTestEnable(description.depthTest);
+		depthStencilState.setDepthWriteEnable(description.depthWrite);
+		depthStencilState.setDepthCompareOp(description.depthCompareOp);
+
+		vk::PipelineColorBlendStateCreateInfo colorBlendState{ {}, false, vk::LogicOp::eCopy,
+			description.blendAttachments };
+
+		std::array dynamicStates{ vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+		vk::PipelineDynamicStateCreateInfo dynamicState{ {}, dynamicStates };
+
+		vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::PipelineRenderingCreateInfo> createInfo{
+			vk::GraphicsPipelineCreateInfo{ {}, stages.createInfos, &vertexInputState, &inputAssemblyState,
+				nullptr, &viewportState, &rasterizationState, &multisampleState, &depthStencilState,
+				&colorBlendState, &dynamicState, description.layout },
+			vk::PipelineRenderingCreateInfo{ 0, description.colorFormats,
+				description.depthFormat, description.stencilFormat } };
+
+		const auto& graphicsCreateInfo = createInfo.get<vk::GraphicsPipelineCreateInfo>();
+		if (pipelineCacheStore)
+			return vk::raii::Pipeline{ *device, pipelineCacheStore->getPipelineCache(), graphicsCreateInfo };
+		return vk::raii::Pipeline{ *device, nullptr, graphicsCreateInfo };
+	}
+
+}// namespace vkr
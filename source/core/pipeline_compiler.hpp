@@ -0,0 +1,74 @@
+#pragma once
+
+#include "pipeline_description.hpp"
+#include "pipeline_cache.hpp"
+
+#include <exec/execution.hpp>
+#include <exec/scheduler.hpp>
+
+#include <memory>
+
+namespace vkr
+{
+	// creates batches of pipelines concurrently through bulk on an exec scheduler, on a
+	// thread_run_loop every loop thread compiles, other schedulers fall back to serial bulk
+	class PipelineCompiler
+	{
+	public:
+		using PipelineList = std::vector<std::shared_ptr<const vk::raii::Pipeline>>;
+
+		// with a cache store every compiling thread uses its own pipeline cache
+		explicit PipelineCompiler(const Device& device, PipelineCacheStore* pipelineCacheStore = nullptr);
+
+		PipelineCompiler(const PipelineCompiler&) = delete;
+		PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+		// completes with one pipeline per description in input order, identical
+		// descriptions are compiled once and share their pipeline
+		template<exec::scheduler Sch>
+		inline auto compile(Sch&& scheduler, std::vector<PipelineDescription> descriptions)
+		{
+			auto batch = std::make_shared<Batch>(deduplicate(std::move(descriptions)));
+			auto uniqueCount = static_cast<uint32_t>(batch->uniqueDescriptions.size());
+			return exec::schedule(std::forward<Sch>(scheduler)) |
+				exec::bulk(uniqueCount, [this, batch](uint32_t index)
+					{
+						batch->pipelines[index] = std::make_shared<const vk::raii::Pipeline>(
+							createPipeline(batch->uniqueDescriptions[index]));
+						compiledCount.fetch_add(1, std::memory_order_relaxed);
+					}) |
+				exec::then([batch]
+					{
+						return batch->resolve();
+					});
+		}
+
+		vk::raii::Pipeline createPipeline(const PipelineDescription& description) const;
+
+		// number of pipelines actually created, duplicates are not counted
+		inline uint64_t getCompiledCount() const noexcept { return compiledCount.load(std::memory_order_relaxed); }
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		struct Batch
+		{
+			std::vector<PipelineDescription> uniqueDescriptions;
+			// index into uniqueDescriptions for every requested description
+			std::vector<uint32_t> uniqueIndices;
+			PipelineList pipelines;
+
+			PipelineList resolve() const;
+		};
+
+		const Device* device;
+		PipelineCacheStore* pipelineCacheStore;
+		std::atomic<uint64_t> compiledCount = 0;
+
+		static Batch deduplicate(std::vector<PipelineDescription> descriptions);
+
+		vk::raii::Pipeline createComputePipeline(const ComputePipelineDescription& description) const;
+		vk::raii::Pipeline createGraphicsPipeline(const GraphicsPipelineDescription& description) const;
+	};
+
+}// namespace vkr
@@ -0,0 +1,226 @@
+#include "pipeline_description.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace vkr
+{
+	namespace
+	{
+		// MurmurHash3 x64 128
+		PipelineHash murmurHash3(std::span<const std::byte> data, uint64_t seed = 0)
+		{
+			constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+			constexpr uint64_t c2 = 0x4cf5ad432745937full;
+
+			auto fmix = [](uint64_t k)
+				{
+					k ^= k >> 33;
+					k *= 0xff51afd7ed558ccdull;
+					k ^= k >> 33;
+					k *= 0xc4ceb9fe1a85ec53ull;
+					k ^= k >> 33;
+					return k;
+				};
+
+			uint64_t h1 = seed;
+			uint64_t h2 = seed;
+
+			size_t blockCount = data.size() / 16;
+			for (size_t i = 0; i < blockCount; i++)
+			{
+				uint64_t k1, k2;
+				std::memcpy(&k1, data.data() + i * 16, 8);
+				std::memcpy(&k2, data.data() + i * 16 + 8, 8);
+
+				k1 *= c1; k1 = std::rotl(k1, 31); k1 *= c2; h1 ^= k1;
+				h1 = std::rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+				k2 *= c2; k2 = std::rotl(k2, 33); k2 *= c1; h2 ^= k2;
+				h2 = std::rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+			}
+
+			auto tail = data.subspan(blockCount * 16);
+			uint64_t k1 = 0, k2 = 0;
+			for (size_t i = tail.size(); i > 8; i--)
+			{
+				k2 ^= static_cast<uint64_t>(tail[i - 1]) << ((i - 9) * 8);
+			}
+			for (size_t i = std::min<size_t>(tail.size(), 8); i > 0; i--)
+			{
+				k1 ^= static_cast<uint64_t>(tail[i - 1]) << ((i - 1) * 8);
+			}
+			if (tail.size() > 8)
+			{
+				k2 *= c2; k2 = std::rotl(k2, 33); k2 *= c1; h2 ^= k2;
+			}
+			if (!tail.empty())
+			{
+				k1 *= c1; k1 = std::rotl(k1, 31); k1 *= c2; h1 ^= k1;
+			}
+
+			h1 ^= data.size(); h2 ^= data.size();
+			h1 += h2; h2 += h1;
+			h1 = fmix(h1); h2 = fmix(h2);
+			h1 += h2; h2 += h1;
+			return { h1, h2 };
+		}
+
+		// serializes the states that affect the pipeline into a byte stream with fixed widths
+		class CanonicalWriter
+		{
+		public:
+			template<typename T>
+				requires std::is_integral_v<T> || std::is_enum_v<T>
+			void write(T value)
+			{
+				auto widened = static_cast<uint64_t>(value);
+				auto begin = reinterpret_cast<const std::byte*>(&widened);
+				bytes.insert(bytes.end(), begin, begin + sizeof(widened));
+			}
+
+			template<typename BitType>
+			void write(vk::Flags<BitType> flags)
+			{
+				write(static_cast<typename vk::Flags<BitType>::MaskType>(flags));
+			}
+
+			template<typename T>
+				requires vk::isVulkanHandleType<T>::value
+			void write(T handle)
+			{
+				write(reinterpret_cast<uint64_t>(static_cast<typename T::CType>(handle)));
+			}
+
+			void write(const PipelineHash& hash)
+			{
+				write(hash.low);
+				write(hash.high);
+			}
+
+			void write(std::span<const std::byte> data)
+			{
+				write(data.size());
+				bytes.insert(bytes.end(), data.begin(), data.end());
+			}
+
+			void write(const ShaderStageDescription& stage)
+			{
+				write(stage.stage);
+				if (stage.codeHash)
+					write(stage.codeHash);
+				else
+					write(stage.module);
+				write(std::as_bytes(std::span{ stage.entryPoint }));
+
+				// constants are identified by id, where they live in the data does not matter
+				auto entries = stage.specializationEntries;
+				std::ranges::sort(entries, {}, &vk::SpecializationMapEntry::constantID);
+				write(entries.size());
+				for (const auto& entry : entries)
+				{
+					write(entry.constantID);
+					write(std::span{ stage.specializationData }.subspan(entry.offset, entry.size));
+				}
+			}
+
+			inline PipelineHash hash() const { return murmurHash3(bytes); }
+
+		private:
+			std::vector<std::byte> bytes;
+		};
+	}
+
+	PipelineHash hashShaderCode(std::span<const uint32_t> code)
+	{
+		return murmurHash3(std::as_bytes(code));
+	}
+
+	PipelineHash hashPipelineDescription(const PipelineDescription& description)
+	{
+		CanonicalWriter writer;
+		writer.write(description.index());
+
+		if (auto compute = std::get_if<ComputePipelineDescription>(&description))
+		{
+			writer.write(compute->stage);
+			writer.write(compute->layout);
+			return writer.hash();
+		}
+
+		const auto& graphics = std::get<GraphicsPipelineDescription>(description);
+
+		std::vector<const ShaderStageDescription*> stages;
+		for (const auto& stage : graphics.stages)
+		{
+			stages.push_back(&stage);
+		}
+		std::ranges::sort(stages, {}, [](const ShaderStageDescription* stage) { return stage->stage; });
+		writer.write(stages.size());
+		for (auto stage : stages)
+		{
+			writer.write(*stage);
+		}
+
+		auto bindings = graphics.vertexBindings;
+		std::ranges::sort(bindings, {}, &vk::VertexInputBindingDescription::binding);
+		writer.write(bindings.size());
+		for (const auto& binding : bindings)
+		{
+			writer.write(binding.binding);
+			writer.write(binding.stride);
+			writer.write(binding.inputRate);
+		}
+
+		auto attributes = graphics.vertexAttributes;
+		std::ranges::sort(attributes, {}, &vk::VertexInputAttributeDescription::location);
+		writer.write(attributes.size());
+		for (const auto& attribute : attributes)
+		{
+			writer.write(attribute.location);
+			writer.write(attribute.binding);
+			writer.write(attribute.format);
+			writer.write(attribute.offset);
+		}
+
+		writer.write(graphics.topology);
+		writer.write(graphics.polygonMode);
+		writer.write(graphics.cullMode);
+		writer.write(graphics.frontFace);
+		writer.write(graphics.samples);
+
+		writer.write(graphics.depthTest);
+		if (graphics.depthTest)
+		{
+			writer.write(graphics.depthWrite);
+			writer.write(graphics.depthCompareOp);
+		}
+
+		writer.write(graphics.blendAttachments.size());
+		for (const auto& blend : graphics.blendAttachments)
+		{
+			writer.write(blend.blendEnable);
+			if (blend.blendEnable)
+			{
+				writer.write(blend.srcColorBlendFactor);
+				writer.write(blend.dstColorBlendFactor);
+				writer.write(blend.colorBlendOp);
+				writer.write(blend.srcAlphaBlendFactor);
+				writer.write(blend.dstAlphaBlendFactor);
+				writer.write(blend.alphaBlendOp);
+			}
+			writer.write(blend.colorWriteMask);
+		}
+
+		writer.write(graphics.colorFormats.size());
+		for (auto format : graphics.colorFormats)
+		{
+			writer.write(format);
+		}
+		writer.write(graphics.depthFormat);
+		writer.write(graphics.stencilFormat);
+		writer.write(graphics.layout);
+		return writer.hash();
+	}
+
+}// namespace vkr
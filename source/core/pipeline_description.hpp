@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <variant>
+#include <string>
+#include <span>
+#include <compare>
+
+namespace vkr
+{
+	struct PipelineHash
+	{
+		uint64_t low = 0;
+		uint64_t high = 0;
+
+		inline explicit operator bool() const noexcept { return low != 0 || high != 0; }
+		auto operator<=>(const PipelineHash&) const = default;
+	};
+
+	struct ShaderStageDescription
+	{
+		vk::ShaderStageFlagBits stage = vk::ShaderStageFlagBits::eCompute;
+		vk::ShaderModule module;
+		// hash of the SPIR-V code, when set it identifies the module instead of the handle
+		// so the same code loaded into two modules still maps to one pipeline
+		PipelineHash codeHash;
+		std::string entryPoint = "main";
+		std::vector<vk::SpecializationMapEntry> specializationEntries;
+		std::vector<std::byte> specializationData;
+
+		bool operator==(const ShaderStageDescription&) const = default;
+	};
+
+	struct ComputePipelineDescription
+	{
+		ShaderStageDescription stage;
+		vk::PipelineLayout layout;
+
+		bool operator==(const ComputePipelineDescription&) const = default;
+	};
+
+	// graphics pipeline for dynamic rendering, viewport and scissor are always dynamic
+	struct GraphicsPipelineDescription
+	{
+		std::vector<ShaderStageDescription> stages;
+		std::vector<vk::VertexInputBindingDescription> vertexBindings;
+		std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
+		vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+		vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
+		vk::CullModeFlags cullMode = vk::CullModeFlagBits::eBack;
+		vk::FrontFace frontFace = vk::FrontFace::eCounterClockwise;
+		vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+		bool depthTest = true;
+		bool depthWrite = true;
+		vk::CompareOp depthCompareOp = vk::CompareOp::eLess;
+		// one per color format
+		std::vector<vk::PipelineColorBlendAttachmentState> blendAttachments;
+		std::vector<vk::Format> colorFormats;
+		vk::Format depthFormat = vk::Format::eUndefined;
+		vk::Format stencilFormat = vk::Format::eUndefined;
+		vk::PipelineLayout layout;
+
+		bool operator==(const GraphicsPipelineDescription&) const = default;
+	};
+
+	using PipelineDescription = std::variant<ComputePipelineDescription, GraphicsPipelineDescription>;
+
+	PipelineHash hashShaderCode(std::span<const uint32_t> code);
+
+	// 128-bit hash of the canonical form of the description, states the driver ignores
+	// (blend factors with blending off, depth write without depth test) are left out and
+	// stages, vertex inputs and specialization constants are hashed in sorted order
+	PipelineHash hashPipelineDescription(const PipelineDescription& description);
+
+}// namespace vkr
+
+template<>
+struct std::hash<vkr::PipelineHash>
+{
+	inline size_t operator()(const vkr::PipelineHash& hash) const noexcept
+	{
+		return static_cast<size_t>(hash.low);
+	}
+};
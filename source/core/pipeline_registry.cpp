@@ -0,0 +1,133 @@
+#include "pipeline_registry.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace vkr
+{
+	PipelineRegistry::PipelineRegistry(PipelineFactory factory, size_t initialCapacity)
+		:factory{ std::move(factory) }
+	{
+		auto& initialTable = tables.emplace_back(std::make_unique<Table>(std::bit_ceil(std::max<size_t>(initialCapacity, 16))));
+		table.store(initialTable.get(), std::memory_order_relaxed);
+	}
+
+	PipelineRegistry::PipelineRegistry(const Device& device, PipelineCacheStore* pipelineCacheStore)
+		:PipelineRegistry{ [compiler = std::make_shared<PipelineCompiler>(device, pipelineCacheStore)](const PipelineDescription& description)
+			{
+				return compiler->createPipeline(description);
+			} } {}
+
+	const vk::raii::Pipeline& PipelineRegistry::getPipeline(const PipelineDescription& description)
+	{
+		return getPipeline(hashPipelineDescription(description), description);
+	}
+
+	const vk::raii::Pipeline& PipelineRegistry::getPipeline(const PipelineHash& hash, const PipelineDescription& description)
+	{
+		Entry* entry = findEntry(*table.load(std::memory_order_acquire), hash);
+		if (entry && entry->state.load(std::memory_order_acquire) == EntryState::eReady)
+			return entry->pipeline;
+
+		if (!entry)
+		{
+			std::unique_lock lock{ mutex };
+			entry = findEntry(*table.load(std::memory_order_relaxed), hash);
+			if (!entry)
+			{
+				entry = &entries.emplace_back(hash);
+				insertEntry(entry);
+				lock.unlock();
+				return createPipeline(*entry, description);
+			}
+		}
+
+		while (true)
+		{
+			auto state = entry->state.load(std::memory_order_acquire);
+			if (state == EntryState::eReady)
+				return entry->pipeline;
+
+			if (state == EntryState::eCreating)
+			{
+				entry->state.wait(state, std::memory_order_acquire);
+				continue;
+			}
+
+			// the previous creation threw, the first thread getting here tries again
+			if (entry->state.compare_exchange_strong(state, EntryState::eCreating, std::memory_order_acquire))
+				return createPipeline(*entry, description);
+		}
+	}
+
+	const vk::raii::Pipeline* PipelineRegistry::findPipeline(const PipelineHash& hash) const noexcept
+	{
+		Entry* entry = findEntry(*table.load(std::memory_order_acquire), hash);
+		if (entry && entry->state.load(std::memory_order_acquire) == EntryState::eReady)
+			return &entry->pipeline;
+		return nullptr;
+	}
+
+	PipelineRegistry::Entry* PipelineRegistry::findEntry(const Table& table, const PipelineHash& hash) noexcept
+	{
+		size_t mask = table.slots.size() - 1;
+		for (size_t index = hash.low & mask;; index = (index + 1) & mask)
+		{
+			Entry* entry = table.slots[index].load(std::memory_order_acquire);
+			if (!entry || entry->hash == hash)
+				return entry;
+		}
+	}
+
+	void PipelineRegistry::placeEntry(Table& table, Entry* entry) noexcept
+	{
+		size_t mask = table.slots.size() - 1;
+		size_t index = entry->hash.low & mask;
+		while (table.slots[index].load(std::memory_order_relaxed))
+		{
+			index = (index + 1) & mask;
+		}
+		table.slots[index].store(entry, std::memory_order_release);
+	}
+
+	void PipelineRegistry::insertEntry(Entry* entry)
+	{
+		Table* current = table.load(std::memory_order_relaxed);
+		size_t count = entryCount.load(std::memory_order_relaxed) + 1;
+
+		if (count * 2 > current->slots.size())
+		{
+			auto& grown = tables.emplace_back(std::make_unique<Table>(current->slots.size() * 2));
+			for (const auto& slot : current->slots)
+			{
+				if (Entry* existing = slot.load(std::memory_order_relaxed))
+					placeEntry(*grown, existing);
+			}
+			table.store(grown.get(), std::memory_order_release);
+			current = grown.get();
+		}
+
+		placeEntry(*current, entry);
+		entryCount.store(count, std::memory_order_relaxed);
+	}
+
+	const vk::raii::Pipeline& PipelineRegistry::createPipeline(Entry& entry, const PipelineDescription& description)
+	{
+		try
+		{
+			entry.pipeline = factory(description);
+		}
+		catch (...)
+		{
+			entry.state.store(EntryState::eFailed, std::memory_order_release);
+			entry.state.notify_all();
+			throw;
+		}
+
+		createdCount.fetch_add(1, std::memory_order_relaxed);
+		entry.state.store(EntryState::eReady, std::memory_order_release);
+		entry.state.notify_all();
+		return entry.pipeline;
+	}
+
+}// namespace vkr
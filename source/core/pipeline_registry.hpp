@@ -0,0 +1,75 @@
+#pragma once
+
+#include "pipeline_compiler.hpp"
+
+#include <functional>
+#include <deque>
+
+namespace vkr
+{
+	// owns one pipeline per canonical description hash, lookups of existing pipelines
+	// never lock, a missing pipeline is created by the first thread asking for it while
+	// other threads asking for the same hash wait for that creation
+	class PipelineRegistry
+	{
+	public:
+		using PipelineFactory = std::function<vk::raii::Pipeline(const PipelineDescription&)>;
+
+		explicit PipelineRegistry(PipelineFactory factory, size_t initialCapacity = 1024);
+		explicit PipelineRegistry(const Device& device, PipelineCacheStore* pipelineCacheStore = nullptr);
+
+		PipelineRegistry(const PipelineRegistry&) = delete;
+		PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+		const vk::raii::Pipeline& getPipeline(const PipelineDescription& description);
+		// for callers that keep the hash of a description around
+		const vk::raii::Pipeline& getPipeline(const PipelineHash& hash, const PipelineDescription& description);
+
+		// nullptr if the pipeline was never requested or is still being created
+		const vk::raii::Pipeline* findPipeline(const PipelineHash& hash) const noexcept;
+
+		inline size_t size() const noexcept { return entryCount.load(std::memory_order_relaxed); }
+		inline uint64_t getCreatedCount() const noexcept { return createdCount.load(std::memory_order_relaxed); }
+
+	private:
+		enum class EntryState : uint32_t
+		{
+			eCreating,
+			eReady,
+			eFailed
+		};
+
+		struct Entry
+		{
+			explicit Entry(const PipelineHash& hash) : hash{ hash } {}
+
+			const PipelineHash hash;
+			std::atomic<EntryState> state = EntryState::eCreating;
+			vk::raii::Pipeline pipeline{ nullptr };
+		};
+
+		// open addressing with linear probing, kept at most half full so probes stay short
+		struct Table
+		{
+			explicit Table(size_t capacity) : slots(capacity) {}
+
+			std::vector<std::atomic<Entry*>> slots;
+		};
+
+		PipelineFactory factory;
+
+		std::atomic<Table*> table;
+		// replaced tables stay alive, readers may still be probing them
+		std::vector<std::unique_ptr<Table>> tables;
+		std::deque<Entry> entries;
+		std::atomic<size_t> entryCount = 0;
+		std::atomic<uint64_t> createdCount = 0;
+		std::mutex mutex;
+
+		static Entry* findEntry(const Table& table, const PipelineHash& hash) noexcept;
+		static void placeEntry(Table& table, Entry* entry) noexcept;
+		void insertEntry(Entry* entry);
+		const vk::raii::Pipeline& createPipeline(Entry& entry, const PipelineDescription& description);
+	};
+
+}// namespace vkr
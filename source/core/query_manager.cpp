@@ -0,0 +1,179 @@
+#include "query_manager.hpp"
+
+#include <algorithm>
+
+namespace vkr
+{
+	QueryManager::QueryManager(const Device& device, const QueryManagerCreateInfo& createInfo)
+		:occlusionQueryCount{ std::max(createInfo.occlusionQueryCount, 1u) },
+		statisticsQueryCount{ device.getEnabledFeatures().pipelineStatisticsQuery ? std::max(createInfo.statisticsQueryCount, 1u) : 0 },
+		preciseOcclusion{ device.getEnabledFeatures().occlusionQueryPrecise == VK_TRUE },
+		pipelineStatistics{ createInfo.pipelineStatistics }
+	{
+		if (!pipelineStatistics || (pipelineStatistics & ~AllPipelineStatistics))
+			throw std::runtime_error("Pipeline statistics queries need at least one of the core statistics and no others");
+
+		vk::QueryPoolCreateInfo occlusionCreateInfo{ {}, vk::QueryType::eOcclusion, occlusionQueryCount };
+		vk::QueryPoolCreateInfo statisticsCreateInfo{ {}, vk::QueryType::ePipelineStatistics, statisticsQueryCount,
+			pipelineStatistics };
+		for (uint32_t index = 0; index < std::max(createInfo.framesInFlight, 1u); index++)
+		{
+			auto& frameQueries = frames.emplace_back(new FrameQueries{
+				QuerySlots{ vk::raii::QueryPool{ device, occlusionCreateInfo } },
+				QuerySlots{ hasPipelineStatistics() ? vk::raii::QueryPool{ device, statisticsCreateInfo } : vk::raii::QueryPool{ nullptr } } });
+			frameQueries->keys.resize(occlusionQueryCount);
+			frameQueries->names.resize(statisticsQueryCount);
+
+			// new queries are undefined until their first reset
+			frameQueries->occlusion.resetCount = occlusionQueryCount;
+			frameQueries->statistics.resetCount = statisticsQueryCount;
+		}
+	}
+
+	void QueryManager::beginFrame()
+	{
+		frameIndex = (frameIndex + 1) % static_cast<uint32_t>(frames.size());
+		frameNumber++;
+
+		occlusionResults.clear();
+		passStatistics.clear();
+		auto& frameQueries = *frames[frameIndex];
+		resolveFrame(frameQueries);
+		frameQueries.frame = frameNumber;
+	}
+
+	void QueryManager::recordResets(const vk::raii::CommandBuffer& commandBuffer)
+	{
+		auto& frameQueries = *frames[frameIndex];
+		for (auto* slots : { &frameQueries.occlusion, &frameQueries.statistics })
+		{
+			if (slots->resetCount == 0)
+				continue;
+
+			commandBuffer.resetQueryPool(*slots->queryPool, 0, slots->resetCount);
+			slots->resetCount = 0;
+		}
+	}
+
+	uint32_t QueryManager::beginOcclusionQuery(const vk::raii::CommandBuffer& commandBuffer, uint64_t key, bool precise)
+	{
+		auto& frameQueries = *frames[frameIndex];
+		uint32_t query = allocate(frameQueries.occlusion, occlusionQueryCount);
+		if (query == UINT32_MAX)
+			return query;
+
+		frameQueries.keys[query] = key;
+		commandBuffer.beginQuery(*frameQueries.occlusion.queryPool, query,
+			precise && preciseOcclusion ? vk::QueryControlFlagBits::ePrecise : vk::QueryControlFlags{});
+		return query;
+	}
+
+	void QueryManager::endOcclusionQuery(const vk::raii::CommandBuffer& commandBuffer, uint32_t query)
+	{
+		if (query == UINT32_MAX)
+			return;
+
+		commandBuffer.endQuery(*frames[frameIndex]->occlusion.queryPool, query);
+	}
+
+	uint32_t QueryManager::beginStatisticsQuery(const vk::raii::CommandBuffer& commandBuffer, std::string_view name)
+	{
+		if (!hasPipelineStatistics())
+			return UINT32_MAX;
+
+		auto& frameQueries = *frames[frameIndex];
+		uint32_t query = allocate(frameQueries.statistics, statisticsQueryCount);
+		if (query == UINT32_MAX)
+			return query;
+
+		frameQueries.names[query] = name;
+		commandBuffer.beginQuery(*frameQueries.statistics.queryPool, query, {});
+		return query;
+	}
+
+	void QueryManager::endStatisticsQuery(const vk::raii::CommandBuffer& commandBuffer, uint32_t query)
+	{
+		if (query == UINT32_MAX)
+			return;
+
+		commandBuffer.endQuery(*frames[frameIndex]->statistics.queryPool, query);
+	}
+
+	void QueryManager::resolve()
+	{
+		occlusionResults.clear();
+		passStatistics.clear();
+		for (auto& frameQueries : frames)
+		{
+			resolveFrame(*frameQueries);
+		}
+	}
+
+	void QueryManager::setDeviceCreateInfo(DeviceCreateInfo& createInfo, const vk::raii::PhysicalDevice& physicalDevice)
+	{
+		auto features = physicalDevice.getFeatures();
+		if (features.occlusionQueryPrecise)
+			createInfo.enabledFeatures.setOcclusionQueryPrecise(true);
+		if (features.pipelineStatisticsQuery)
+			createInfo.enabledFeatures.setPipelineStatisticsQuery(true);
+	}
+
+	uint32_t QueryManager::allocate(QuerySlots& slots, uint32_t capacity)
+	{
+		uint32_t query = slots.usedCount.fetch_add(1, std::memory_order_relaxed);
+		if (query < capacity)
+			return query;
+
+		droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return UINT32_MAX;
+	}
+
+	void QueryManager::resolveFrame(FrameQueries& frameQueries)
+	{
+		// value and availability per query, queries never submitted stay unavailable and are skipped
+		uint32_t occlusionCount = std::min(frameQueries.occlusion.usedCount.load(std::memory_order_relaxed), occlusionQueryCount);
+		if (occlusionCount > 0)
+		{
+			auto values = frameQueries.occlusion.queryPool.getResults<uint64_t>(0, occlusionCount,
+				occlusionCount * 2 * sizeof(uint64_t), 2 * sizeof(uint64_t),
+				vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability).second;
+
+			for (uint32_t query = 0; query < occlusionCount; query++)
+			{
+				if (values[2 * query + 1])
+					occlusionResults.push_back(OcclusionResult{ frameQueries.keys[query], frameQueries.frame, values[2 * query] });
+			}
+		}
+
+		uint32_t statisticsCount = std::min(frameQueries.statistics.usedCount.load(std::memory_order_relaxed), statisticsQueryCount);
+		if (statisticsCount > 0)
+		{
+			// one value per enabled statistic in bit order, then the availability
+			uint32_t stride = std::popcount(static_cast<uint32_t>(pipelineStatistics)) + 1;
+			auto values = frameQueries.statistics.queryPool.getResults<uint64_t>(0, statisticsCount,
+				statisticsCount * stride * sizeof(uint64_t), stride * sizeof(uint64_t),
+				vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability).second;
+
+			for (uint32_t query = 0; query < statisticsCount; query++)
+			{
+				const uint64_t* counts = &values[query * stride];
+				if (!counts[stride - 1])
+					continue;
+
+				auto& result = passStatistics.emplace_back(PassStatistics{ std::move(frameQueries.names[query]), frameQueries.frame });
+				auto statistics = static_cast<uint32_t>(pipelineStatistics);
+				for (uint32_t bit = 0; statistics; bit++, statistics >>= 1)
+				{
+					if (statistics & 1)
+						result.statistics.counts[bit] = *counts++;
+				}
+			}
+		}
+
+		frameQueries.occlusion.resetCount = std::max(frameQueries.occlusion.resetCount, occlusionCount);
+		frameQueries.occlusion.usedCount.store(0, std::memory_order_relaxed);
+		frameQueries.statistics.resetCount = std::max(frameQueries.statistics.resetCount, statisticsCount);
+		frameQueries.statistics.usedCount.store(0, std::memory_order_relaxed);
+	}
+
+}// namespace vkr
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <atomic>
+#include <array>
+#include <bit>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace vkr
+{
+	constexpr vk::QueryPipelineStatisticFlags AllPipelineStatistics =
+		vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices
+		| vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives
+		| vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations
+		| vk::QueryPipelineStatisticFlagBits::eGeometryShaderInvocations
+		| vk::QueryPipelineStatisticFlagBits::eGeometryShaderPrimitives
+		| vk::QueryPipelineStatisticFlagBits::eClippingInvocations
+		| vk::QueryPipelineStatisticFlagBits::eClippingPrimitives
+		| vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations
+		| vk::QueryPipelineStatisticFlagBits::eTessellationControlShaderPatches
+		| vk::QueryPipelineStatisticFlagBits::eTessellationEvaluationShaderInvocations
+		| vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+	// counters of one pipeline statistics query, statistics that were not queried stay 0
+	struct PipelineStatistics
+	{
+		// indexed by the bit position of the VkQueryPipelineStatisticFlagBits
+		std::array<uint64_t, 11> counts = {};
+
+		inline uint64_t get(vk::QueryPipelineStatisticFlagBits statistic) const noexcept
+		{
+			return counts[std::countr_zero(static_cast<uint32_t>(statistic))];
+		}
+	};
+
+	struct PassStatistics
+	{
+		std::string name;
+		uint64_t frame = 0;
+		PipelineStatistics statistics;
+	};
+
+	struct OcclusionResult
+	{
+		// caller chosen, e.g. the object the query tested
+		uint64_t key = 0;
+		uint64_t frame = 0;
+		uint64_t samples = 0;
+	};
+
+	struct QueryManagerCreateInfo
+	{
+		uint32_t framesInFlight = 2;
+		uint32_t occlusionQueryCount = 4096;
+		uint32_t statisticsQueryCount = 256;
+		vk::QueryPipelineStatisticFlags pipelineStatistics = AllPipelineStatistics;
+	};
+
+	// occlusion and pipeline statistics queries from pools per frame in flight; a frame's
+	// results are read when its slot comes around again, by then the frame retired and the
+	// read never waits, and every query it used is reset by one vkCmdResetQueryPool per pool;
+	// without the pipelineStatisticsQuery feature statistics queries are skipped, without
+	// occlusionQueryPrecise occlusion queries are never precise
+	class QueryManager
+	{
+	public:
+		explicit QueryManager(const Device& device, const QueryManagerCreateInfo& createInfo = {});
+
+		QueryManager(const QueryManager&) = delete;
+		QueryManager& operator=(const QueryManager&) = delete;
+
+		// moves to the next frame slot and replaces the results with the ones it held, the
+		// frame that last used the slot must have retired, as after CommandPoolManager::beginFrame
+		void beginFrame();
+
+		// resets the queries of the current slot, has to be recorded outside a render pass
+		// and submitted before the frame's first query on the same queue
+		void recordResets(const vk::raii::CommandBuffer& commandBuffer);
+
+		// safe from several recording threads; return UINT32_MAX once the frame is out of queries
+		// and for statistics queries without the feature
+		uint32_t beginOcclusionQuery(const vk::raii::CommandBuffer& commandBuffer, uint64_t key, bool precise = false);
+		void endOcclusionQuery(const vk::raii::CommandBuffer& commandBuffer, uint32_t query);
+		uint32_t beginStatisticsQuery(const vk::raii::CommandBuffer& commandBuffer, std::string_view name);
+		void endStatisticsQuery(const vk::raii::CommandBuffer& commandBuffer, uint32_t query);
+
+		// resolves every frame slot, only once the queue is idle
+		void resolve();
+
+		// results of the frames resolved last, queries that were never submitted are left out
+		inline const std::vector<OcclusionResult>& getOcclusionResults() const noexcept { return occlusionResults; }
+		inline const std::vector<PassStatistics>& getPassStatistics() const noexcept { return passStatistics; }
+		// queries that did not fit into their frame
+		inline uint64_t getDroppedCount() const noexcept { return droppedCount.load(std::memory_order_relaxed); }
+		inline bool hasPipelineStatistics() const noexcept { return statisticsQueryCount > 0; }
+
+		// enables the optional query features the physical device supports
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo, const vk::raii::PhysicalDevice& physicalDevice);
+
+	private:
+		struct QuerySlots
+		{
+			vk::raii::QueryPool queryPool;
+			std::atomic<uint32_t> usedCount = 0;
+			// queries vkCmdResetQueryPool has to cover before the slot is used again
+			uint32_t resetCount = 0;
+		};
+
+		struct FrameQueries
+		{
+			QuerySlots occlusion;
+			QuerySlots statistics;
+			std::vector<uint64_t> keys;
+			std::vector<std::string> names;
+			uint64_t frame = 0;
+		};
+
+		uint32_t occlusionQueryCount;
+		// 0 without the pipelineStatisticsQuery feature
+		uint32_t statisticsQueryCount;
+		bool preciseOcclusion;
+		vk::QueryPipelineStatisticFlags pipelineStatistics;
+
+		std::vector<std::unique_ptr<FrameQueries>> frames;
+		uint32_t frameIndex = 0;
+		uint64_t frameNumber = 0;
+		std::vector<OcclusionResult> occlusionResults;
+		std::vector<PassStatistics> passStatistics;
+		std::atomic<uint64_t> droppedCount = 0;
+
+		uint32_t allocate(QuerySlots& slots, uint32_t capacity);
+		void resolveFrame(FrameQueries& frameQueries);
+	};
+
+}// namespace vkr
@@ -89,6 +89,10 @@ namespace vkr
 		return createInfos;
 	}
 
+	Queue::Queue(const vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t queueIndex)
+		:vk::raii::Queue{ device, queueFamilyIndex, queueIndex },
+		queueFamilyIndex{ queueFamilyIndex } {}
+
 	QueueFamilies::QueueFamilies(const vk::raii::Device& device, std::span<const vk::DeviceQueueCreateInfo> queueCreateInfos)
 	{
 		for (const auto& queueFamilyInfo : queueCreateInfos)
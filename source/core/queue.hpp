@@ -39,7 +39,12 @@ namespace vkr
 	class Queue : public vk::raii::Queue
 	{
 	public:
-		using vk::raii::Queue::Queue;
+		Queue(const vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t queueIndex);
+
+		inline uint32_t getQueueFamilyIndex() const noexcept { return queueFamilyIndex; }
+
+	private:
+		uint32_t queueFamilyIndex;
 	};
 
 	class QueueFamily : public std::vector<Queue>
@@ -0,0 +1,720 @@
+#include "render_graph.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace vkr
+{
+	namespace
+	{
+		constexpr vk::AccessFlags2 WriteAccess = vk::AccessFlagBits2::eShaderWrite
+			| vk::AccessFlagBits2::eShaderStorageWrite
+			| vk::AccessFlagBits2::eColorAttachmentWrite
+			| vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+			| vk::AccessFlagBits2::eTransferWrite
+			| vk::AccessFlagBits2::eHostWrite
+			| vk::AccessFlagBits2::eMemoryWrite;
+
+		vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		QueueMask getQueueBit(PassQueue queue)
+		{
+			return 1u << static_cast<uint32_t>(queue);
+		}
+
+		bool overlaps(const TransientPlacement& lhs, const TransientPlacement& rhs)
+		{
+			return lhs.firstBatch <= rhs.lastBatch && rhs.firstBatch <= lhs.lastBatch;
+		}
+
+		bool sharesMemory(const TransientPlacement& lhs, const TransientPlacement& rhs)
+		{
+			return lhs.heap == rhs.heap && lhs.offset < rhs.offset + rhs.size && rhs.offset < lhs.offset + lhs.size;
+		}
+
+		vk::ImageCreateInfo getImageCreateInfo(const ImageDescription& description)
+		{
+			return vk::ImageCreateInfo{ {}, description.imageType, description.format, description.extent,
+				description.mipLevels, description.arrayLayers, description.samples, vk::ImageTiling::eOptimal,
+				description.usage };
+		}
+
+		vk::BufferCreateInfo getBufferCreateInfo(const BufferDescription& description)
+		{
+			return vk::BufferCreateInfo{ {}, description.size, description.usage, vk::SharingMode::eExclusive };
+		}
+
+		// synchronization state of one resource between batches
+		struct ResourceState
+		{
+			vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+			// the last write or layout transition, and the reads since
+			vk::PipelineStageFlags2 writeStages;
+			vk::AccessFlags2 writeAccess;
+			vk::PipelineStageFlags2 readStages;
+			// stages and accesses the last write was already made visible to
+			vk::PipelineStageFlags2 visibleStages;
+			vk::AccessFlags2 visibleAccess;
+			PassQueue queue = PassQueue::eGraphics;
+			bool used = false;
+		};
+
+		bool transition(ResourceState& state, bool isImage, const ResourceUsage& usage, bool write, PassQueue queue,
+			ResourceBarrier& barrier)
+		{
+			vk::ImageLayout newLayout = isImage ? usage.layout : vk::ImageLayout::eUndefined;
+			bool layoutChange = newLayout != state.layout;
+			bool queueChange = queue != state.queue;
+
+			barrier.queue = queue;
+			barrier.dstStages = usage.stages;
+			barrier.dstAccess = usage.access;
+			barrier.oldLayout = state.layout;
+			barrier.newLayout = newLayout;
+			state.queue = queue;
+
+			if (write || layoutChange || queueChange)
+			{
+				bool needed = true;
+				if (queueChange)
+				{
+					// the other queue's work is ordered by the semaphore wait in front of this
+					// submission, or by submission order if both queues are the same one
+					barrier.srcStages = vk::PipelineStageFlagBits2::eAllCommands;
+					barrier.srcAccess = state.writeAccess;
+				}
+				else
+				{
+					// write after read only needs the execution dependency
+					barrier.srcStages = state.writeStages | state.readStages;
+					barrier.srcAccess = state.writeAccess;
+					needed = layoutChange || bool(barrier.srcStages);
+				}
+
+				state.layout = newLayout;
+				state.writeStages = usage.stages;
+				state.writeAccess = write ? usage.access & WriteAccess : vk::AccessFlags2{};
+				state.readStages = write ? vk::PipelineStageFlags2{} : usage.stages;
+				state.visibleStages = usage.stages;
+				state.visibleAccess = usage.access;
+				return needed;
+			}
+
+			// reads in the same layout only wait if the last write is not visible to them yet
+			bool needed = state.writeStages
+				&& ((usage.stages & ~state.visibleStages) || (usage.access & ~state.visibleAccess));
+			if (needed)
+			{
+				barrier.srcStages = state.writeStages;
+				barrier.srcAccess = state.writeAccess;
+				state.visibleStages |= usage.stages;
+				state.visibleAccess |= usage.access;
+			}
+			state.readStages |= usage.stages;
+			return needed;
+		}
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(ResourceHandle resource, const ResourceUsage& usage)
+	{
+		graph->addAccess(pass, resource, usage, false);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(ResourceHandle resource, const ResourceUsage& usage)
+	{
+		graph->addAccess(pass, resource, usage, true);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::setSideEffect()
+	{
+		graph->passes[pass].sideEffect = true;
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::setAsyncCompute()
+	{
+		graph->passes[pass].queue = PassQueue::eAsyncCompute;
+		return *this;
+	}
+
+	ResourceHandle RenderGraph::createImage(std::string name, const ImageDescription& description)
+	{
+		RenderGraphResource resource;
+		resource.name = std::move(name);
+		resource.type = ResourceType::eImage;
+		resource.image = description;
+		resources.push_back(std::move(resource));
+		return { static_cast<uint32_t>(resources.size() - 1) };
+	}
+
+	ResourceHandle RenderGraph::createBuffer(std::string name, const BufferDescription& description)
+	{
+		RenderGraphResource resource;
+		resource.name = std::move(name);
+		resource.type = ResourceType::eBuffer;
+		resource.buffer = description;
+		resources.push_back(std::move(resource));
+		return { static_cast<uint32_t>(resources.size() - 1) };
+	}
+
+	ResourceHandle RenderGraph::importImage(std::string name, vk::Image image, const ImageDescription& description,
+		const ResourceUsage& initialUsage, const ResourceUsage& finalUsage)
+	{
+		auto handle = createImage(std::move(name), description);
+		auto& resource = resources[handle.index];
+		resource.imported = true;
+		resource.importedImage = image;
+		resource.initialUsage = initialUsage;
+		resource.finalUsage = finalUsage;
+		return handle;
+	}
+
+	ResourceHandle RenderGraph::importBuffer(std::string name, vk::Buffer buffer, const BufferDescription& description,
+		const ResourceUsage& initialUsage, const ResourceUsage& finalUsage)
+	{
+		auto handle = createBuffer(std::move(name), description);
+		auto& resource = resources[handle.index];
+		resource.imported = true;
+		resource.importedBuffer = buffer;
+		resource.initialUsage = initialUsage;
+		resource.finalUsage = finalUsage;
+		return handle;
+	}
+
+	RenderGraph::PassBuilder RenderGraph::addPass(std::string name, RenderGraphExecute execute)
+	{
+		passes.push_back(RenderGraphPass{ std::move(name), std::move(execute) });
+		return PassBuilder{ *this, static_cast<uint32_t>(passes.size() - 1) };
+	}
+
+	void RenderGraph::addAccess(uint32_t pass, ResourceHandle resource, const ResourceUsage& usage, bool write)
+	{
+		if (resource.index >= resources.size())
+			throw std::runtime_error(std::format("Pass {} accesses an unknown resource", passes[pass].name));
+
+		auto& accesses = passes[pass].accesses;
+		auto iter = std::ranges::find(accesses, resource, &RenderGraphAccess::resource);
+		if (iter == accesses.end())
+		{
+			accesses.push_back(RenderGraphAccess{ resource, usage, !write, write });
+			return;
+		}
+
+		if (resources[resource.index].type == ResourceType::eImage && iter->usage.layout != usage.layout)
+			throw std::runtime_error(std::format("Pass {} uses image {} in two layouts",
+				passes[pass].name, resources[resource.index].name));
+
+		iter->usage.stages |= usage.stages;
+		iter->usage.access |= usage.access;
+		iter->read |= !write;
+		iter->write |= write;
+	}
+
+	void RenderGraph::compile(const MemoryRequirementsQuery& query)
+	{
+		batches.clear();
+		finalBarriers.clear();
+		heaps.clear();
+		placements.assign(resources.size(), {});
+		statistics = {};
+
+		cullPasses();
+		buildBatches();
+		placeTransientResources(query);
+		buildBarriers();
+
+		statistics.passCount = static_cast<uint32_t>(passes.size());
+		statistics.culledPassCount = static_cast<uint32_t>(std::ranges::count(passes, true, &RenderGraphPass::culled));
+		statistics.batchCount = static_cast<uint32_t>(batches.size());
+		for (const auto& batch : batches)
+		{
+			statistics.barrierBatchCount += !batch.barriers.empty();
+			statistics.barrierCount += static_cast<uint32_t>(batch.barriers.size());
+		}
+		statistics.barrierBatchCount += !finalBarriers.empty();
+		statistics.barrierCount += static_cast<uint32_t>(finalBarriers.size());
+		for (const auto& heap : heaps)
+		{
+			statistics.aliasedBytes += heap.size;
+		}
+	}
+
+	void RenderGraph::compile(const Device& device)
+	{
+		compile([&device](const RenderGraphResource& resource)
+			{
+				if (resource.type == ResourceType::eImage)
+				{
+					auto createInfo = getImageCreateInfo(resource.image);
+					return device.getImageMemoryRequirements(vk::DeviceImageMemoryRequirements{ &createInfo }).memoryRequirements;
+				}
+
+				auto createInfo = getBufferCreateInfo(resource.buffer);
+				return device.getBufferMemoryRequirements(vk::DeviceBufferMemoryRequirements{ &createInfo }).memoryRequirements;
+			});
+	}
+
+	void RenderGraph::cullPasses()
+	{
+		// a pass is needed if it has side effects, writes an imported resource or
+		// produces data a needed pass reads
+		std::vector<uint32_t> lastProducers(resources.size(), UINT32_MAX);
+		std::vector<std::vector<uint32_t>> producers(passes.size());
+		std::vector<uint32_t> neededPasses;
+
+		for (uint32_t pass = 0; pass < passes.size(); pass++)
+		{
+			passes[pass].queueWaits.clear();
+			bool needed = passes[pass].sideEffect;
+			for (const auto& access : passes[pass].accesses)
+			{
+				auto& lastProducer = lastProducers[access.resource.index];
+				if (access.read && lastProducer != UINT32_MAX)
+					producers[pass].push_back(lastProducer);
+				if (access.write)
+				{
+					lastProducer = pass;
+					needed |= resources[access.resource.index].imported;
+				}
+			}
+
+			passes[pass].culled = true;
+			if (needed)
+				neededPasses.push_back(pass);
+		}
+
+		while (!neededPasses.empty())
+		{
+			uint32_t pass = neededPasses.back();
+			neededPasses.pop_back();
+			if (!passes[pass].culled)
+				continue;
+
+			passes[pass].culled = false;
+			neededPasses.insert(neededPasses.end(), producers[pass].begin(), producers[pass].end());
+		}
+	}
+
+	void RenderGraph::buildBatches()
+	{
+		// passes only depend on earlier ones, so one walk in declaration order gives
+		// every pass its longest distance from a pass without dependencies
+		struct Ordering
+		{
+			uint32_t lastWriter = UINT32_MAX;
+			std::vector<uint32_t> readers;
+			vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+			// level of the read that moved the image into its layout or onto its queue,
+			// later reads there may share the level but must not run before it
+			uint32_t layoutLevel = 0;
+			PassQueue queue = PassQueue::eGraphics;
+		};
+
+		std::vector<Ordering> orderings(resources.size());
+		for (uint32_t index = 0; index < resources.size(); index++)
+		{
+			if (resources[index].imported)
+				orderings[index].layout = resources[index].initialUsage.layout;
+		}
+
+		// moving to another layout or queue has to be ordered like a write
+		auto isExclusive = [&](const RenderGraphAccess& access, PassQueue queue)
+			{
+				const auto& ordering = orderings[access.resource.index];
+				return access.write
+					|| queue != ordering.queue
+					|| (resources[access.resource.index].type == ResourceType::eImage && access.usage.layout != ordering.layout);
+			};
+
+		std::vector<uint32_t> levels(passes.size(), 0);
+		uint32_t levelCount = 0;
+		for (uint32_t pass = 0; pass < passes.size(); pass++)
+		{
+			if (passes[pass].culled)
+				continue;
+
+			auto queue = passes[pass].queue;
+			auto& queueWaits = passes[pass].queueWaits;
+			uint32_t level = 0;
+			auto after = [&](uint32_t predecessor)
+				{
+					level = std::max(level, levels[predecessor] + 1);
+					if (passes[predecessor].queue != queue && std::ranges::find(queueWaits, predecessor) == queueWaits.end())
+						queueWaits.push_back(predecessor);
+				};
+
+			for (const auto& access : passes[pass].accesses)
+			{
+				const auto& ordering = orderings[access.resource.index];
+				if (ordering.lastWriter != UINT32_MAX)
+					after(ordering.lastWriter);
+
+				// exclusive accesses wait for every earlier read
+				if (isExclusive(access, queue))
+					std::ranges::for_each(ordering.readers, after);
+				else
+					level = std::max(level, ordering.layoutLevel);
+			}
+
+			for (const auto& access : passes[pass].accesses)
+			{
+				auto& ordering = orderings[access.resource.index];
+				if (access.write)
+				{
+					ordering.lastWriter = pass;
+					ordering.readers.clear();
+				}
+				else
+				{
+					if (isExclusive(access, queue))
+					{
+						ordering.readers.clear();
+						ordering.layoutLevel = level;
+					}
+					ordering.readers.push_back(pass);
+				}
+
+				if (resources[access.resource.index].type == ResourceType::eImage)
+					ordering.layout = access.usage.layout;
+				ordering.queue = queue;
+			}
+
+			levels[pass] = level;
+			levelCount = std::max(levelCount, level + 1);
+		}
+
+		batches.resize(levelCount);
+		for (uint32_t pass = 0; pass < passes.size(); pass++)
+		{
+			if (!passes[pass].culled)
+				batches[levels[pass]].passes.push_back(pass);
+		}
+	}
+
+	void RenderGraph::placeTransientResources(const MemoryRequirementsQuery& query)
+	{
+		std::vector<uint32_t> transientResources;
+		for (uint32_t batch = 0; batch < batches.size(); batch++)
+		{
+			for (uint32_t pass : batches[batch].passes)
+			{
+				for (const auto& access : passes[pass].accesses)
+				{
+					if (resources[access.resource.index].imported)
+						continue;
+
+					auto& placement = placements[access.resource.index];
+					if (placement.firstBatch == UINT32_MAX)
+						transientResources.push_back(access.resource.index);
+					placement.firstBatch = std::min(placement.firstBatch, batch);
+					placement.lastBatch = std::max(placement.lastBatch, batch);
+					placement.queues |= getQueueBit(passes[pass].queue);
+				}
+			}
+		}
+
+		std::vector<vk::MemoryRequirements> requirements(resources.size());
+		for (uint32_t resource : transientResources)
+		{
+			requirements[resource] = query(resources[resource]);
+		}
+
+		// largest first, each resource takes the lowest offset not used by a resource alive at the same time
+		std::ranges::sort(transientResources, [&](uint32_t lhs, uint32_t rhs)
+			{
+				return std::pair{ requirements[rhs].size, lhs } < std::pair{ requirements[lhs].size, rhs };
+			});
+
+		std::vector<std::vector<uint32_t>> heapResources;
+		std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> usedRanges;
+		for (uint32_t resource : transientResources)
+		{
+			const auto& requirement = requirements[resource];
+			auto& placement = placements[resource];
+			auto tiling = resources[resource].type == ResourceType::eImage ? ResourceTiling::eOptimal : ResourceTiling::eLinear;
+
+			auto heapIter = std::ranges::find_if(heaps, [&](const TransientHeap& heap)
+				{
+					return heap.memoryTypeBits == requirement.memoryTypeBits && heap.tiling == tiling
+						&& heap.queues == placement.queues;
+				});
+			uint32_t heapIndex = static_cast<uint32_t>(heapIter - heaps.begin());
+			if (heapIter == heaps.end())
+			{
+				heaps.push_back(TransientHeap{ requirement.memoryTypeBits, tiling, placement.queues });
+				heapResources.emplace_back();
+			}
+
+			// resources used by both queues have no order to alias in
+			bool shared = placement.queues == AllQueues;
+			usedRanges.clear();
+			for (uint32_t other : heapResources[heapIndex])
+			{
+				if (shared || overlaps(placement, placements[other]))
+					usedRanges.emplace_back(placements[other].offset, placements[other].offset + placements[other].size);
+			}
+			std::ranges::sort(usedRanges);
+
+			vk::DeviceSize alignment = std::max<vk::DeviceSize>(requirement.alignment, 1);
+			vk::DeviceSize offset = 0;
+			for (auto [begin, end] : usedRanges)
+			{
+				if (offset + requirement.size <= begin)
+					break;
+				offset = std::max(offset, alignUp(end, alignment));
+			}
+
+			placement.heap = heapIndex;
+			placement.offset = offset;
+			placement.size = requirement.size;
+			heapResources[heapIndex].push_back(resource);
+
+			auto& heap = heaps[heapIndex];
+			heap.size = std::max(heap.size, offset + requirement.size);
+			heap.alignment = std::max(heap.alignment, alignment);
+
+			statistics.transientResourceCount++;
+			statistics.transientBytes += requirement.size;
+		}
+	}
+
+	void RenderGraph::buildBarriers()
+	{
+		std::vector<ResourceState> states(resources.size());
+		std::vector<std::vector<uint32_t>> heapResources(heaps.size());
+		for (uint32_t index = 0; index < resources.size(); index++)
+		{
+			const auto& resource = resources[index];
+			if (placements[index])
+				heapResources[placements[index].heap].push_back(index);
+			if (!resource.imported)
+				continue;
+
+			auto& state = states[index];
+			state.used = true;
+			state.layout = resource.type == ResourceType::eImage ? resource.initialUsage.layout : vk::ImageLayout::eUndefined;
+			if (resource.initialUsage.access & WriteAccess)
+			{
+				state.writeStages = resource.initialUsage.stages;
+				state.writeAccess = resource.initialUsage.access & WriteAccess;
+			}
+			else
+			{
+				state.readStages = resource.initialUsage.stages;
+			}
+		}
+
+		std::vector<uint32_t> accessSlots(resources.size(), UINT32_MAX);
+		std::vector<RenderGraphAccess> batchAccesses;
+		std::vector<PassQueue> batchQueues;
+		for (uint32_t batchIndex = 0; batchIndex < batches.size(); batchIndex++)
+		{
+			auto& batch = batches[batchIndex];
+
+			// passes of a batch never conflict, so their accesses merge into one per resource
+			batchAccesses.clear();
+			batchQueues.clear();
+			for (uint32_t pass : batch.passes)
+			{
+				for (const auto& access : passes[pass].accesses)
+				{
+					auto& slot = accessSlots[access.resource.index];
+					if (slot == UINT32_MAX)
+					{
+						slot = static_cast<uint32_t>(batchAccesses.size());
+						batchAccesses.push_back(access);
+						batchQueues.push_back(passes[pass].queue);
+						continue;
+					}
+
+					auto& merged = batchAccesses[slot];
+					merged.usage.stages |= access.usage.stages;
+					merged.usage.access |= access.usage.access;
+					merged.read |= access.read;
+					merged.write |= access.write;
+				}
+			}
+
+			for (uint32_t slot = 0; slot < batchAccesses.size(); slot++)
+			{
+				const auto& access = batchAccesses[slot];
+				uint32_t index = access.resource.index;
+				accessSlots[index] = UINT32_MAX;
+
+				auto& state = states[index];
+				if (!state.used)
+				{
+					// memory taken over from resources that died earlier, wait for their last use
+					for (uint32_t other : heapResources[placements[index].heap])
+					{
+						if (placements[other].lastBatch < batchIndex && sharesMemory(placements[index], placements[other]))
+						{
+							state.writeStages |= states[other].writeStages | states[other].readStages;
+							state.writeAccess |= states[other].writeAccess;
+						}
+					}
+					state.queue = batchQueues[slot];
+					state.used = true;
+				}
+
+				ResourceBarrier barrier{ access.resource };
+				if (transition(state, resources[index].type == ResourceType::eImage, access.usage, access.write,
+					batchQueues[slot], barrier))
+					batch.barriers.push_back(barrier);
+			}
+		}
+
+		for (uint32_t index = 0; index < resources.size(); index++)
+		{
+			const auto& resource = resources[index];
+			if (!resource.imported || (!resource.finalUsage.stages && resource.finalUsage.layout == vk::ImageLayout::eUndefined))
+				continue;
+
+			auto finalUsage = resource.finalUsage;
+			if (finalUsage.layout == vk::ImageLayout::eUndefined)
+				finalUsage.layout = states[index].layout;
+
+			ResourceBarrier barrier{ ResourceHandle{ index } };
+			if (transition(states[index], resource.type == ResourceType::eImage, finalUsage, false, PassQueue::eGraphics, barrier))
+				finalBarriers.push_back(barrier);
+		}
+	}
+
+	RenderGraphResources::RenderGraphResources(Device& device)
+		:device{ &device } {}
+
+	RenderGraphResources::~RenderGraphResources() noexcept
+	{
+		release();
+	}
+
+	void RenderGraphResources::realize(const RenderGraph& graph, std::span<const uint32_t> queueFamilyIndices)
+	{
+		release();
+
+		for (const auto& heap : graph.getTransientHeaps())
+		{
+			AllocationCreateInfo createInfo;
+			createInfo.tiling = heap.tiling;
+			heapAllocations.push_back(device->getMemoryAllocator().allocate(
+				vk::MemoryRequirements{ heap.size, heap.alignment, heap.memoryTypeBits }, createInfo));
+		}
+
+		const auto& resources = graph.getResources();
+		resourceImages.assign(resources.size(), {});
+		resourceBuffers.assign(resources.size(), {});
+		for (uint32_t index = 0; index < resources.size(); index++)
+		{
+			const auto& resource = resources[index];
+			if (resource.imported)
+			{
+				resourceImages[index] = resource.importedImage;
+				resourceBuffers[index] = resource.importedBuffer;
+				continue;
+			}
+
+			// culled away, nothing uses it
+			const auto& placement = graph.getPlacement(ResourceHandle{ index });
+			if (!placement)
+				continue;
+
+			const auto& allocation = heapAllocations[placement.heap];
+			bool concurrent = placement.queues == AllQueues && queueFamilyIndices.size() > 1;
+			if (resource.type == ResourceType::eImage)
+			{
+				auto createInfo = getImageCreateInfo(resource.image);
+				if (concurrent)
+				{
+					createInfo.sharingMode = vk::SharingMode::eConcurrent;
+					createInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
+					createInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+				}
+				auto& image = images.emplace_back(*device, createInfo);
+				image.bindMemory(allocation.memory, allocation.offset + placement.offset);
+				resourceImages[index] = *image;
+			}
+			else
+			{
+				auto createInfo = getBufferCreateInfo(resource.buffer);
+				if (concurrent)
+				{
+					createInfo.sharingMode = vk::SharingMode::eConcurrent;
+					createInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
+					createInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+				}
+				auto& buffer = buffers.emplace_back(*device, createInfo);
+				buffer.bindMemory(allocation.memory, allocation.offset + placement.offset);
+				resourceBuffers[index] = *buffer;
+			}
+		}
+	}
+
+	void RenderGraphResources::record(const RenderGraph& graph, const vk::raii::CommandBuffer& commandBuffer) const
+	{
+		const auto& passes = graph.getPasses();
+		for (const auto& batch : graph.getBatches())
+		{
+			recordBarriers(graph, commandBuffer, batch.barriers);
+			for (uint32_t pass : batch.passes)
+			{
+				if (passes[pass].execute)
+					passes[pass].execute(commandBuffer, *this);
+			}
+		}
+		recordBarriers(graph, commandBuffer, graph.getFinalBarriers());
+	}
+
+	void RenderGraphResources::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures13.setSynchronization2(true);
+		createInfo.enabledFeatures13.setMaintenance4(true);
+	}
+
+	void RenderGraphResources::release() noexcept
+	{
+		images.clear();
+		buffers.clear();
+		for (const auto& allocation : heapAllocations)
+		{
+			device->getMemoryAllocator().free(allocation);
+		}
+		heapAllocations.clear();
+	}
+
+	void RenderGraphResources::recordBarriers(const RenderGraph& graph, const vk::raii::CommandBuffer& commandBuffer,
+		std::span<const ResourceBarrier> barriers) const
+	{
+		if (barriers.empty())
+			return;
+
+		std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+		std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+		for (const auto& barrier : barriers)
+		{
+			const auto& resource = graph.getResource(barrier.resource);
+			if (resource.type == ResourceType::eImage)
+			{
+				vk::ImageSubresourceRange range{ resource.image.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+				imageBarriers.emplace_back(barrier.srcStages, barrier.srcAccess, barrier.dstStages, barrier.dstAccess,
+					barrier.oldLayout, barrier.newLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+					getImage(barrier.resource), range);
+			}
+			else
+			{
+				bufferBarriers.emplace_back(barrier.srcStages, barrier.srcAccess, barrier.dstStages, barrier.dstAccess,
+					VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, getBuffer(barrier.resource), 0, VK_WHOLE_SIZE);
+			}
+		}
+
+		vk::DependencyInfo dependencyInfo;
+		dependencyInfo.setImageMemoryBarriers(imageBarriers);
+		dependencyInfo.setBufferMemoryBarriers(bufferBarriers);
+		commandBuffer.pipelineBarrier2(dependencyInfo);
+	}
+
+}// namespace vkr
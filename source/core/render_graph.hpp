@@ -0,0 +1,264 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <functional>
+#include <string>
+
+namespace vkr
+{
+	struct ResourceHandle
+	{
+		uint32_t index = UINT32_MAX;
+
+		inline explicit operator bool() const noexcept { return index != UINT32_MAX; }
+		auto operator<=>(const ResourceHandle&) const = default;
+	};
+
+	enum class PassQueue
+	{
+		eGraphics,
+		eAsyncCompute,
+	};
+
+	enum class ResourceType
+	{
+		eImage,
+		eBuffer,
+	};
+
+	struct ImageDescription
+	{
+		vk::ImageType imageType = vk::ImageType::e2D;
+		vk::Format format = vk::Format::eUndefined;
+		vk::Extent3D extent;
+		uint32_t mipLevels = 1;
+		uint32_t arrayLayers = 1;
+		vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+		vk::ImageUsageFlags usage;
+		vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor;
+	};
+
+	struct BufferDescription
+	{
+		vk::DeviceSize size = 0;
+		vk::BufferUsageFlags usage;
+	};
+
+	// how a pass touches a resource, layout is ignored for buffers
+	struct ResourceUsage
+	{
+		vk::PipelineStageFlags2 stages;
+		vk::AccessFlags2 access;
+		vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+	};
+
+	struct RenderGraphResource
+	{
+		std::string name;
+		ResourceType type = ResourceType::eImage;
+		ImageDescription image;
+		BufferDescription buffer;
+
+		// imported resources live outside the graph and are never aliased
+		bool imported = false;
+		vk::Image importedImage;
+		vk::Buffer importedBuffer;
+		ResourceUsage initialUsage;
+		// usage after the graph, e.g. the present layout of a swapchain image
+		ResourceUsage finalUsage;
+	};
+
+	class RenderGraphResources;
+	using RenderGraphExecute = std::function<void(const vk::raii::CommandBuffer&, const RenderGraphResources&)>;
+	using MemoryRequirementsQuery = std::function<vk::MemoryRequirements(const RenderGraphResource&)>;
+
+	struct RenderGraphAccess
+	{
+		ResourceHandle resource;
+		ResourceUsage usage;
+		bool read = false;
+		bool write = false;
+	};
+
+	struct RenderGraphPass
+	{
+		std::string name;
+		RenderGraphExecute execute;
+		// one entry per resource, repeated declarations are merged
+		std::vector<RenderGraphAccess> accesses;
+		PassQueue queue = PassQueue::eGraphics;
+		bool sideEffect = false;
+		bool culled = false;
+		// passes on the other queue this one has to wait for
+		std::vector<uint32_t> queueWaits;
+	};
+
+	struct ResourceBarrier
+	{
+		ResourceHandle resource;
+		// queue of the passes the barrier is for
+		PassQueue queue = PassQueue::eGraphics;
+		vk::PipelineStageFlags2 srcStages;
+		vk::AccessFlags2 srcAccess;
+		vk::PipelineStageFlags2 dstStages;
+		vk::AccessFlags2 dstAccess;
+		vk::ImageLayout oldLayout = vk::ImageLayout::eUndefined;
+		vk::ImageLayout newLayout = vk::ImageLayout::eUndefined;
+	};
+
+	// passes of one batch do not depend on each other, all barriers they need are
+	// issued before the batch in one vkCmdPipelineBarrier2
+	struct RenderGraphBatch
+	{
+		std::vector<uint32_t> passes;
+		std::vector<ResourceBarrier> barriers;
+	};
+
+	// bit per PassQueue
+	using QueueMask = uint32_t;
+	constexpr QueueMask AllQueues = 0b11;
+
+	// one memory allocation shared by transient resources with disjoint lifetimes on the
+	// same queue, the two queues do not run in lockstep so they never share memory
+	struct TransientHeap
+	{
+		uint32_t memoryTypeBits = 0;
+		ResourceTiling tiling = ResourceTiling::eOptimal;
+		QueueMask queues = 0;
+		vk::DeviceSize size = 0;
+		vk::DeviceSize alignment = 1;
+	};
+
+	struct TransientPlacement
+	{
+		uint32_t heap = UINT32_MAX;
+		vk::DeviceSize offset = 0;
+		vk::DeviceSize size = 0;
+		// batches of the first and the last use
+		uint32_t firstBatch = UINT32_MAX;
+		uint32_t lastBatch = 0;
+		// queues using the resource, with both it needs concurrent sharing
+		QueueMask queues = 0;
+
+		inline explicit operator bool() const noexcept { return heap != UINT32_MAX; }
+	};
+
+	struct RenderGraphStatistics
+	{
+		uint32_t passCount = 0;
+		uint32_t culledPassCount = 0;
+		uint32_t batchCount = 0;
+		// vkCmdPipelineBarrier2 calls, including the one for final usages
+		uint32_t barrierBatchCount = 0;
+		uint32_t barrierCount = 0;
+		uint32_t transientResourceCount = 0;
+		// memory the transient resources would need without aliasing, and with it
+		vk::DeviceSize transientBytes = 0;
+		vk::DeviceSize aliasedBytes = 0;
+	};
+
+	// passes declare what they read and write, compile orders them by dependency,
+	// culls the ones nothing depends on, derives the barriers and places transient
+	// resources with disjoint lifetimes in shared memory; compiling touches no device
+	// objects, only the memory requirements come from the query
+	class RenderGraph
+	{
+	public:
+		class PassBuilder
+		{
+		public:
+			PassBuilder& read(ResourceHandle resource, const ResourceUsage& usage);
+			PassBuilder& write(ResourceHandle resource, const ResourceUsage& usage);
+			// the pass is kept even if nothing reads what it writes
+			PassBuilder& setSideEffect();
+			// runs on a compute queue next to the graphics work if the executor has one, imported
+			// resources the pass uses have to be shared concurrently with that queue's family
+			PassBuilder& setAsyncCompute();
+
+		private:
+			friend class RenderGraph;
+
+			PassBuilder(RenderGraph& graph, uint32_t pass)
+				:graph{ &graph }, pass{ pass } {}
+
+			RenderGraph* graph;
+			uint32_t pass;
+		};
+
+		ResourceHandle createImage(std::string name, const ImageDescription& description);
+		ResourceHandle createBuffer(std::string name, const BufferDescription& description);
+		ResourceHandle importImage(std::string name, vk::Image image, const ImageDescription& description,
+			const ResourceUsage& initialUsage, const ResourceUsage& finalUsage = {});
+		ResourceHandle importBuffer(std::string name, vk::Buffer buffer, const BufferDescription& description,
+			const ResourceUsage& initialUsage = {}, const ResourceUsage& finalUsage = {});
+
+		PassBuilder addPass(std::string name, RenderGraphExecute execute = {});
+
+		void compile(const MemoryRequirementsQuery& query);
+		// memory requirements from vkGetDevice*MemoryRequirements, no resource is created
+		void compile(const Device& device);
+
+		inline const std::vector<RenderGraphResource>& getResources() const noexcept { return resources; }
+		inline const RenderGraphResource& getResource(ResourceHandle resource) const { return resources[resource.index]; }
+		inline const std::vector<RenderGraphPass>& getPasses() const noexcept { return passes; }
+		inline const std::vector<RenderGraphBatch>& getBatches() const noexcept { return batches; }
+		inline const std::vector<ResourceBarrier>& getFinalBarriers() const noexcept { return finalBarriers; }
+		inline const std::vector<TransientHeap>& getTransientHeaps() const noexcept { return heaps; }
+		inline const TransientPlacement& getPlacement(ResourceHandle resource) const { return placements[resource.index]; }
+		inline const RenderGraphStatistics& getStatistics() const noexcept { return statistics; }
+
+	private:
+		std::vector<RenderGraphResource> resources;
+		std::vector<RenderGraphPass> passes;
+
+		std::vector<RenderGraphBatch> batches;
+		std::vector<ResourceBarrier> finalBarriers;
+		std::vector<TransientHeap> heaps;
+		std::vector<TransientPlacement> placements;
+		RenderGraphStatistics statistics;
+
+		void addAccess(uint32_t pass, ResourceHandle resource, const ResourceUsage& usage, bool write);
+		void cullPasses();
+		void buildBatches();
+		void placeTransientResources(const MemoryRequirementsQuery& query);
+		void buildBarriers();
+	};
+
+	// device objects of a compiled graph: the transient images and buffers bound into
+	// their heaps, and the recording of every pass with its barriers
+	class RenderGraphResources
+	{
+	public:
+		explicit RenderGraphResources(Device& device);
+		~RenderGraphResources() noexcept;
+
+		RenderGraphResources(const RenderGraphResources&) = delete;
+		RenderGraphResources& operator=(const RenderGraphResources&) = delete;
+
+		// replaces the previous resources, which the gpu must no longer use; resources used on
+		// both queues are shared concurrently between the given families
+		void realize(const RenderGraph& graph, std::span<const uint32_t> queueFamilyIndices = {});
+		// records every pass into one command buffer, for graphs run on a single queue
+		void record(const RenderGraph& graph, const vk::raii::CommandBuffer& commandBuffer) const;
+		void recordBarriers(const RenderGraph& graph, const vk::raii::CommandBuffer& commandBuffer,
+			std::span<const ResourceBarrier> barriers) const;
+
+		inline vk::Image getImage(ResourceHandle resource) const { return resourceImages[resource.index]; }
+		inline vk::Buffer getBuffer(ResourceHandle resource) const { return resourceBuffers[resource.index]; }
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		Device* device;
+		std::vector<MemoryAllocation> heapAllocations;
+		std::vector<vk::raii::Image> images;
+		std::vector<vk::raii::Buffer> buffers;
+		// indexed by resource handle
+		std::vector<vk::Image> resourceImages;
+		std::vector<vk::Buffer> resourceBuffers;
+
+		void release() noexcept;
+	};
+
+}// namespace vkr
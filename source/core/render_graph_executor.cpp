@@ -0,0 +1,280 @@
+#include "render_graph_executor.hpp"
+
+#include <algorithm>
+
+namespace vkr
+{
+	namespace
+	{
+		std::array<const Queue*, 2> findQueues(const Device& device)
+		{
+			const Queue* graphicsQueue = nullptr;
+			const Queue* computeQueue = nullptr;
+			auto queueFamilyProperties = device.getPhysicalDevice().getQueueFamilyProperties();
+			for (const auto& queueFamily : device.getQueueFamilies())
+			{
+				if (queueFamily.empty())
+					continue;
+
+				auto flags = queueFamilyProperties[queueFamily.getQueueFamilyIndex()].queueFlags;
+				if (!graphicsQueue && (flags & vk::QueueFlagBits::eGraphics))
+					graphicsQueue = &queueFamily.front();
+				else if (!computeQueue && (flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics))
+					computeQueue = &queueFamily.front();
+			}
+
+			if (!graphicsQueue)
+				throw std::runtime_error("No graphics queue for the render graph");
+			return { graphicsQueue, computeQueue ? computeQueue : graphicsQueue };
+		}
+
+		// borrows a command buffer owned by its pool for the raii interface the passes record through
+		class BorrowedCommandBuffer : public vk::raii::CommandBuffer
+		{
+		public:
+			BorrowedCommandBuffer(const vk::raii::Device& device, vk::CommandBuffer commandBuffer)
+				:vk::raii::CommandBuffer{ device, static_cast<VkCommandBuffer>(commandBuffer), VK_NULL_HANDLE } {}
+
+			~BorrowedCommandBuffer() noexcept
+			{
+				release();
+			}
+		};
+
+		// one vkQueueSubmit2 worth of passes
+		struct Submission
+		{
+			std::vector<vk::CommandBufferSubmitInfo> commandBuffers;
+			std::vector<vk::SemaphoreSubmitInfo> waitSemaphores;
+			std::vector<vk::SemaphoreSubmitInfo> signalSemaphores;
+			uint64_t signalValue = 0;
+		};
+	}
+
+	RenderGraphExecutor::RenderGraphExecutor(const Device& device, CommandPoolManager& commandPools)
+		:device{ &device },
+		commandPools{ &commandPools },
+		queues{ findQueues(device) },
+		timelineSemaphores{ createTimelineSemaphore(device), createTimelineSemaphore(device) }
+	{
+		queueFamilyIndices.push_back(queues[0]->getQueueFamilyIndex());
+		if (hasAsyncCompute())
+			queueFamilyIndices.push_back(queues[1]->getQueueFamilyIndex());
+	}
+
+	std::vector<RecordedPass> getRecordedPasses(const RenderGraph& graph, bool asyncCompute)
+	{
+		std::vector<RecordedPass> recordedPasses;
+		const auto& passes = graph.getPasses();
+		const auto& batches = graph.getBatches();
+		for (uint32_t batchIndex = 0; batchIndex < batches.size(); batchIndex++)
+		{
+			std::array<bool, 2> barriersRecorded = {};
+			for (uint32_t pass : batches[batchIndex].passes)
+			{
+				auto queue = asyncCompute ? passes[pass].queue : PassQueue::eGraphics;
+				auto& recordsBarriers = barriersRecorded[static_cast<uint32_t>(queue)];
+				recordedPasses.push_back(RecordedPass{ pass, batchIndex, queue, !recordsBarriers });
+				recordsBarriers = true;
+			}
+		}
+		return recordedPasses;
+	}
+
+	SubmissionPlan planSubmissions(const RenderGraph& graph, std::span<const RecordedPass> recordedPasses)
+	{
+		const auto& passes = graph.getPasses();
+
+		SubmissionPlan plan;
+		std::array<bool, 2> open = {};
+		std::array<uint64_t, 2> timelineValues = {};
+		// largest value of the other queue's timeline a queue already waits for
+		std::array<uint64_t, 2> waitedValues = {};
+		// submission and queue of every planned pass, indexed by pass
+		std::vector<uint32_t> passSubmissions(passes.size(), UINT32_MAX);
+		std::vector<uint32_t> passQueues(passes.size(), UINT32_MAX);
+
+		auto close = [&](uint32_t queue)
+			{
+				if (!open[queue])
+					return;
+
+				plan[queue].back().signalValue = ++timelineValues[queue];
+				open[queue] = false;
+			};
+
+		auto append = [&](uint32_t queue, uint32_t index, uint64_t waitValue)
+			{
+				// submissions on one queue are ordered, a value waited for once is not waited for again
+				bool wait = waitValue > waitedValues[queue];
+				if (wait)
+				{
+					close(queue);
+					waitedValues[queue] = waitValue;
+				}
+
+				if (!open[queue])
+				{
+					plan[queue].emplace_back();
+					open[queue] = true;
+				}
+
+				auto& submission = plan[queue].back();
+				if (wait)
+					submission.waitValue = waitValue;
+				submission.passes.push_back(index);
+				return static_cast<uint32_t>(plan[queue].size() - 1);
+			};
+
+		// value of the other queue's timeline covering the passes a pass depends on
+		auto getWaitValue = [&](const RecordedPass& recordedPass)
+			{
+				uint32_t other = 1 - static_cast<uint32_t>(recordedPass.queue);
+				uint64_t waitValue = 0;
+				for (uint32_t waitPass : passes[recordedPass.pass].queueWaits)
+				{
+					uint32_t submission = passSubmissions[waitPass];
+					if (passQueues[waitPass] != other || submission == UINT32_MAX)
+						continue;
+
+					if (open[other] && submission == plan[other].size() - 1)
+						close(other);
+					waitValue = std::max(waitValue, plan[other][submission].signalValue);
+				}
+				return waitValue;
+			};
+
+		for (uint32_t index = 0; index < recordedPasses.size(); index++)
+		{
+			const auto& recordedPass = recordedPasses[index];
+			uint32_t queue = static_cast<uint32_t>(recordedPass.queue);
+			uint64_t waitValue = getWaitValue(recordedPass);
+
+			// the batch's barriers for this queue are in this pass's command buffer
+			if (recordedPass.recordsBarriers)
+			{
+				for (size_t next = index + 1; next < recordedPasses.size() && recordedPasses[next].batch == recordedPass.batch; next++)
+				{
+					if (recordedPasses[next].queue == recordedPass.queue)
+						waitValue = std::max(waitValue, getWaitValue(recordedPasses[next]));
+				}
+			}
+
+			passSubmissions[recordedPass.pass] = append(queue, index, waitValue);
+			passQueues[recordedPass.pass] = queue;
+		}
+
+		close(1);
+		append(0, UINT32_MAX, timelineValues[1]);
+		close(0);
+		return plan;
+	}
+
+	GraphSubmission RenderGraphExecutor::submit(const RenderGraph& graph, const RecordedGraph& recorded,
+		std::span<const vk::SemaphoreSubmitInfo> waitSemaphores, std::span<const vk::SemaphoreSubmitInfo> signalSemaphores)
+	{
+		auto plan = planSubmissions(graph, recorded.passes);
+
+		// the plan counts from the values the timelines have now
+		std::array<uint64_t, 2> baseValues = timelineValues;
+		std::array<std::vector<Submission>, 2> submissions;
+		for (uint32_t queue = 0; queue < 2; queue++)
+		{
+			for (const auto& planned : plan[queue])
+			{
+				auto& submission = submissions[queue].emplace_back();
+				if (planned.waitValue)
+					submission.waitSemaphores.emplace_back(*timelineSemaphores[1 - queue], baseValues[1 - queue] + planned.waitValue,
+						vk::PipelineStageFlagBits2::eAllCommands);
+				for (uint32_t index : planned.passes)
+				{
+					submission.commandBuffers.emplace_back(index == UINT32_MAX ? recorded.finalCommandBuffer : recorded.passes[index].commandBuffer);
+				}
+				submission.signalValue = baseValues[queue] + planned.signalValue;
+				submission.signalSemaphores.emplace_back(*timelineSemaphores[queue], submission.signalValue,
+					vk::PipelineStageFlagBits2::eAllCommands);
+				timelineValues[queue] = submission.signalValue;
+			}
+		}
+
+		// the previous frame's graphics work may still use memory the compute passes alias
+		uint64_t previousGraphicsValue = baseValues[0];
+		if (!submissions[1].empty() && previousGraphicsValue)
+			submissions[1].front().waitSemaphores.emplace_back(*timelineSemaphores[0], previousGraphicsValue,
+				vk::PipelineStageFlagBits2::eAllCommands);
+		for (auto& queueSubmissions : submissions)
+		{
+			if (queueSubmissions.empty())
+				continue;
+
+			auto& waits = queueSubmissions.front().waitSemaphores;
+			waits.insert(waits.end(), waitSemaphores.begin(), waitSemaphores.end());
+		}
+		auto& signals = submissions[0].back().signalSemaphores;
+		signals.insert(signals.end(), signalSemaphores.begin(), signalSemaphores.end());
+
+		// compute first, graphics waits on it more often than the other way around
+		std::vector<vk::SubmitInfo2> submitInfos;
+		for (uint32_t queue : { 1u, 0u })
+		{
+			if (submissions[queue].empty())
+				continue;
+
+			submitInfos.clear();
+			for (const auto& submission : submissions[queue])
+			{
+				auto& submitInfo = submitInfos.emplace_back();
+				submitInfo.setWaitSemaphoreInfos(submission.waitSemaphores);
+				submitInfo.setCommandBufferInfos(submission.commandBuffers);
+				submitInfo.setSignalSemaphoreInfos(submission.signalSemaphores);
+			}
+			queues[queue]->submit2(submitInfos);
+		}
+
+		return GraphSubmission{ timelineValues[0], timelineValues[1] };
+	}
+
+	void RenderGraphExecutor::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures12.setTimelineSemaphore(true);
+		createInfo.enabledFeatures13.setSynchronization2(true);
+		RenderGraphResources::setDeviceCreateInfo(createInfo);
+	}
+
+	void RenderGraphExecutor::recordPass(const RenderGraph& graph, const RenderGraphResources& resources,
+		RecordedGraph& recorded, uint32_t index) const
+	{
+		bool isFinal = index == recorded.passes.size();
+		auto queue = isFinal ? PassQueue::eGraphics : recorded.passes[index].queue;
+
+		BorrowedCommandBuffer commandBuffer{ *device, commandPools->acquire(getQueue(queue).getQueueFamilyIndex()) };
+		commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+		if (isFinal)
+		{
+			resources.recordBarriers(graph, commandBuffer, graph.getFinalBarriers());
+		}
+		else
+		{
+			const auto& recordedPass = recorded.passes[index];
+			if (recordedPass.recordsBarriers)
+			{
+				std::vector<ResourceBarrier> barriers;
+				for (const auto& barrier : graph.getBatches()[recordedPass.batch].barriers)
+				{
+					if (mapQueue(barrier.queue) == queue)
+						barriers.push_back(barrier);
+				}
+				resources.recordBarriers(graph, commandBuffer, barriers);
+			}
+
+			const auto& pass = graph.getPasses()[recordedPass.pass];
+			if (pass.execute)
+				pass.execute(commandBuffer, resources);
+		}
+		commandBuffer.end();
+
+		auto& recordedCommandBuffer = isFinal ? recorded.finalCommandBuffer : recorded.passes[index].commandBuffer;
+		recordedCommandBuffer = *commandBuffer;
+	}
+
+}// namespace vkr
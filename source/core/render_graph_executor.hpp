@@ -0,0 +1,130 @@
+#pragma once
+
+#include "render_graph.hpp"
+#include "command_pool.hpp"
+
+#include <exec/execution.hpp>
+#include <exec/scheduler.hpp>
+
+#include <array>
+#include <memory>
+#include <span>
+
+namespace vkr
+{
+	struct RecordedPass
+	{
+		uint32_t pass = 0;
+		uint32_t batch = 0;
+		// queue the pass is submitted to, async compute passes run on graphics without a compute queue
+		PassQueue queue = PassQueue::eGraphics;
+		// the first pass of its batch on a queue also records the batch's barriers for that queue
+		bool recordsBarriers = false;
+		vk::CommandBuffer commandBuffer;
+	};
+
+	// one primary command buffer per kept pass, in batch order, and the final barriers
+	struct RecordedGraph
+	{
+		std::vector<RecordedPass> passes;
+		vk::CommandBuffer finalCommandBuffer;
+	};
+
+	// timeline values the submission signals, the graphics value also covers the compute work
+	struct GraphSubmission
+	{
+		uint64_t graphicsValue = 0;
+		uint64_t computeValue = 0;
+	};
+
+	// one vkQueueSubmit2 of a recorded graph, timeline values count up from the value the
+	// queue's timeline had before the graph was submitted
+	struct PlannedSubmission
+	{
+		// indices into the recorded passes, UINT32_MAX for the final barriers
+		std::vector<uint32_t> passes;
+		// value of the other queue's timeline waited for first, 0 for none
+		uint64_t waitValue = 0;
+		uint64_t signalValue = 0;
+	};
+
+	// indexed by PassQueue
+	using SubmissionPlan = std::array<std::vector<PlannedSubmission>, 2>;
+
+	// the kept passes in batch order, each with the queue it is submitted to
+	std::vector<RecordedPass> getRecordedPasses(const RenderGraph& graph, bool asyncCompute);
+
+	// splits each queue's passes into submissions wherever they wait for the other queue; a
+	// submission waits before the pass recording its batch's barriers, which acquire what every
+	// pass of the batch on that queue needs from the other queue; the final barriers go last
+	// on graphics after all compute work
+	SubmissionPlan planSubmissions(const RenderGraph& graph, std::span<const RecordedPass> passes);
+
+	// records the passes of a compiled graph concurrently, each into a primary command buffer
+	// of the recording thread's pool, and submits them to a graphics and a compute queue with
+	// timeline semaphore waits wherever a pass depends on the other queue
+	class RenderGraphExecutor
+	{
+	public:
+		// takes the first graphics family and a compute family without graphics if there is one,
+		// their first queues must not be used by anyone else while submitting
+		RenderGraphExecutor(const Device& device, CommandPoolManager& commandPools);
+
+		RenderGraphExecutor(const RenderGraphExecutor&) = delete;
+		RenderGraphExecutor& operator=(const RenderGraphExecutor&) = delete;
+
+		// records every pass through bulk on the scheduler, on a thread_run_loop every loop
+		// thread records; graph and resources must outlive the operation
+		template<exec::scheduler Sch>
+		inline auto record(Sch&& scheduler, const RenderGraph& graph, const RenderGraphResources& resources)
+		{
+			auto recorded = std::make_shared<RecordedGraph>(RecordedGraph{ getRecordedPasses(graph, hasAsyncCompute()) });
+			auto count = static_cast<uint32_t>(recorded->passes.size()) + 1;
+			return exec::schedule(std::forward<Sch>(scheduler)) |
+				exec::bulk(count, [this, recorded, &graph, &resources](uint32_t index)
+					{
+						recordPass(graph, resources, *recorded, index);
+					}) |
+				exec::then([recorded]
+					{
+						return std::move(*recorded);
+					});
+		}
+
+		// one vkQueueSubmit2 per queue; waits go in front of the first submission of each
+		// queue, signals behind the last graphics one
+		GraphSubmission submit(const RenderGraph& graph, const RecordedGraph& recorded,
+			std::span<const vk::SemaphoreSubmitInfo> waitSemaphores = {},
+			std::span<const vk::SemaphoreSubmitInfo> signalSemaphores = {});
+
+		inline bool hasAsyncCompute() const noexcept { return queues[0] != queues[1]; }
+		inline const Queue& getQueue(PassQueue queue) const noexcept { return *queues[static_cast<uint32_t>(queue)]; }
+		inline const vk::raii::Semaphore& getTimelineSemaphore(PassQueue queue) const noexcept
+		{
+			return timelineSemaphores[static_cast<uint32_t>(mapQueue(queue))];
+		}
+		// families to share the resources used by both queues between, for RenderGraphResources::realize
+		inline std::span<const uint32_t> getQueueFamilyIndices() const noexcept { return queueFamilyIndices; }
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		const Device* device;
+		CommandPoolManager* commandPools;
+		// indexed by PassQueue, both point to the graphics queue without a compute family
+		std::array<const Queue*, 2> queues;
+		std::vector<uint32_t> queueFamilyIndices;
+		std::array<vk::raii::Semaphore, 2> timelineSemaphores;
+		std::array<uint64_t, 2> timelineValues = {};
+
+		inline PassQueue mapQueue(PassQueue queue) const noexcept
+		{
+			return hasAsyncCompute() ? queue : PassQueue::eGraphics;
+		}
+
+		// index past the last pass records the final barriers
+		void recordPass(const RenderGraph& graph, const RenderGraphResources& resources,
+			RecordedGraph& recorded, uint32_t index) const;
+	};
+
+}// namespace vkr
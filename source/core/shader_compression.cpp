@@ -0,0 +1,316 @@
+#include "shader_compression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace vkr
+{
+	namespace
+	{
+		// magic, word count and the size of the coded words ahead of the LZ stream
+		constexpr size_t HeaderSize = 3 * sizeof(uint32_t);
+		constexpr uint32_t HistoryOpcodes = 512;
+		constexpr uint32_t HistoryOperands = 8;
+		constexpr size_t MinMatch = 4;
+		constexpr size_t MaxOffset = 65535;
+		constexpr uint32_t HashBits = 14;
+
+		// operand from which an instruction holds a literal string, 0 if it has none
+		uint32_t getStringOperand(uint32_t opcode)
+		{
+			switch (opcode)
+			{
+				case 4: return 1;// OpSourceExtension
+				case 10: return 1;// OpExtension
+				case 330: return 1;// OpModuleProcessed
+				case 5: return 2;// OpName
+				case 7: return 2;// OpString
+				case 11: return 2;// OpExtInstImport
+				case 6: return 3;// OpMemberName
+				case 5632: return 3;// OpDecorateString
+				case 3: return 4;// OpSource
+				case 5633: return 4;// OpMemberDecorateString
+				default: return 0;
+			}
+		}
+
+		uint32_t& getHistory(std::vector<uint32_t>& history, uint32_t opcode, uint32_t operand)
+		{
+			return history[(opcode % HistoryOpcodes) * HistoryOperands + std::min(operand, HistoryOperands) - 1];
+		}
+
+		void writeVarint(std::vector<uint8_t>& out, uint32_t value)
+		{
+			for (; value >= 0x80; value >>= 7)
+			{
+				out.push_back(static_cast<uint8_t>(value | 0x80));
+			}
+			out.push_back(static_cast<uint8_t>(value));
+		}
+
+		uint32_t readVarint(std::span<const uint8_t> in, size_t& position)
+		{
+			uint32_t value = 0;
+			for (uint32_t shift = 0; shift < 35; shift += 7)
+			{
+				if (position >= in.size())
+					throw std::runtime_error("Compressed SPIR-V ends inside a word");
+				uint8_t byte = in[position++];
+				value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+				if (!(byte & 0x80))
+					return value;
+			}
+			throw std::runtime_error("Compressed SPIR-V has an overlong varint");
+		}
+
+		uint32_t zigzag(uint32_t delta) { return (delta << 1) ^ (0u - (delta >> 31)); }
+		uint32_t unzigzag(uint32_t value) { return (value >> 1) ^ (0u - (value & 1)); }
+
+		std::vector<uint8_t> encodeWords(std::span<const uint32_t> code)
+		{
+			std::vector<uint8_t> out;
+			out.reserve(code.size() * 2);
+			std::vector<uint32_t> history(HistoryOpcodes * HistoryOperands);
+			for (size_t index = 0; index < std::min<size_t>(code.size(), 5); index++)
+			{
+				writeVarint(out, code[index]);
+			}
+
+			for (size_t index = 5; index < code.size();)
+			{
+				uint32_t opcode = code[index] & 0xffff;
+				uint32_t wordCount = code[index] >> 16;
+				if (wordCount == 0 || index + wordCount > code.size())
+					throw std::runtime_error("Malformed SPIR-V instruction stream");
+
+				writeVarint(out, opcode);
+				writeVarint(out, wordCount);
+				uint32_t stringOperand = getStringOperand(opcode);
+				for (uint32_t operand = 1; operand < wordCount; operand++)
+				{
+					uint32_t word = code[index + operand];
+					if (stringOperand && operand >= stringOperand)
+					{
+						out.insert(out.end(), reinterpret_cast<const uint8_t*>(&word), reinterpret_cast<const uint8_t*>(&word + 1));
+						continue;
+					}
+
+					auto& previous = getHistory(history, opcode, operand);
+					writeVarint(out, zigzag(word - previous));
+					previous = word;
+				}
+				index += wordCount;
+			}
+			return out;
+		}
+
+		void decodeWords(std::span<const uint8_t> in, std::span<uint32_t> code)
+		{
+			std::vector<uint32_t> history(HistoryOpcodes * HistoryOperands);
+			size_t position = 0;
+			for (size_t index = 0; index < std::min<size_t>(code.size(), 5); index++)
+			{
+				code[index] = readVarint(in, position);
+			}
+
+			for (size_t index = 5; index < code.size();)
+			{
+				uint32_t opcode = readVarint(in, position);
+				uint32_t wordCount = readVarint(in, position);
+				if (wordCount == 0 || opcode > 0xffff || index + wordCount > code.size())
+					throw std::runtime_error("Compressed SPIR-V has a malformed instruction");
+
+				code[index] = (wordCount << 16) | opcode;
+				uint32_t stringOperand = getStringOperand(opcode);
+				for (uint32_t operand = 1; operand < wordCount; operand++)
+				{
+					if (stringOperand && operand >= stringOperand)
+					{
+						if (position + sizeof(uint32_t) > in.size())
+							throw std::runtime_error("Compressed SPIR-V ends inside a string");
+						std::memcpy(&code[index + operand], &in[position], sizeof(uint32_t));
+						position += sizeof(uint32_t);
+						continue;
+					}
+
+					auto& previous = getHistory(history, opcode, operand);
+					previous += unzigzag(readVarint(in, position));
+					code[index + operand] = previous;
+				}
+				index += wordCount;
+			}
+
+			if (position != in.size())
+				throw std::runtime_error("Compressed SPIR-V has data after its last instruction");
+		}
+
+		void writeLength(std::vector<uint8_t>& out, size_t length)
+		{
+			for (; length >= 255; length -= 255)
+			{
+				out.push_back(255);
+			}
+			out.push_back(static_cast<uint8_t>(length));
+		}
+
+		size_t readLength(std::span<const uint8_t> in, size_t& position, size_t length)
+		{
+			if (length != 15)
+				return length;
+
+			uint8_t byte;
+			do
+			{
+				if (position >= in.size())
+					throw std::runtime_error("Compressed SPIR-V ends inside a length");
+				byte = in[position++];
+				length += byte;
+			} while (byte == 255);
+			return length;
+		}
+
+		// token with the literal and match length, the literals, the match offset; the
+		// last sequence ends after its literals
+		void writeSequence(std::vector<uint8_t>& out, std::span<const uint8_t> literals, size_t offset, size_t matchLength)
+		{
+			size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+			out.push_back(static_cast<uint8_t>((std::min<size_t>(literals.size(), 15) << 4) | std::min<size_t>(matchCode, 15)));
+			if (literals.size() >= 15)
+				writeLength(out, literals.size() - 15);
+			out.insert(out.end(), literals.begin(), literals.end());
+			if (!matchLength)
+				return;
+
+			out.push_back(static_cast<uint8_t>(offset));
+			out.push_back(static_cast<uint8_t>(offset >> 8));
+			if (matchCode >= 15)
+				writeLength(out, matchCode - 15);
+		}
+
+		void compressBlock(std::span<const uint8_t> in, std::vector<uint8_t>& out)
+		{
+			// last position each hash of 4 bytes was seen at, greedy like LZ4's fast mode
+			std::vector<uint32_t> table(size_t{ 1 } << HashBits, UINT32_MAX);
+			auto hash = [&in](size_t position)
+			{
+				uint32_t bytes;
+				std::memcpy(&bytes, &in[position], sizeof(bytes));
+				return (bytes * 2654435761u) >> (32 - HashBits);
+			};
+
+			size_t literalStart = 0;
+			size_t position = 0;
+			while (position + MinMatch <= in.size())
+			{
+				auto& slot = table[hash(position)];
+				size_t candidate = slot;
+				slot = static_cast<uint32_t>(position);
+				if (candidate == UINT32_MAX || position - candidate > MaxOffset ||
+					std::memcmp(&in[candidate], &in[position], MinMatch) != 0)
+				{
+					position++;
+					continue;
+				}
+
+				size_t length = MinMatch;
+				while (position + length < in.size() && in[candidate + length] == in[position + length])
+				{
+					length++;
+				}
+				writeSequence(out, in.subspan(literalStart, position - literalStart), position - candidate, length);
+				position += length;
+				literalStart = position;
+			}
+			writeSequence(out, in.subspan(literalStart), 0, 0);
+		}
+
+		void decompressBlock(std::span<const uint8_t> in, std::span<uint8_t> out)
+		{
+			size_t position = 0;
+			size_t written = 0;
+			while (position < in.size())
+			{
+				uint8_t token = in[position++];
+				size_t literalLength = readLength(in, position, token >> 4);
+				if (literalLength > in.size() - position || literalLength > out.size() - written)
+					throw std::runtime_error("Compressed SPIR-V has literals past its end");
+				std::memcpy(&out[written], &in[position], literalLength);
+				position += literalLength;
+				written += literalLength;
+				if (position == in.size())
+					break;
+
+				if (in.size() - position < 2)
+					throw std::runtime_error("Compressed SPIR-V ends inside a match offset");
+				size_t offset = in[position] | (static_cast<size_t>(in[position + 1]) << 8);
+				position += 2;
+				size_t matchLength = readLength(in, position, token & 15) + MinMatch;
+				if (offset == 0 || offset > written || matchLength > out.size() - written)
+					throw std::runtime_error("Compressed SPIR-V has a match outside of its data");
+
+				// a match may overlap the bytes it produces, which repeats them
+				uint8_t* destination = &out[written];
+				const uint8_t* source = destination - offset;
+				if (offset >= matchLength)
+					std::memcpy(destination, source, matchLength);
+				else
+				{
+					for (size_t index = 0; index < matchLength; index++)
+					{
+						destination[index] = source[index];
+					}
+				}
+				written += matchLength;
+			}
+
+			if (written != out.size())
+				throw std::runtime_error("Compressed SPIR-V is shorter than its header says");
+		}
+
+		uint32_t readHeaderWord(std::span<const uint8_t> compressed, size_t index)
+		{
+			uint32_t word;
+			std::memcpy(&word, &compressed[index * sizeof(uint32_t)], sizeof(word));
+			return word;
+		}
+	}
+
+	std::vector<uint8_t> compressSpirv(std::span<const uint32_t> code)
+	{
+		auto words = encodeWords(code);
+		std::vector<uint8_t> compressed(HeaderSize);
+		std::array<uint32_t, 3> header{ CompressedSpirvMagic, static_cast<uint32_t>(code.size()), static_cast<uint32_t>(words.size()) };
+		std::memcpy(compressed.data(), header.data(), HeaderSize);
+		compressBlock(words, compressed);
+		return compressed;
+	}
+
+	std::vector<uint32_t> decompressSpirv(std::span<const uint8_t> compressed)
+	{
+		uint32_t wordCount = getDecompressedWordCount(compressed);
+		if (wordCount == 0)
+			throw std::runtime_error("Not compressed SPIR-V");
+
+		// every word codes to at least a byte, and a byte of the LZ stream expands to at most
+		// 255, a header claiming more than that is corrupt
+		uint32_t codedSize = readHeaderWord(compressed, 2);
+		if (wordCount > codedSize || codedSize / 255 > compressed.size() - HeaderSize)
+			throw std::runtime_error("Compressed SPIR-V has an invalid header");
+
+		std::vector<uint8_t> words(codedSize);
+		decompressBlock(compressed.subspan(HeaderSize), words);
+		std::vector<uint32_t> code(wordCount);
+		decodeWords(words, code);
+		return code;
+	}
+
+	uint32_t getDecompressedWordCount(std::span<const uint8_t> compressed) noexcept
+	{
+		if (compressed.size() < HeaderSize || readHeaderWord(compressed, 0) != CompressedSpirvMagic)
+			return 0;
+		return readHeaderWord(compressed, 1);
+	}
+
+}// namespace vkr
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// only the standard library, generate_shader compresses with the same code
+namespace vkr
+{
+	constexpr uint32_t CompressedSpirvMagic = 0x7a767073;
+
+	// SPIR-V with every operand coded as the varint difference to the same operand of the
+	// previous instruction with that opcode, result ids and types mostly differ by a little,
+	// literal strings stay as they are; the bytes are then LZ compressed in LZ4's block format
+	std::vector<uint8_t> compressSpirv(std::span<const uint32_t> code);
+
+	// throws on data compressSpirv did not produce
+	std::vector<uint32_t> decompressSpirv(std::span<const uint8_t> compressed);
+
+	// words decompressSpirv returns, 0 if compressed is not compressed SPIR-V
+	uint32_t getDecompressedWordCount(std::span<const uint8_t> compressed) noexcept;
+
+}// namespace vkr
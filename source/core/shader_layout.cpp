@@ -0,0 +1,107 @@
+#include "shader_layout.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace vkr
+{
+	namespace
+	{
+		void mergeBinding(std::vector<vk::DescriptorSetLayoutBinding>& bindings,
+			const vk::DescriptorSetLayoutBinding& binding, uint32_t set)
+		{
+			auto found = std::ranges::find(bindings, binding.binding, &vk::DescriptorSetLayoutBinding::binding);
+			if (found == bindings.end())
+			{
+				bindings.push_back(binding);
+				return;
+			}
+
+			if (found->descriptorType != binding.descriptorType || found->descriptorCount != binding.descriptorCount)
+				throw std::runtime_error(std::format("Stages disagree on set {} binding {}: {} x{} and {} x{}", set,
+					binding.binding, vk::to_string(found->descriptorType), found->descriptorCount,
+					vk::to_string(binding.descriptorType), binding.descriptorCount));
+			found->stageFlags |= binding.stageFlags;
+		}
+
+		// the ranges of one stage become one range over all of them
+		void addStageRanges(std::vector<vk::PushConstantRange>& stageRanges, const vk::PushConstantRange& range)
+		{
+			auto stages = static_cast<uint32_t>(range.stageFlags);
+			for (uint32_t bit = 0; stages; bit++, stages >>= 1)
+			{
+				if (!(stages & 1))
+					continue;
+
+				vk::ShaderStageFlags stage = static_cast<vk::ShaderStageFlagBits>(1u << bit);
+				auto found = std::ranges::find(stageRanges, stage, &vk::PushConstantRange::stageFlags);
+				if (found == stageRanges.end())
+				{
+					stageRanges.push_back(vk::PushConstantRange{ stage, range.offset, range.size });
+					continue;
+				}
+
+				uint32_t end = std::max(found->offset + found->size, range.offset + range.size);
+				found->offset = std::min(found->offset, range.offset);
+				found->size = end - found->offset;
+			}
+		}
+	}
+
+	ShaderLayout mergeShaderLayouts(std::span<const ShaderStageLayout> stages)
+	{
+		ShaderLayout layout;
+		std::vector<vk::PushConstantRange> stageRanges;
+		for (const auto& stage : stages)
+		{
+			if (layout.descriptorSets.size() < stage.descriptorSets.size())
+				layout.descriptorSets.resize(stage.descriptorSets.size());
+
+			for (uint32_t set = 0; set < stage.descriptorSets.size(); set++)
+			{
+				for (const auto& binding : stage.descriptorSets[set])
+				{
+					mergeBinding(layout.descriptorSets[set], binding, set);
+				}
+			}
+
+			for (const auto& range : stage.pushConstantRanges)
+			{
+				addStageRanges(stageRanges, range);
+			}
+		}
+
+		// stages with the same range share it
+		for (const auto& range : stageRanges)
+		{
+			auto sameRange = std::ranges::find_if(layout.pushConstantRanges, [&range](const vk::PushConstantRange& other)
+				{
+					return other.offset == range.offset && other.size == range.size;
+				});
+			if (sameRange != layout.pushConstantRanges.end())
+				sameRange->stageFlags |= range.stageFlags;
+			else
+				layout.pushConstantRanges.push_back(range);
+		}
+
+		for (auto& bindings : layout.descriptorSets)
+		{
+			std::ranges::sort(bindings, {}, &vk::DescriptorSetLayoutBinding::binding);
+		}
+		return layout;
+	}
+
+	vk::raii::PipelineLayout createPipelineLayout(const Device& device, DescriptorLayoutCache& layoutCache,
+		const ShaderLayout& layout)
+	{
+		std::vector<vk::DescriptorSetLayout> setLayouts;
+		setLayouts.reserve(layout.descriptorSets.size());
+		for (const auto& bindings : layout.descriptorSets)
+		{
+			setLayouts.push_back(*layoutCache.getLayout(bindings));
+		}
+
+		return vk::raii::PipelineLayout{ device, vk::PipelineLayoutCreateInfo{ {}, setLayouts, layout.pushConstantRanges } };
+	}
+
+}// namespace vkr
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "descriptor_allocator.hpp"
+
+#include <span>
+#include <vector>
+
+namespace vkr
+{
+	// layout data of one generated shader header, e.g.
+	// ShaderStageLayout{ ShaderData::triangle_vert::descriptorSets, ShaderData::triangle_vert::pushConstantRanges }
+	struct ShaderStageLayout
+	{
+		// indexed by set number
+		std::span<const std::span<const vk::DescriptorSetLayoutBinding>> descriptorSets;
+		std::span<const vk::PushConstantRange> pushConstantRanges;
+	};
+
+	struct ShaderLayout
+	{
+		// indexed by set number, sets no stage uses are empty
+		std::vector<std::vector<vk::DescriptorSetLayoutBinding>> descriptorSets;
+		std::vector<vk::PushConstantRange> pushConstantRanges;
+	};
+
+	// combines the layouts of the stages of one pipeline: a binding several stages declare
+	// gets the union of their stage flags and has to have the same type and count in each,
+	// stages with the same push constant range share one range and the ranges of one stage
+	// are joined, a stage may appear in one range only
+	ShaderLayout mergeShaderLayouts(std::span<const ShaderStageLayout> stages);
+
+	// set layouts come from the cache, an empty set gets the empty layout
+	vk::raii::PipelineLayout createPipelineLayout(const Device& device, DescriptorLayoutCache& layoutCache,
+		const ShaderLayout& layout);
+
+}// namespace vkr
@@ -0,0 +1,83 @@
+#include "shader_library.hpp"
+
+#include <format>
+#include <stdexcept>
+
+namespace vkr
+{
+	uint32_t ShaderLibrary::add(std::string_view name, std::span<const uint8_t> compressed)
+	{
+		if (getDecompressedWordCount(compressed) == 0)
+			throw std::runtime_error(std::format("Shader {} is not compressed SPIR-V", name));
+
+		auto found = names.find(name);
+		if (found != names.end())
+		{
+			auto& entry = entries[found->second];
+			compressedSize += compressed.size() - entry.compressed.size();
+			if (entry.state.load(std::memory_order_relaxed) == EntryState::eReady)
+				decompressedSize.fetch_sub(entry.code.size() * sizeof(uint32_t), std::memory_order_relaxed);
+			entry.compressed = compressed;
+			entry.state.store(EntryState::eCompressed, std::memory_order_relaxed);
+			entry.code = {};
+			return found->second;
+		}
+
+		auto index = static_cast<uint32_t>(entries.size());
+		entries.emplace_back().compressed = compressed;
+		names.emplace(name, index);
+		compressedSize += compressed.size();
+		return index;
+	}
+
+	uint32_t ShaderLibrary::find(std::string_view name) const
+	{
+		auto found = names.find(name);
+		return found == names.end() ? UINT32_MAX : found->second;
+	}
+
+	std::span<const uint32_t> ShaderLibrary::getCode(uint32_t index)
+	{
+		auto& entry = entries.at(index);
+		while (true)
+		{
+			auto state = entry.state.load(std::memory_order_acquire);
+			if (state == EntryState::eReady)
+				return entry.code;
+
+			if (state == EntryState::eDecompressing)
+			{
+				entry.state.wait(state, std::memory_order_acquire);
+				continue;
+			}
+
+			if (!entry.state.compare_exchange_strong(state, EntryState::eDecompressing, std::memory_order_acquire))
+				continue;
+
+			try
+			{
+				entry.code = decompressSpirv(entry.compressed);
+			}
+			catch (...)
+			{
+				// the next caller tries again and sees the error as well
+				entry.state.store(EntryState::eCompressed, std::memory_order_release);
+				entry.state.notify_all();
+				throw;
+			}
+			decompressedSize.fetch_add(entry.code.size() * sizeof(uint32_t), std::memory_order_relaxed);
+			entry.state.store(EntryState::eReady, std::memory_order_release);
+			entry.state.notify_all();
+			return entry.code;
+		}
+	}
+
+	std::span<const uint32_t> ShaderLibrary::getCode(std::string_view name)
+	{
+		uint32_t index = find(name);
+		if (index == UINT32_MAX)
+			throw std::runtime_error(std::format("No shader {} in the library", name));
+		return getCode(index);
+	}
+
+}// namespace vkr
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "shader_compression.hpp"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace vkr
+{
+	// compressed shaders by name, e.g. library.add("triangle_vert", ShaderData::triangle_vert::compressedCode);
+	// a shader is decompressed by the first thread asking for its code, other threads asking
+	// for it meanwhile wait for that thread, later calls return the cached code
+	class ShaderLibrary
+	{
+	public:
+		ShaderLibrary() = default;
+
+		ShaderLibrary(const ShaderLibrary&) = delete;
+		ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+		// the data is not copied and has to outlive the library, as embedded shaders do;
+		// returns the index of the shader, adding a name again replaces its data
+		uint32_t add(std::string_view name, std::span<const uint8_t> compressed);
+
+		// UINT32_MAX if there is no shader of that name
+		uint32_t find(std::string_view name) const;
+
+		// safe from several threads, but not while shaders are added
+		std::span<const uint32_t> getCode(uint32_t index);
+		std::span<const uint32_t> getCode(std::string_view name);
+
+		inline size_t size() const noexcept { return entries.size(); }
+		// bytes of the compressed data and of the code decompressed so far
+		inline size_t getCompressedSize() const noexcept { return compressedSize; }
+		inline size_t getDecompressedSize() const noexcept { return decompressedSize.load(std::memory_order_relaxed); }
+
+	private:
+		enum class EntryState : uint32_t
+		{
+			eCompressed,
+			eDecompressing,
+			eReady
+		};
+
+		struct Entry
+		{
+			std::span<const uint8_t> compressed;
+			std::atomic<EntryState> state = EntryState::eCompressed;
+			std::vector<uint32_t> code;
+		};
+
+		std::deque<Entry> entries;
+		std::map<std::string, uint32_t, std::less<>> names;
+		size_t compressedSize = 0;
+		std::atomic<size_t> decompressedSize = 0;
+	};
+
+}// namespace vkr
@@ -0,0 +1,111 @@
+#include "spirv_file.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace vkr
+{
+	namespace
+	{
+		constexpr uint32_t SpirvMagic = 0x07230203;
+	}
+
+	SpirvFile::SpirvFile(const std::filesystem::path& path)
+	{
+		// an empty file cannot be mapped, checking the size first also gives the better error
+		std::error_code error;
+		auto fileSize = std::filesystem::file_size(path, error);
+		if (error)
+			throw std::runtime_error(std::format("Failed to open {}: {}", path.string(), error.message()));
+		if (fileSize < sizeof(uint32_t) * 5 || fileSize % sizeof(uint32_t) != 0)
+			throw std::runtime_error(std::format("{} is not a SPIR-V module", path.string()));
+
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error(std::format("Failed to open {}", path.string()));
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping)
+			throw std::runtime_error(std::format("Failed to map {}", path.string()));
+		code = static_cast<const uint32_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!code)
+		{
+			CloseHandle(mapping);
+			throw std::runtime_error(std::format("Failed to map {}", path.string()));
+		}
+#else
+		int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+			throw std::runtime_error(std::format("Failed to open {}", path.string()));
+		// the mapping keeps the file alive after its descriptor is closed
+		void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (mapped == MAP_FAILED)
+			throw std::runtime_error(std::format("Failed to map {}", path.string()));
+		code = static_cast<const uint32_t*>(mapped);
+#endif
+		wordCount = fileSize / sizeof(uint32_t);
+
+		if (code[0] != SpirvMagic)
+		{
+			unmap();
+			throw std::runtime_error(std::format("{} is not a SPIR-V module", path.string()));
+		}
+	}
+
+	SpirvFile::~SpirvFile() noexcept
+	{
+		unmap();
+	}
+
+	SpirvFile::SpirvFile(SpirvFile&& other) noexcept
+		:code{ std::exchange(other.code, nullptr) },
+		wordCount{ std::exchange(other.wordCount, 0) }
+#ifdef _WIN32
+		, mapping{ std::exchange(other.mapping, nullptr) }
+#endif
+	{
+	}
+
+	SpirvFile& SpirvFile::operator=(SpirvFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			unmap();
+			code = std::exchange(other.code, nullptr);
+			wordCount = std::exchange(other.wordCount, 0);
+#ifdef _WIN32
+			mapping = std::exchange(other.mapping, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+	void SpirvFile::unmap() noexcept
+	{
+		if (!code)
+			return;
+#ifdef _WIN32
+		UnmapViewOfFile(code);
+		CloseHandle(mapping);
+		mapping = nullptr;
+#else
+		munmap(const_cast<uint32_t*>(code), wordCount * sizeof(uint32_t));
+#endif
+		code = nullptr;
+		wordCount = 0;
+	}
+
+}// namespace vkr
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+// only the standard library and the OS, generate_shader maps its input with the same code
+namespace vkr
+{
+	// read only memory mapping of a SPIR-V file, the pages are shared with the OS file cache
+	// instead of being copied into a buffer, e.g. for vk::ShaderModuleCreateInfo or for
+	// reflection with SPV_REFLECT_MODULE_FLAG_NO_COPY; the code is valid while the file lives
+	class SpirvFile
+	{
+	public:
+		// throws if the file cannot be mapped or does not start with the SPIR-V magic number
+		explicit SpirvFile(const std::filesystem::path& path);
+		~SpirvFile() noexcept;
+
+		SpirvFile(const SpirvFile&) = delete;
+		SpirvFile& operator=(const SpirvFile&) = delete;
+		SpirvFile(SpirvFile&& other) noexcept;
+		SpirvFile& operator=(SpirvFile&& other) noexcept;
+
+		inline std::span<const uint32_t> getCode() const noexcept { return { code, wordCount }; }
+		// in words, data and size let the file be passed where a container of the code is expected
+		inline const uint32_t* data() const noexcept { return code; }
+		inline size_t size() const noexcept { return wordCount; }
+
+	private:
+		void unmap() noexcept;
+
+		const uint32_t* code = nullptr;
+		size_t wordCount = 0;
+#ifdef _WIN32
+		void* mapping = nullptr;
+#endif
+	};
+
+}// namespace vkr
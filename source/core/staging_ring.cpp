@@ -0,0 +1,165 @@
+#include "staging_ring.hpp"
+
+#include <cstring>
+
+namespace vkr
+{
+	RingAllocator::RingAllocator(vk::DeviceSize capacity)
+		:capacity{ capacity } {}
+
+	std::optional<vk::DeviceSize> RingAllocator::allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+	{
+		alignment = std::max<vk::DeviceSize>(alignment, 1);
+		if (usedSize == 0)
+		{
+			head = 0;
+			tail = 0;
+		}
+		else if (head == tail)
+		{
+			return {};
+		}
+
+		vk::DeviceSize offset = (head + alignment - 1) / alignment * alignment;
+		vk::DeviceSize newHead = offset + size;
+		if (head >= tail)
+		{
+			if (newHead > capacity)
+			{
+				// the end of the ring is wasted and belongs to this frame
+				if (size > tail)
+					return {};
+				offset = 0;
+				newHead = size;
+			}
+		}
+		else if (newHead > tail)
+		{
+			return {};
+		}
+
+		vk::DeviceSize allocatedSize = newHead >= head ? newHead - head : capacity - head + newHead;
+		head = newHead;
+		usedSize += allocatedSize;
+		frameSize += allocatedSize;
+		return offset;
+	}
+
+	void RingAllocator::endFrame(uint64_t timelineValue)
+	{
+		if (frameSize == 0)
+			return;
+		frames.push_back(Frame{ timelineValue, head, frameSize });
+		frameSize = 0;
+	}
+
+	void RingAllocator::retire(uint64_t completedValue)
+	{
+		while (!frames.empty() && frames.front().retireValue <= completedValue)
+		{
+			tail = frames.front().end;
+			usedSize -= frames.front().size;
+			frames.pop_front();
+		}
+	}
+
+	std::optional<uint64_t> RingAllocator::getOldestRetireValue() const noexcept
+	{
+		if (frames.empty())
+			return {};
+		return frames.front().retireValue;
+	}
+
+	StagingRing::StagingRing(Device& device, const vk::raii::Semaphore& timelineSemaphore, vk::DeviceSize size)
+		:device{ &device },
+		timelineSemaphore{ &timelineSemaphore },
+		buffer{ device, vk::BufferCreateInfo{ {}, size, vk::BufferUsageFlagBits::eTransferSrc } },
+		ringAllocator{ size }
+	{
+		AllocationCreateInfo createInfo;
+		createInfo.usage = MemoryUsage::eCpuToGpu;
+		allocation = device.getMemoryAllocator().allocate(buffer.getMemoryRequirements(), createInfo);
+		buffer.bindMemory(allocation.memory, allocation.offset);
+	}
+
+	StagingRing::~StagingRing() noexcept
+	{
+		buffer.clear();
+		device->getMemoryAllocator().free(allocation);
+	}
+
+	void StagingRing::upload(vk::Buffer dstBuffer, vk::DeviceSize dstOffset, std::span<const std::byte> data,
+		vk::DeviceSize alignment)
+	{
+		std::unique_lock lock{ mutex };
+
+		auto srcOffset = allocate(data.size(), alignment);
+		std::memcpy(static_cast<std::byte*>(allocation.mappedData) + srcOffset, data.data(), data.size());
+
+		auto& regions = pendingCopies[dstBuffer];
+		if (!regions.empty()
+			&& regions.back().srcOffset + regions.back().size == srcOffset
+			&& regions.back().dstOffset + regions.back().size == dstOffset)
+		{
+			regions.back().size += data.size();
+		}
+		else
+		{
+			regions.push_back(vk::BufferCopy{ srcOffset, dstOffset, data.size() });
+		}
+	}
+
+	void StagingRing::recordCopies(vk::CommandBuffer commandBuffer)
+	{
+		std::unique_lock lock{ mutex };
+
+		for (const auto& [dstBuffer, regions] : pendingCopies)
+		{
+			commandBuffer.copyBuffer(*buffer, dstBuffer, regions, *device->getDispatcher());
+		}
+		pendingCopies.clear();
+	}
+
+	void StagingRing::endFrame(uint64_t timelineValue)
+	{
+		std::unique_lock lock{ mutex };
+		ringAllocator.endFrame(timelineValue);
+	}
+
+	vk::DeviceSize StagingRing::getPendingSize()
+	{
+		std::unique_lock lock{ mutex };
+		return ringAllocator.getFrameSize();
+	}
+
+	void StagingRing::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures12.setTimelineSemaphore(true);
+	}
+
+	vk::DeviceSize StagingRing::allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+	{
+		if (size > ringAllocator.getCapacity())
+			throw std::runtime_error("Upload is larger than the staging ring");
+
+		ringAllocator.retire(timelineSemaphore->getCounterValue());
+		while (true)
+		{
+			if (auto offset = ringAllocator.allocate(size, alignment))
+				return *offset;
+
+			auto retireValue = ringAllocator.getOldestRetireValue();
+			if (!retireValue)
+				throw std::runtime_error("Staging ring is full within a single frame");
+
+			vk::Semaphore semaphore = **timelineSemaphore;
+			vk::SemaphoreWaitInfo waitInfo;
+			waitInfo.setSemaphores(semaphore);
+			waitInfo.setValues(*retireValue);
+			if (device->waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+				throw std::runtime_error("Failed to wait for staging ring retirement");
+			ringAllocator.retire(*retireValue);
+		}
+	}
+
+}// namespace vkr
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace vkr
+{
+	// bump allocator over a ring of memory, the memory handed out in one frame is
+	// reused once the timeline value recorded for that frame has been reached
+	class RingAllocator
+	{
+	public:
+		explicit RingAllocator(vk::DeviceSize capacity);
+
+		// returns no value if the ring has no room until older frames retire
+		std::optional<vk::DeviceSize> allocate(vk::DeviceSize size, vk::DeviceSize alignment = 1);
+
+		void endFrame(uint64_t timelineValue);
+		void retire(uint64_t completedValue);
+
+		// timeline value the oldest frame in flight waits for, if there is one
+		std::optional<uint64_t> getOldestRetireValue() const noexcept;
+
+		inline vk::DeviceSize getCapacity() const noexcept { return capacity; }
+		inline vk::DeviceSize getUsedSize() const noexcept { return usedSize; }
+		inline vk::DeviceSize getFrameSize() const noexcept { return frameSize; }
+
+	private:
+		struct Frame
+		{
+			uint64_t retireValue;
+			vk::DeviceSize end;
+			vk::DeviceSize size;
+		};
+
+		vk::DeviceSize capacity;
+		vk::DeviceSize head = 0;
+		vk::DeviceSize tail = 0;
+		vk::DeviceSize usedSize = 0;
+		vk::DeviceSize frameSize = 0;
+		std::deque<Frame> frames;
+	};
+
+	// persistently mapped host coherent upload buffer, copies recorded in one frame
+	// are merged into one vkCmdCopyBuffer per destination buffer
+	class StagingRing
+	{
+	public:
+		StagingRing(Device& device, const vk::raii::Semaphore& timelineSemaphore, vk::DeviceSize size);
+		~StagingRing() noexcept;
+
+		StagingRing(const StagingRing&) = delete;
+		StagingRing& operator=(const StagingRing&) = delete;
+
+		void upload(vk::Buffer dstBuffer, vk::DeviceSize dstOffset, std::span<const std::byte> data,
+			vk::DeviceSize alignment = 16);
+
+		template<typename T>
+		void upload(vk::Buffer dstBuffer, vk::DeviceSize dstOffset, std::span<const T> data)
+		{
+			upload(dstBuffer, dstOffset, std::as_bytes(data), alignof(T) > 16 ? alignof(T) : 16);
+		}
+
+		void recordCopies(vk::CommandBuffer commandBuffer);
+
+		// value the submission containing this frame's copies signals on the timeline
+		void endFrame(uint64_t timelineValue);
+
+		inline vk::Buffer getBuffer() const noexcept { return *buffer; }
+		inline vk::DeviceSize getCapacity() const noexcept { return ringAllocator.getCapacity(); }
+
+		// bytes uploaded since the last endFrame
+		vk::DeviceSize getPendingSize();
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		Device* device;
+		const vk::raii::Semaphore* timelineSemaphore;
+		vk::raii::Buffer buffer;
+		MemoryAllocation allocation;
+		RingAllocator ringAllocator;
+		std::map<vk::Buffer, std::vector<vk::BufferCopy>> pendingCopies;
+		std::mutex mutex;
+
+		vk::DeviceSize allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+	};
+
+}// namespace vkr
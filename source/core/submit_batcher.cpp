@@ -0,0 +1,93 @@
+#include "submit_batcher.hpp"
+
+namespace vkr
+{
+	SubmitBatcher::SubmitBatcher(const Queue& queue, uint32_t batchLimit)
+		:queue{ &queue },
+		batchLimit{ std::max(batchLimit, 1u) }
+	{
+		pendingRequests.reserve(this->batchLimit);
+	}
+
+	void SubmitBatcher::push(SubmitRequest&& request)
+	{
+		std::unique_lock lock{ mutex };
+		pendingRequests.push_back(std::move(request));
+		statistics.requestCount++;
+		if (pendingRequests.size() >= batchLimit)
+			flushLocked({});
+	}
+
+	void SubmitBatcher::push(vk::CommandBuffer commandBuffer)
+	{
+		SubmitRequest request;
+		request.commandBufferInfos.push_back(vk::CommandBufferSubmitInfo{ commandBuffer });
+		push(std::move(request));
+	}
+
+	void SubmitBatcher::flush(vk::Fence fence)
+	{
+		std::unique_lock lock{ mutex };
+		flushLocked(fence);
+	}
+
+	SubmitStatistics SubmitBatcher::getStatistics() const
+	{
+		std::unique_lock lock{ mutex };
+		return statistics;
+	}
+
+	void SubmitBatcher::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures13.setSynchronization2(true);
+	}
+
+	void SubmitBatcher::flushLocked(vk::Fence fence)
+	{
+		if (pendingRequests.empty() && !fence)
+			return;
+
+		size_t commandBufferCount = 0;
+		for (const auto& request : pendingRequests)
+			commandBufferCount += request.commandBufferInfos.size();
+
+		// requests without waits following requests without signals keep their
+		// ordering guarantees when their command buffers share one submit info
+		std::vector<vk::CommandBufferSubmitInfo> commandBufferInfos;
+		commandBufferInfos.reserve(commandBufferCount);
+		std::vector<vk::SubmitInfo2> submitInfos;
+		std::vector<size_t> firstCommandBuffers;
+
+		for (const auto& request : pendingRequests)
+		{
+			bool merge = !submitInfos.empty()
+				&& request.waitSemaphoreInfos.empty()
+				&& submitInfos.back().signalSemaphoreInfoCount == 0;
+
+			if (!merge)
+			{
+				vk::SubmitInfo2 submitInfo;
+				submitInfo.setWaitSemaphoreInfos(request.waitSemaphoreInfos);
+				submitInfos.push_back(submitInfo);
+				firstCommandBuffers.push_back(commandBufferInfos.size());
+			}
+
+			commandBufferInfos.insert(commandBufferInfos.end(),
+				request.commandBufferInfos.begin(), request.commandBufferInfos.end());
+			submitInfos.back().setSignalSemaphoreInfos(request.signalSemaphoreInfos);
+		}
+
+		for (size_t index = 0; index < submitInfos.size(); index++)
+		{
+			size_t first = firstCommandBuffers[index];
+			size_t last = index + 1 < submitInfos.size() ? firstCommandBuffers[index + 1] : commandBufferInfos.size();
+			submitInfos[index].setCommandBufferInfoCount(static_cast<uint32_t>(last - first));
+			submitInfos[index].setPCommandBufferInfos(commandBufferInfos.data() + first);
+		}
+
+		queue->submit2(submitInfos, fence);
+		statistics.submitCount++;
+		pendingRequests.clear();
+	}
+
+}// namespace vkr
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <mutex>
+
+namespace vkr
+{
+	struct SubmitRequest
+	{
+		std::vector<vk::SemaphoreSubmitInfo> waitSemaphoreInfos;
+		std::vector<vk::CommandBufferSubmitInfo> commandBufferInfos;
+		std::vector<vk::SemaphoreSubmitInfo> signalSemaphoreInfos;
+	};
+
+	struct SubmitStatistics
+	{
+		uint64_t submitCount = 0;
+		uint64_t requestCount = 0;
+	};
+
+	// collects submit requests from any thread and hands them to the queue
+	// in one vkQueueSubmit2 per flush
+	class SubmitBatcher
+	{
+	public:
+		explicit SubmitBatcher(const Queue& queue, uint32_t batchLimit = 64);
+
+		SubmitBatcher(const SubmitBatcher&) = delete;
+		SubmitBatcher& operator=(const SubmitBatcher&) = delete;
+
+		void push(SubmitRequest&& request);
+		void push(vk::CommandBuffer commandBuffer);
+
+		// submits all pending requests, fence is signaled once they complete
+		void flush(vk::Fence fence = {});
+
+		SubmitStatistics getStatistics() const;
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		const Queue* queue;
+		uint32_t batchLimit;
+		std::vector<SubmitRequest> pendingRequests;
+		SubmitStatistics statistics;
+		mutable std::mutex mutex;
+
+		void flushLocked(vk::Fence fence);
+	};
+
+}// namespace vkr
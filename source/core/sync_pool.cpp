@@ -0,0 +1,180 @@
+#include "sync_pool.hpp"
+#include "device.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace vkr
+{
+	namespace
+	{
+		uint64_t getSemaphoreCounterValue(const vk::raii::Device& device, vk::Semaphore timeline)
+		{
+			uint64_t value = 0;
+			auto result = static_cast<vk::Result>(device.getDispatcher()->vkGetSemaphoreCounterValue(
+				static_cast<VkDevice>(*device), static_cast<VkSemaphore>(timeline), &value));
+			if (result != vk::Result::eSuccess)
+				throw std::runtime_error(std::format("Failed to query semaphore counter: {}", vk::to_string(result)));
+			return value;
+		}
+	}
+
+	vk::raii::Semaphore createTimelineSemaphore(const vk::raii::Device& device, uint64_t initialValue)
+	{
+		vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> createInfo{
+			{}, vk::SemaphoreTypeCreateInfo{ vk::SemaphoreType::eTimeline, initialValue } };
+		return vk::raii::Semaphore{ device, createInfo.get<vk::SemaphoreCreateInfo>() };
+	}
+
+	FencePool::FencePool(const vk::raii::Device& device)
+		:device{ &device } {}
+
+	vk::Fence FencePool::acquire()
+	{
+		std::unique_lock lock{ mutex };
+		if (freeFences.empty())
+			collectSignaledLocked();
+
+		if (!freeFences.empty())
+		{
+			vk::Fence fence = freeFences.back();
+			freeFences.pop_back();
+			return fence;
+		}
+
+		fences.emplace_back(*device, vk::FenceCreateInfo{});
+		createdCount.fetch_add(1, std::memory_order_relaxed);
+		return *fences.back();
+	}
+
+	void FencePool::release(std::span<const vk::Fence> fences)
+	{
+		std::unique_lock lock{ mutex };
+		pendingFences.insert(pendingFences.end(), fences.begin(), fences.end());
+	}
+
+	bool FencePool::waitAndRelease(std::span<const vk::Fence> fences, uint64_t timeout)
+	{
+		if (fences.empty())
+			return true;
+
+		vk::ArrayProxy<const vk::Fence> fenceProxy{ static_cast<uint32_t>(fences.size()), fences.data() };
+		if (device->waitForFences(fenceProxy, true, timeout) == vk::Result::eTimeout)
+		{
+			release(fences);
+			return false;
+		}
+
+		device->resetFences(fenceProxy);
+
+		std::unique_lock lock{ mutex };
+		freeFences.insert(freeFences.end(), fences.begin(), fences.end());
+		return true;
+	}
+
+	void FencePool::collectSignaledLocked()
+	{
+		std::vector<vk::Fence> signaledFences;
+		std::erase_if(pendingFences, [&](vk::Fence fence)
+			{
+				auto result = static_cast<vk::Result>(device->getDispatcher()->vkGetFenceStatus(
+					static_cast<VkDevice>(**device), static_cast<VkFence>(fence)));
+				if (result == vk::Result::eNotReady)
+					return false;
+				if (result != vk::Result::eSuccess)
+					throw std::runtime_error(std::format("Failed to query fence status: {}", vk::to_string(result)));
+
+				signaledFences.push_back(fence);
+				return true;
+			});
+
+		if (signaledFences.empty())
+			return;
+
+		device->resetFences(signaledFences);
+		freeFences.insert(freeFences.end(), signaledFences.begin(), signaledFences.end());
+	}
+
+	SemaphorePool::SemaphorePool(const vk::raii::Device& device)
+		:device{ &device } {}
+
+	vk::Semaphore SemaphorePool::acquireBinary()
+	{
+		std::unique_lock lock{ mutex };
+		if (freeBinary.empty())
+			collectRetiredLocked(pendingBinary, freeBinary);
+
+		if (!freeBinary.empty())
+		{
+			vk::Semaphore semaphore = freeBinary.back();
+			freeBinary.pop_back();
+			return semaphore;
+		}
+
+		semaphores.emplace_back(*device, vk::SemaphoreCreateInfo{});
+		createdBinaryCount.fetch_add(1, std::memory_order_relaxed);
+		return *semaphores.back();
+	}
+
+	void SemaphorePool::releaseBinary(vk::Semaphore semaphore, vk::Semaphore retireTimeline, uint64_t retireValue)
+	{
+		std::unique_lock lock{ mutex };
+		pendingBinary.push_back({ semaphore, retireTimeline, retireValue });
+	}
+
+	TimelineSemaphore SemaphorePool::acquireTimeline()
+	{
+		std::unique_lock lock{ mutex };
+		if (freeTimeline.empty())
+			collectRetiredLocked(pendingTimeline, freeTimeline);
+
+		if (!freeTimeline.empty())
+		{
+			// queried before the pop so a failed query leaves the semaphore in the pool
+			vk::Semaphore semaphore = freeTimeline.back();
+			uint64_t value = getSemaphoreCounterValue(*device, semaphore);
+			freeTimeline.pop_back();
+			return { semaphore, value };
+		}
+
+		semaphores.push_back(createTimelineSemaphore(*device));
+		createdTimelineCount.fetch_add(1, std::memory_order_relaxed);
+		return { *semaphores.back(), 0 };
+	}
+
+	void SemaphorePool::releaseTimeline(vk::Semaphore semaphore, uint64_t finalValue)
+	{
+		std::unique_lock lock{ mutex };
+		pendingTimeline.push_back({ semaphore, semaphore, finalValue });
+	}
+
+	void SemaphorePool::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures12.setTimelineSemaphore(true);
+	}
+
+	void SemaphorePool::collectRetiredLocked(std::vector<PendingSemaphore>& pending, std::vector<vk::Semaphore>& free)
+	{
+		std::vector<std::pair<vk::Semaphore, uint64_t>> counterValues;
+		auto getCounterValue = [&](vk::Semaphore timeline)
+			{
+				auto iter = std::ranges::find(counterValues, timeline, &std::pair<vk::Semaphore, uint64_t>::first);
+				if (iter != counterValues.end())
+					return iter->second;
+
+				uint64_t value = getSemaphoreCounterValue(*device, timeline);
+				counterValues.emplace_back(timeline, value);
+				return value;
+			};
+
+		std::erase_if(pending, [&](const PendingSemaphore& semaphore)
+			{
+				if (getCounterValue(semaphore.retireTimeline) < semaphore.retireValue)
+					return false;
+
+				free.push_back(semaphore.semaphore);
+				return true;
+			});
+	}
+
+}// namespace vkr
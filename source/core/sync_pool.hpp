@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <span>
+
+namespace vkr
+{
+	struct DeviceCreateInfo;
+
+	// recycles fences instead of creating one per submission; submitted fences come
+	// back through release and are reset in one vkResetFences once they signaled
+	class FencePool
+	{
+	public:
+		explicit FencePool(const vk::raii::Device& device);
+
+		FencePool(const FencePool&) = delete;
+		FencePool& operator=(const FencePool&) = delete;
+
+		// unsignaled fence, ready to be passed to a submission
+		vk::Fence acquire();
+
+		// fences that were submitted, each is reused after it signaled
+		void release(std::span<const vk::Fence> fences);
+		// one vkWaitForFences over the whole group, then one vkResetFences and the group is
+		// free again; returns false and keeps the fences pending if the timeout expired
+		bool waitAndRelease(std::span<const vk::Fence> fences, uint64_t timeout = UINT64_MAX);
+
+		// number of fences created so far, stays flat once the pool covers the frames in flight
+		inline uint64_t getCreatedCount() const noexcept { return createdCount.load(std::memory_order_relaxed); }
+
+	private:
+		const vk::raii::Device* device;
+		std::vector<vk::raii::Fence> fences;
+		std::vector<vk::Fence> freeFences;
+		std::vector<vk::Fence> pendingFences;
+		std::atomic<uint64_t> createdCount = 0;
+		std::mutex mutex;
+
+		void collectSignaledLocked();
+	};
+
+	// timeline semaphore owned by the caller, starting at initialValue
+	vk::raii::Semaphore createTimelineSemaphore(const vk::raii::Device& device, uint64_t initialValue = 0);
+
+	struct TimelineSemaphore
+	{
+		vk::Semaphore semaphore;
+		// counter value when acquired, the next signal has to be larger
+		uint64_t value = 0;
+	};
+
+	// recycles binary and timeline semaphores; a released semaphore is reused once the
+	// timeline value guarding its last use is reached
+	class SemaphorePool
+	{
+	public:
+		explicit SemaphorePool(const vk::raii::Device& device);
+
+		SemaphorePool(const SemaphorePool&) = delete;
+		SemaphorePool& operator=(const SemaphorePool&) = delete;
+
+		vk::Semaphore acquireBinary();
+		// the binary semaphore is free again once retireTimeline reaches retireValue,
+		// which a submission waiting on the semaphore or later has to signal
+		void releaseBinary(vk::Semaphore semaphore, vk::Semaphore retireTimeline, uint64_t retireValue);
+
+		TimelineSemaphore acquireTimeline();
+		// free again once the semaphore itself reaches finalValue
+		void releaseTimeline(vk::Semaphore semaphore, uint64_t finalValue);
+
+		inline uint64_t getCreatedBinaryCount() const noexcept { return createdBinaryCount.load(std::memory_order_relaxed); }
+		inline uint64_t getCreatedTimelineCount() const noexcept { return createdTimelineCount.load(std::memory_order_relaxed); }
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		struct PendingSemaphore
+		{
+			vk::Semaphore semaphore;
+			vk::Semaphore retireTimeline;
+			uint64_t retireValue;
+		};
+
+		const vk::raii::Device* device;
+		std::vector<vk::raii::Semaphore> semaphores;
+		std::vector<vk::Semaphore> freeBinary;
+		std::vector<vk::Semaphore> freeTimeline;
+		std::vector<PendingSemaphore> pendingBinary;
+		std::vector<PendingSemaphore> pendingTimeline;
+		std::atomic<uint64_t> createdBinaryCount = 0;
+		std::atomic<uint64_t> createdTimelineCount = 0;
+		std::mutex mutex;
+
+		// moves every pending semaphore whose timeline reached its value to free,
+		// each distinct timeline is queried once
+		void collectRetiredLocked(std::vector<PendingSemaphore>& pending, std::vector<vk::Semaphore>& free);
+	};
+
+}// namespace vkr
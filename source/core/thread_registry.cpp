@@ -0,0 +1,57 @@
+#include "thread_registry.hpp"
+
+namespace vkr
+{
+	namespace
+	{
+		struct SlotEntry
+		{
+			// 0 until an owner sets the entry, ids start at 1
+			uint64_t id = 0;
+			void* value = nullptr;
+		};
+
+		thread_local std::vector<SlotEntry> threadSlots;
+
+		std::mutex slotMutex;
+		std::vector<uint32_t> freeSlots;
+		uint32_t slotCount = 0;
+		uint64_t nextSlotId = 1;
+	}
+
+	ThreadSlot::ThreadSlot()
+	{
+		std::unique_lock lock{ slotMutex };
+		if (freeSlots.empty())
+		{
+			index = slotCount++;
+		}
+		else
+		{
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		id = nextSlotId++;
+	}
+
+	ThreadSlot::~ThreadSlot() noexcept
+	{
+		std::unique_lock lock{ slotMutex };
+		freeSlots.push_back(index);
+	}
+
+	void* ThreadSlot::get() const noexcept
+	{
+		if (index >= threadSlots.size() || threadSlots[index].id != id)
+			return nullptr;
+		return threadSlots[index].value;
+	}
+
+	void ThreadSlot::set(void* value)
+	{
+		if (index >= threadSlots.size())
+			threadSlots.resize(index + 1);
+		threadSlots[index] = SlotEntry{ id, value };
+	}
+
+}// namespace vkr
\ No newline at end of file
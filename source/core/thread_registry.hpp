@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vkr
+{
+	// an entry in the thread local table of every thread, the index is reused once the owner is
+	// destroyed and the id never is, so a thread's table only grows with the number of owners
+	// alive at the same time and a new owner never picks up the pointer of a destroyed one
+	class ThreadSlot
+	{
+	public:
+		ThreadSlot();
+		~ThreadSlot() noexcept;
+
+		ThreadSlot(const ThreadSlot&) = delete;
+		ThreadSlot& operator=(const ThreadSlot&) = delete;
+
+		// the calling thread's pointer, nullptr before it set one
+		void* get() const noexcept;
+		void set(void* value);
+
+	private:
+		uint32_t index;
+		uint64_t id;
+	};
+
+	// state of every thread that used the owner, e.g. command or descriptor pools;
+	// lock free after the calling thread's first request
+	template<class T>
+	class ThreadRegistry
+	{
+	public:
+		ThreadRegistry() = default;
+
+		ThreadRegistry(const ThreadRegistry&) = delete;
+		ThreadRegistry& operator=(const ThreadRegistry&) = delete;
+
+		// the calling thread's state, created by create() on its first request
+		template<class F>
+		T& get(F&& create)
+		{
+			if (void* state = slot.get())
+				return *static_cast<T*>(state);
+
+			std::unique_ptr<T> state = create();
+			T& result = *state;
+			{
+				std::unique_lock lock{ mutex };
+				states.push_back(std::move(state));
+			}
+			slot.set(&result);
+			return result;
+		}
+
+		// the state of every thread, threads requesting their first state wait meanwhile
+		template<class F>
+		void forEach(F&& f)
+		{
+			std::unique_lock lock{ mutex };
+			for (auto& state : states)
+			{
+				f(*state);
+			}
+		}
+
+	private:
+		ThreadSlot slot;
+		std::vector<std::unique_ptr<T>> states;
+		std::mutex mutex;
+	};
+
+}// namespace vkr
@@ -0,0 +1,200 @@
+#include "upload_pipeline.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <format>
+
+namespace vkr
+{
+	UploadPipeline::UploadPipeline(Device& device, const Queue& transferQueue, uint32_t dstQueueFamilyIndex,
+		vk::DeviceSize stagingSize, uint32_t ioThreadCount)
+		:device{ &device },
+		transferQueue{ &transferQueue },
+		transferQueueFamilyIndex{ transferQueue.getQueueFamilyIndex() },
+		dstQueueFamilyIndex{ dstQueueFamilyIndex },
+		timelineSemaphore{ createTimelineSemaphore(device) },
+		stagingRing{ device, timelineSemaphore, stagingSize },
+		commandPool{ device, vk::CommandPoolCreateInfo{ vk::CommandPoolCreateFlagBits::eResetCommandBuffer |
+			vk::CommandPoolCreateFlagBits::eTransient, transferQueueFamilyIndex } },
+		ioLoop{ std::max(ioThreadCount, 1u) } {}
+
+	UploadPipeline::~UploadPipeline() noexcept
+	{
+		// no thread may stage or submit once the last submission is waited for
+		ioLoop.join();
+		submitLoop.join();
+		completionLoop.join();
+
+		try
+		{
+			std::unique_lock lock{ mutex };
+			if (stagingRing.getPendingSize() > 0 || !pendingReleases.empty())
+				submitLocked();
+			wait(submittedValue);
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << std::format("Failed to finish uploads: {}\n", e.what());
+		}
+	}
+
+	uint64_t UploadPipeline::recordAcquireBarriers(vk::CommandBuffer commandBuffer)
+	{
+		std::unique_lock lock{ mutex };
+
+		if (pendingAcquires.empty())
+			return 0;
+
+		uint64_t waitValue = 0;
+		std::vector<vk::BufferMemoryBarrier2> barriers;
+		for (const auto& acquire : pendingAcquires)
+		{
+			barriers.push_back(acquire.barrier);
+			waitValue = std::max(waitValue, acquire.timelineValue);
+		}
+		pendingAcquires.clear();
+
+		vk::DependencyInfo dependencyInfo;
+		dependencyInfo.setBufferMemoryBarriers(barriers);
+		commandBuffer.pipelineBarrier2(dependencyInfo, *device->getDispatcher());
+		return waitValue;
+	}
+
+	std::vector<std::byte> UploadPipeline::readFile(const std::filesystem::path& path)
+	{
+		std::ifstream file{ path, std::ios::binary | std::ios::ate };
+
+		if (!file.is_open())
+		{
+			throw std::runtime_error(std::format("Failed to open {}", path.string()));
+		}
+
+		auto fileSize = file.tellg();
+		std::vector<std::byte> buffer(static_cast<size_t>(fileSize));
+		file.seekg(0, std::ios::beg);
+		file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+
+		return buffer;
+	}
+
+	void UploadPipeline::setDeviceCreateInfo(DeviceCreateInfo& createInfo)
+	{
+		createInfo.enabledFeatures12.setTimelineSemaphore(true);
+		createInfo.enabledFeatures13.setSynchronization2(true);
+	}
+
+	uint64_t UploadPipeline::stage(std::vector<std::byte> data, vk::Buffer dstBuffer, vk::DeviceSize dstOffset)
+	{
+		// nothing to copy or to release, a zero sized barrier is invalid
+		if (data.empty())
+		{
+			std::unique_lock lock{ mutex };
+			return submittedValue;
+		}
+
+		// large files go through the ring in chunks, a chunk that would not fit
+		// next to the copies still waiting for submission submits them first
+		vk::DeviceSize chunkSize = stagingRing.getCapacity() / 4;
+
+		std::unique_lock lock{ mutex };
+		for (vk::DeviceSize offset = 0; offset < data.size(); offset += chunkSize)
+		{
+			auto size = std::min<vk::DeviceSize>(chunkSize, data.size() - offset);
+			if (stagingRing.getPendingSize() + size > stagingRing.getCapacity() / 2)
+				submitLocked();
+
+			stagingRing.upload(dstBuffer, dstOffset + offset, std::span{ data }.subspan(offset, size));
+		}
+
+		if (transferQueueFamilyIndex != dstQueueFamilyIndex)
+		{
+			vk::BufferMemoryBarrier2 release;
+			release.setSrcStageMask(vk::PipelineStageFlagBits2::eCopy);
+			release.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+			release.setSrcQueueFamilyIndex(transferQueueFamilyIndex);
+			release.setDstQueueFamilyIndex(dstQueueFamilyIndex);
+			release.setBuffer(dstBuffer);
+			release.setOffset(dstOffset);
+			release.setSize(data.size());
+			pendingReleases.push_back(release);
+		}
+
+		uploadedBytes.fetch_add(data.size(), std::memory_order_relaxed);
+		return submittedValue + 1;
+	}
+
+	uint64_t UploadPipeline::submit(uint64_t stagedValue)
+	{
+		std::unique_lock lock{ mutex };
+
+		// an earlier submission may already contain this upload
+		if (stagedValue <= submittedValue)
+			return stagedValue;
+		return submitLocked();
+	}
+
+	uint64_t UploadPipeline::submitLocked()
+	{
+		auto commandBuffer = getCommandBuffer();
+		commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+		stagingRing.recordCopies(*commandBuffer);
+		if (!pendingReleases.empty())
+		{
+			vk::DependencyInfo dependencyInfo;
+			dependencyInfo.setBufferMemoryBarriers(pendingReleases);
+			commandBuffer.pipelineBarrier2(dependencyInfo);
+		}
+		commandBuffer.end();
+
+		uint64_t timelineValue = submittedValue + 1;
+		vk::CommandBufferSubmitInfo commandBufferInfo{ *commandBuffer };
+		vk::SemaphoreSubmitInfo signalInfo{ *timelineSemaphore, timelineValue, vk::PipelineStageFlagBits2::eAllTransfer };
+		vk::SubmitInfo2 submitInfo;
+		submitInfo.setCommandBufferInfos(commandBufferInfo);
+		submitInfo.setSignalSemaphoreInfos(signalInfo);
+		transferQueue->submit2(submitInfo);
+
+		stagingRing.endFrame(timelineValue);
+		submittedValue = timelineValue;
+		submittedCommandBuffers.push_back(SubmittedCommandBuffer{ timelineValue, std::move(commandBuffer) });
+
+		// the destination queue acquires with the same barrier, only the stages differ
+		for (auto barrier : pendingReleases)
+		{
+			barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eNone);
+			barrier.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+			barrier.setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+			barrier.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite);
+			pendingAcquires.push_back(PendingAcquire{ timelineValue, barrier });
+		}
+		pendingReleases.clear();
+
+		return timelineValue;
+	}
+
+	void UploadPipeline::wait(uint64_t timelineValue) const
+	{
+		vk::Semaphore semaphore = *timelineSemaphore;
+		vk::SemaphoreWaitInfo waitInfo;
+		waitInfo.setSemaphores(semaphore);
+		waitInfo.setValues(timelineValue);
+		if (device->waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+			throw std::runtime_error("Failed to wait for upload");
+	}
+
+	vk::raii::CommandBuffer UploadPipeline::getCommandBuffer()
+	{
+		if (!submittedCommandBuffers.empty()
+			&& submittedCommandBuffers.front().timelineValue <= timelineSemaphore.getCounterValue())
+		{
+			auto commandBuffer = std::move(submittedCommandBuffers.front().commandBuffer);
+			submittedCommandBuffers.pop_front();
+			return commandBuffer;
+		}
+
+		vk::raii::CommandBuffers commandBuffers{ *device,
+			vk::CommandBufferAllocateInfo{ *commandPool, vk::CommandBufferLevel::ePrimary, 1 } };
+		return std::move(commandBuffers.front());
+	}
+
+}// namespace vkr
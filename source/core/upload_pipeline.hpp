@@ -0,0 +1,100 @@
+#pragma once
+
+#include "staging_ring.hpp"
+
+#include <exec/execution.hpp>
+#include <exec/scheduler.hpp>
+
+#include <filesystem>
+#include <deque>
+
+namespace vkr
+{
+	// streams files into device buffers, reading on io threads, copying on a dedicated
+	// transfer queue and releasing the buffers to the destination queue family, so disk
+	// reads, staging copies and gpu copies of different uploads overlap
+	class UploadPipeline
+	{
+	public:
+		// transferQueue must not be used by anyone else while the pipeline is alive
+		UploadPipeline(Device& device, const Queue& transferQueue, uint32_t dstQueueFamilyIndex,
+			vk::DeviceSize stagingSize = 64ull << 20, uint32_t ioThreadCount = 2);
+		// joins the io, submit and completion threads first, uploads that have not been staged
+		// by then are dropped; what is staged is submitted and every submitted copy waited for
+		~UploadPipeline() noexcept;
+
+		UploadPipeline(const UploadPipeline&) = delete;
+		UploadPipeline& operator=(const UploadPipeline&) = delete;
+
+		// completes with the timeline value signaled once the file is in dstBuffer
+		inline auto upload(std::filesystem::path path, vk::Buffer dstBuffer, vk::DeviceSize dstOffset = 0)
+		{
+			return exec::transfer_just(exec::get_scheduler(ioLoop), std::move(path)) |
+				exec::then([this, dstBuffer, dstOffset](std::filesystem::path path)
+					{
+						return stage(readFile(path), dstBuffer, dstOffset);
+					}) |
+				exec::transfer(exec::get_scheduler(submitLoop)) |
+				exec::then([this](uint64_t stagedValue)
+					{
+						return submit(stagedValue);
+					}) |
+				exec::transfer(exec::get_scheduler(completionLoop)) |
+				exec::then([this](uint64_t timelineValue)
+					{
+						wait(timelineValue);
+						return timelineValue;
+					});
+		}
+
+		// records the ownership acquire of every submitted upload, the submission
+		// containing it has to wait on the timeline for the returned value
+		uint64_t recordAcquireBarriers(vk::CommandBuffer commandBuffer);
+
+		inline const vk::raii::Semaphore& getTimelineSemaphore() const noexcept { return timelineSemaphore; }
+		inline uint64_t getUploadedBytes() const noexcept { return uploadedBytes.load(std::memory_order_relaxed); }
+
+		static std::vector<std::byte> readFile(const std::filesystem::path& path);
+
+		static void setDeviceCreateInfo(DeviceCreateInfo& createInfo);
+
+	private:
+		struct SubmittedCommandBuffer
+		{
+			uint64_t timelineValue;
+			vk::raii::CommandBuffer commandBuffer;
+		};
+
+		struct PendingAcquire
+		{
+			uint64_t timelineValue;
+			vk::BufferMemoryBarrier2 barrier;
+		};
+
+		Device* device;
+		const Queue* transferQueue;
+		uint32_t transferQueueFamilyIndex;
+		uint32_t dstQueueFamilyIndex;
+
+		vk::raii::Semaphore timelineSemaphore;
+		StagingRing stagingRing;
+		vk::raii::CommandPool commandPool;
+		std::deque<SubmittedCommandBuffer> submittedCommandBuffers;
+		uint64_t submittedValue = 0;
+		std::vector<vk::BufferMemoryBarrier2> pendingReleases;
+		std::vector<PendingAcquire> pendingAcquires;
+		std::atomic<uint64_t> uploadedBytes = 0;
+		std::mutex mutex;
+
+		exec::thread_run_loop ioLoop;
+		exec::thread_run_loop submitLoop{ 1 };
+		exec::thread_run_loop completionLoop{ 1 };
+
+		uint64_t stage(std::vector<std::byte> data, vk::Buffer dstBuffer, vk::DeviceSize dstOffset);
+		uint64_t submit(uint64_t stagedValue);
+		uint64_t submitLocked();
+		void wait(uint64_t timelineValue) const;
+		vk::raii::CommandBuffer getCommandBuffer();
+	};
+
+}// namespace vkr
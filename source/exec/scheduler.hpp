@@ -3,6 +3,10 @@
 #include <memory>
 #include <queue>
 #include <list>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 #include <condition_variable>
 
 #include "execution.hpp"
@@ -209,6 +213,223 @@ namespace vkr::exec
                 run_loop* env_handle;
             };
 
+            template<typename ... Ts>
+            using bulk_values_ = std::variant<std::monostate, Ts...>;
+
+            // runs the bulk function on every thread of the loop, indices are
+            // handed out through an atomic counter so uneven work still balances
+            template<typename S, typename Shape, typename F, typename R>
+            struct bulk_operation_
+            {
+                struct value_receiver_
+                {
+                    using is_receiver = void;
+
+                    template<typename ... Ts>
+                    friend void tag_invoke(set_value_t, value_receiver_&& self, Ts&& ... args) noexcept
+                    {
+                        try
+                        {
+                            self.op_->values_.template emplace<decayed_tuple<Ts...>>(std::forward<Ts>(args)...);
+                        }
+                        catch(...)
+                        {
+                            set_error(std::move(self.op_->r_), std::current_exception());
+                            return;
+                        }
+                        self.op_->launch();
+                    }
+
+                    template<typename E>
+                    friend void tag_invoke(set_error_t, value_receiver_&& self, E&& e) noexcept
+                    {
+                        set_error(std::move(self.op_->r_), std::forward<E>(e));
+                    }
+
+                    friend void tag_invoke(set_stopped_t, value_receiver_&& self) noexcept
+                    {
+                        set_stopped(std::move(self.op_->r_));
+                    }
+
+                    friend decltype(auto) tag_invoke(get_env_t, const value_receiver_& self) noexcept
+                    {
+                        return get_env(self.op_->r_);
+                    }
+
+                    bulk_operation_* op_;
+                };
+
+                struct worker_receiver_
+                {
+                    using is_receiver = void;
+
+                    template<typename ... Ts>
+                    friend void tag_invoke(set_value_t, worker_receiver_&& self, Ts&& ...) noexcept
+                    {
+                        self.op_->run_worker();
+                    }
+
+                    friend void tag_invoke(set_stopped_t, worker_receiver_&& self) noexcept
+                    {
+                        self.op_->finish_worker();
+                    }
+
+                    bulk_operation_* op_;
+                };
+
+                using values_type = value_types_of_t<S, env_of_t<R>, decayed_tuple, bulk_values_>;
+
+                bulk_operation_(S&& s, R&& r, Shape shape, F&& f, run_loop* loop)
+                    : r_{std::move(r)}, shape_{shape}, f_{std::move(f)}, loop_{loop},
+                    op_{connect(std::move(s), value_receiver_{this})} {}
+
+                bulk_operation_(const bulk_operation_&) = delete;
+                bulk_operation_& operator=(const bulk_operation_&) = delete;
+
+                friend void tag_invoke(start_t, bulk_operation_& self) noexcept
+                {
+                    start(self.op_);
+                }
+
+                void launch() noexcept
+                {
+                    if(shape_ <= 0)
+                    {
+                        complete();
+                        return;
+                    }
+
+                    uint32_t worker_count = static_cast<uint32_t>(std::min<uint64_t>(
+                        static_cast<uint64_t>(shape_), loop_->concurrency_));
+                    remaining_.store(worker_count, std::memory_order_relaxed);
+                    for(uint32_t i = 0; i < worker_count; i++)
+                    {
+                        try
+                        {
+                            loop_->push(worker_receiver_{this});
+                        }
+                        catch(...)
+                        {
+                            record_error(std::current_exception());
+                            // the workers that were never pushed still have to be counted down
+                            for(; i < worker_count; i++)
+                            {
+                                finish_worker();
+                            }
+                            return;
+                        }
+                    }
+                }
+
+                void run_worker() noexcept
+                {
+                    std::visit([this](auto& values)
+                    {
+                        if constexpr(!std::same_as<std::remove_cvref_t<decltype(values)>, std::monostate>)
+                        {
+                            std::apply([this](auto& ... args)
+                            {
+                                for(Shape i = next_index_++; i < shape_; i = next_index_++)
+                                {
+                                    if(failed_.load(std::memory_order_relaxed))
+                                        break;
+
+                                    try
+                                    {
+                                        f_(i, args...);
+                                    }
+                                    catch(...)
+                                    {
+                                        record_error(std::current_exception());
+                                        break;
+                                    }
+                                }
+                            }, values);
+                        }
+                    }, values_);
+                    finish_worker();
+                }
+
+                void record_error(std::exception_ptr eptr) noexcept
+                {
+                    if(!failed_.exchange(true, std::memory_order_relaxed))
+                    {
+                        error_ = std::move(eptr);
+                    }
+                }
+
+                void finish_worker() noexcept
+                {
+                    if(remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        complete();
+                    }
+                }
+
+                void complete() noexcept
+                {
+                    if(failed_.load(std::memory_order_relaxed))
+                    {
+                        set_error(std::move(r_), std::move(error_));
+                        return;
+                    }
+
+                    std::visit([this](auto& values)
+                    {
+                        if constexpr(!std::same_as<std::remove_cvref_t<decltype(values)>, std::monostate>)
+                        {
+                            std::apply([this](auto& ... args)
+                            {
+                                set_value(std::move(r_), std::move(args)...);
+                            }, values);
+                        }
+                    }, values_);
+                }
+
+                R r_;
+                Shape shape_;
+                F f_;
+                run_loop* loop_;
+                values_type values_;
+                std::atomic<Shape> next_index_{0};
+                std::atomic<uint32_t> remaining_{0};
+                std::atomic<bool> failed_{false};
+                std::exception_ptr error_;
+                connect_result_t<S, value_receiver_> op_;
+            };
+
+            template<typename S, typename Shape, typename F>
+            struct bulk_sender_
+            {
+                using is_sender = void;
+
+                template<decays_to<bulk_sender_> Self, typename Env>
+                friend consteval auto tag_invoke(get_completion_signatures_t, Self&&, Env&&) noexcept
+                    -> make_completion_signatures<S, Env,
+                        exec::completion_signatures<set_error_t(std::exception_ptr)>>
+                {
+                    return {};
+                }
+
+                template<decays_to<bulk_sender_> Self, receiver R>
+                friend auto tag_invoke(connect_t, Self&& self, R&& r)
+                    -> bulk_operation_<S, Shape, F, std::remove_cvref_t<R>>
+                {
+                    return {S{std::forward<Self>(self).s_}, std::remove_cvref_t<R>{std::forward<R>(r)},
+                        self.shape_, F{std::forward<Self>(self).f_}, self.env_handle};
+                }
+
+                friend auto& tag_invoke(get_env_t, const bulk_sender_& self) noexcept
+                {
+                    return *(self.env_handle);
+                }
+
+                S s_;
+                Shape shape_;
+                F f_;
+                run_loop* env_handle;
+            };
+
             struct scheduler_
             {
                 friend sender_ tag_invoke(schedule_t, const scheduler_& self) noexcept
@@ -216,6 +437,14 @@ namespace vkr::exec
                     return {self.env_handle};
                 }
 
+                template<sender S, std::integral Shape, movable_value F>
+                friend auto tag_invoke(bulk_t, const scheduler_& self, S&& s, Shape shape, F&& f)
+                    noexcept(nothrow_movable_value<S> && nothrow_movable_value<F>)
+                    -> bulk_sender_<std::remove_cvref_t<S>, Shape, std::decay_t<F>>
+                {
+                    return {std::forward<S>(s), shape, std::forward<F>(f), self.env_handle};
+                }
+
                 bool operator==(const scheduler_& other) const
                 {
                     return this->env_handle == other.env_handle;
@@ -236,6 +465,8 @@ namespace vkr::exec
             }
 
         protected:
+            // number of threads running the loop, bounds how far bulk fans out
+            uint32_t concurrency_ = 1;
             bool finished = false;
             std::queue<move_only_operation<Args...>, std::list<move_only_operation<Args...>>> operations_;
             mutable std::mutex mutex_{};
@@ -248,6 +479,7 @@ namespace vkr::exec
             thread_run_loop() = default;
             explicit thread_run_loop(uint32_t threadCount)
             {
+                concurrency_ = std::max(threadCount, 1u);
                 threads.resize(threadCount);
                 for(uint32_t i = 0; i < threadCount; i++)
                 {
@@ -257,8 +489,16 @@ namespace vkr::exec
                 }
             }
             ~thread_run_loop() noexcept
+            {
+                join();
+            }
+
+            // finishes the loop and waits until its threads return, the operations
+            // they are running complete and the queued ones are dropped
+            void join() noexcept
             {
                 finish();
+                threads.clear();
             }
 
         private:
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "execution.hpp"
+
+#include <exception>
+#include <latch>
+#include <optional>
+#include <type_traits>
+#include <variant>
+
+namespace vkr::exec
+{
+    namespace sender_consumers
+    {
+        // counts down a latch on any completion and keeps the value or the error for the waiting thread
+        template<typename T>
+        struct latch_receiver
+        {
+            struct is_receiver {};
+
+            friend void tag_invoke(set_value_t, latch_receiver&& self, T value) noexcept
+            {
+                self.result->emplace(std::move(value));
+                self.latch->count_down();
+            }
+
+            friend void tag_invoke(set_error_t, latch_receiver&& self, std::exception_ptr eptr) noexcept
+            {
+                *self.error = eptr;
+                self.latch->count_down();
+            }
+
+            friend void tag_invoke(set_stopped_t, latch_receiver&& self) noexcept
+            {
+                self.latch->count_down();
+            }
+
+            std::optional<T>* result;
+            std::exception_ptr* error;
+            std::latch* latch;
+        };
+
+        template<>
+        struct latch_receiver<void>
+        {
+            struct is_receiver {};
+
+            friend void tag_invoke(set_value_t, latch_receiver&& self) noexcept
+            {
+                self.latch->count_down();
+            }
+
+            friend void tag_invoke(set_error_t, latch_receiver&& self, std::exception_ptr eptr) noexcept
+            {
+                *self.error = eptr;
+                self.latch->count_down();
+            }
+
+            friend void tag_invoke(set_stopped_t, latch_receiver&& self) noexcept
+            {
+                self.latch->count_down();
+            }
+
+            std::optional<std::monostate>* result;
+            std::exception_ptr* error;
+            std::latch* latch;
+        };
+
+        // blocks the calling thread until the sender completes, rethrows its error;
+        // T is the single value the sender completes with, void if it completes with none
+        template<typename T = void, typename S>
+        T sync_wait(S&& sender)
+        {
+            using value_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+            std::optional<value_type> result;
+            std::exception_ptr error;
+            std::latch latch{1};
+            auto operation = connect(std::forward<S>(sender), latch_receiver<T>{&result, &error, &latch});
+            start(operation);
+            latch.wait();
+            if(error)
+                std::rethrow_exception(error);
+            if constexpr(!std::is_void_v<T>)
+                return std::move(result).value();
+        }
+
+    }// namespace sender_consumers
+
+    using sender_consumers::latch_receiver;
+    using sender_consumers::sync_wait;
+
+}// namespace vkr::exec
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <core/core.hpp>
+
+#include <cstdint>
+
+// records frames 1 to frameCount with framesInFlight command pool slots: every frame gets one
+// pooled command buffer, record(frame, commandBuffer) fills it between begin and end and the
+// submit signals the frame number on the timeline the pools wait on before reusing a slot
+template<typename F>
+void runFrames(const vkr::Device& device, const vkr::Queue& queue, uint32_t framesInFlight, uint64_t frameCount, F&& record)
+{
+	vkr::CommandPoolManager commandPools{ device, framesInFlight };
+	auto timeline = vkr::createTimelineSemaphore(device);
+
+	for (uint64_t frame = 1; frame <= frameCount; frame++)
+	{
+		commandPools.beginFrame(timeline);
+
+		vk::raii::CommandBuffer commandBuffer{ device,
+			static_cast<VkCommandBuffer>(commandPools.acquire(queue.getQueueFamilyIndex())), VK_NULL_HANDLE };
+		commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+		record(frame, commandBuffer);
+		commandBuffer.end();
+
+		vk::CommandBufferSubmitInfo commandBufferInfo{ *commandBuffer };
+		vk::SemaphoreSubmitInfo signalInfo{ *timeline, frame, vk::PipelineStageFlagBits2::eAllCommands };
+		vk::SubmitInfo2 submitInfo;
+		submitInfo.setCommandBufferInfos(commandBufferInfo);
+		submitInfo.setSignalSemaphoreInfos(signalInfo);
+		queue.submit2(submitInfo);
+		commandPools.endFrame(frame);
+
+		// the pool owns the command buffer
+		static_cast<void>(commandBuffer.release());
+	}
+
+	device.waitIdle();
+}
@@ -0,0 +1,87 @@
+#include <core/core.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+TEST_CASE("slot allocator hands out every slot once")
+{
+	vkr::SlotAllocator slots{ 4 };
+
+	for (uint32_t slot = 0; slot < 4; slot++)
+	{
+		REQUIRE(slots.allocate() == slot);
+	}
+	REQUIRE_FALSE(slots.allocate());
+	REQUIRE(slots.getUsedCount() == 4);
+}
+
+TEST_CASE("slot allocator reuses the most recently freed slot first")
+{
+	vkr::SlotAllocator slots{ 4 };
+	for (uint32_t slot = 0; slot < 4; slot++)
+	{
+		slots.allocate();
+	}
+
+	slots.free(2);
+	slots.free(0);
+	REQUIRE(slots.getUsedCount() == 2);
+	REQUIRE(slots.allocate() == 0);
+	REQUIRE(slots.allocate() == 2);
+	REQUIRE_FALSE(slots.allocate());
+}
+
+TEST_CASE("slot allocator never hands a slot to two threads")
+{
+	constexpr uint32_t ThreadCount = 16;
+	constexpr uint32_t HeldSlotCount = 48;
+	constexpr uint32_t IterationCount = 100000;
+
+	// fewer slots than threads can hold, so allocation also fails under contention
+	vkr::SlotAllocator slots{ 512 };
+	std::vector<std::atomic<bool>> owned(slots.getCapacity());
+	std::atomic<uint32_t> doubleAllocations = 0;
+
+	{
+		std::vector<std::jthread> threads;
+		for (uint32_t thread = 0; thread < ThreadCount; thread++)
+		{
+			threads.emplace_back([&]
+				{
+					std::vector<uint32_t> held;
+					for (uint32_t index = 0; index < IterationCount; index++)
+					{
+						if (held.size() < HeldSlotCount && index % 3 != 0)
+						{
+							if (auto slot = slots.allocate())
+							{
+								if (owned[*slot].exchange(true))
+									doubleAllocations++;
+								held.push_back(*slot);
+							}
+						}
+						else if (!held.empty())
+						{
+							owned[held.back()].store(false);
+							slots.free(held.back());
+							held.pop_back();
+						}
+					}
+					for (auto slot : held)
+					{
+						owned[slot].store(false);
+						slots.free(slot);
+					}
+				});
+		}
+	}
+
+	REQUIRE(doubleAllocations == 0);
+	REQUIRE(slots.getUsedCount() == 0);
+	for (uint32_t slot = 0; slot < slots.getCapacity(); slot++)
+	{
+		REQUIRE(slots.allocate());
+	}
+	REQUIRE_FALSE(slots.allocate());
+}
@@ -0,0 +1,118 @@
+#include <core/core.hpp>
+#include <exec/scheduler.hpp>
+#include <exec/sync_wait.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <future>
+#include <optional>
+
+namespace
+{
+	// records an empty command buffer, the pool owns it
+	void recordEmpty(const vkr::Device& device, vk::CommandBuffer commandBuffer)
+	{
+		vk::raii::CommandBuffer raiiCommandBuffer{ device, static_cast<VkCommandBuffer>(commandBuffer), VK_NULL_HANDLE };
+		raiiCommandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+		raiiCommandBuffer.end();
+		static_cast<void>(raiiCommandBuffer.release());
+	}
+}
+
+TEST_CASE("command pools of a frame slot are reset only after the slot retired")
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::CommandPoolManager, vkr::SubmitBatcher>(physicalDevice);
+	const auto& queue = device.getQueueFamilies()[0][0];
+	auto queueFamilyIndex = queue.getQueueFamilyIndex();
+
+	auto timeline = vkr::createTimelineSemaphore(device);
+	// the first frame's submission cannot complete before the host signals the gate
+	auto gate = vkr::createTimelineSemaphore(device);
+	vkr::CommandPoolManager commandPools{ device, 2 };
+
+	commandPools.beginFrame(timeline);
+	auto first = commandPools.acquire(queueFamilyIndex);
+	recordEmpty(device, first);
+
+	vk::CommandBufferSubmitInfo commandBufferInfo{ first };
+	vk::SemaphoreSubmitInfo waitInfo{ *gate, 1, vk::PipelineStageFlagBits2::eAllCommands };
+	vk::SemaphoreSubmitInfo signalInfo{ *timeline, 1, vk::PipelineStageFlagBits2::eAllCommands };
+	vk::SubmitInfo2 submitInfo;
+	submitInfo.setWaitSemaphoreInfos(waitInfo);
+	submitInfo.setCommandBufferInfos(commandBufferInfo);
+	submitInfo.setSignalSemaphoreInfos(signalInfo);
+	queue.submit2(submitInfo);
+	commandPools.endFrame(1);
+
+	// the other slot has nothing in flight
+	commandPools.beginFrame(timeline);
+	auto firstFrameIndex = commandPools.getFrameIndex();
+
+	// back at the first frame's slot, which is still executing
+	auto nextFrame = std::async(std::launch::async, [&]{ commandPools.beginFrame(timeline); });
+	REQUIRE(nextFrame.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+	REQUIRE(commandPools.getFrameIndex() == firstFrameIndex);
+
+	device.signalSemaphore(vk::SemaphoreSignalInfo{ *gate, 1 });
+	nextFrame.get();
+	REQUIRE(timeline.getCounterValue() >= 1);
+
+	// the reset pool hands out the same command buffer again
+	REQUIRE(commandPools.acquire(queueFamilyIndex) == first);
+}
+
+TEST_CASE("every thread acquires from its own command pools")
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::CommandPoolManager>(physicalDevice);
+	auto queueFamilyIndex = device.getQueueFamilies()[0].getQueueFamilyIndex();
+
+	auto timeline = vkr::createTimelineSemaphore(device);
+	vkr::CommandPoolManager commandPools{ device, 2 };
+
+	vkr::exec::thread_run_loop firstThread{ 1 };
+	vkr::exec::thread_run_loop secondThread{ 1 };
+	auto acquireOn = [&](vkr::exec::thread_run_loop& thread)
+		{
+			return vkr::exec::sync_wait<vk::CommandBuffer>(vkr::exec::schedule(vkr::exec::get_scheduler(thread)) |
+				vkr::exec::then([&]{ return commandPools.acquire(queueFamilyIndex); }));
+		};
+
+	auto first = acquireOn(firstThread);
+	auto second = acquireOn(secondThread);
+	REQUIRE(first != second);
+
+	// in the same slot again the second thread asks first and still gets its own buffer
+	commandPools.beginFrame(timeline);
+	commandPools.beginFrame(timeline);
+	REQUIRE(acquireOn(secondThread) == second);
+	REQUIRE(acquireOn(firstThread) == first);
+}
+
+TEST_CASE("command pool managers never share pools")
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::CommandPoolManager>(physicalDevice);
+	auto queueFamilyIndex = device.getQueueFamilies()[0].getQueueFamilyIndex();
+
+	auto timeline = vkr::createTimelineSemaphore(device);
+	std::optional<vkr::CommandPoolManager> firstPools{ std::in_place, device, 1 };
+	vkr::CommandPoolManager secondPools{ device, 1 };
+
+	auto first = firstPools->acquire(queueFamilyIndex);
+	auto second = secondPools.acquire(queueFamilyIndex);
+	REQUIRE(first != second);
+
+	// the replacement reuses the destroyed manager's thread slot and address, not its pools
+	firstPools.emplace(device, 1);
+	auto third = firstPools->acquire(queueFamilyIndex);
+	REQUIRE(third != second);
+
+	secondPools.beginFrame(timeline);
+	REQUIRE(secondPools.acquire(queueFamilyIndex) == second);
+}
@@ -0,0 +1,59 @@
+#include <core/core.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <format>
+
+constexpr uint32_t FrameCount = 8;
+constexpr uint32_t FramesInFlight = 2;
+constexpr uint32_t SetsPerFrame = 100000;
+
+int main()
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::DescriptorAllocator>(physicalDevice);
+
+	vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> semaphoreCreateInfo{
+		{}, vk::SemaphoreTypeCreateInfo{ vk::SemaphoreType::eTimeline, 0 } };
+	vk::raii::Semaphore timelineSemaphore{ device, semaphoreCreateInfo.get<vk::SemaphoreCreateInfo>() };
+
+	vkr::DescriptorLayoutCache layoutCache{ device };
+	std::array bindings{
+		vk::DescriptorSetLayoutBinding{ 0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eAll },
+		vk::DescriptorSetLayoutBinding{ 1, vk::DescriptorType::eCombinedImageSampler, 2, vk::ShaderStageFlagBits::eFragment },
+	};
+	std::array reorderedBindings{ bindings[1], bindings[0] };
+	const auto& layout = layoutCache.getLayout(bindings);
+	if (&layoutCache.getLayout(reorderedBindings) != &layout || layoutCache.size() != 1)
+	{
+		std::cout << "layout cache created a duplicate layout\n";
+		return 1;
+	}
+
+	vkr::DescriptorAllocator allocator{ device, FramesInFlight };
+	uint64_t timelineValue = 0;
+	for (uint32_t frame = 0; frame < FrameCount; frame++)
+	{
+		allocator.beginFrame(timelineSemaphore);
+		uint64_t poolCount = allocator.getCreatedPoolCount();
+
+		auto begin = std::chrono::steady_clock::now();
+		for (uint32_t index = 0; index < SetsPerFrame; index++)
+		{
+			allocator.allocate(layout);
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		// nothing is recorded, the host retires the frame itself
+		allocator.endFrame(++timelineValue);
+		device.signalSemaphore(vk::SemaphoreSignalInfo{ *timelineSemaphore, timelineValue });
+
+		double milliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+		std::cout << std::format("frame {}: {} sets in {:.2f} ms ({:.0f} ns per set), {} new pools\n",
+			frame, SetsPerFrame, milliseconds, milliseconds * 1e6 / SetsPerFrame,
+			allocator.getCreatedPoolCount() - poolCount);
+	}
+
+	device.waitIdle();
+}
@@ -1,5 +1,6 @@
 #include <exec/execution.hpp>
 #include <exec/scheduler.hpp>
+#include <exec/sync_wait.hpp>
 
 #include <iostream>
 #include <span>
@@ -250,6 +251,23 @@ int main()
     vkr::exec::operation_state auto bulk_op = vkr::exec::connect(bulk_sender, TestReceiver{});
     vkr::exec::start(bulk_op);
 
+    std::vector<std::atomic<uint32_t>> parallel_bulk_counts(256);
+    vkr::exec::sender auto parallel_bulk_sender =
+        vkr::exec::schedule(vkr::exec::get_scheduler(test_loop_1)) |
+        vkr::exec::bulk(parallel_bulk_counts.size(), [&](size_t n)
+        {
+            std::this_thread::sleep_for(100us);
+            parallel_bulk_counts[n]++;
+        }) |
+        vkr::exec::then([&]
+        {
+            bool all_once = std::ranges::all_of(parallel_bulk_counts, [](auto& count){ return count == 1; });
+            std::cout << "parallel bulk on " << std::this_thread::get_id() << ", every index once: " << all_once << '\n';
+        });
+    vkr::exec::operation_state auto parallel_bulk_op = vkr::exec::connect(parallel_bulk_sender, TestReceiver{});
+    vkr::exec::start(parallel_bulk_op);
+    std::this_thread::sleep_for(100ms);
+
     vkr::exec::sender auto into_variant_sender = 
         vkr::exec::just(42) |
         vkr::exec::into_variant() |
@@ -278,4 +296,23 @@ int main()
         vkr::exec::stopped_as_error("logic error");
     vkr::exec::operation_state auto stopped_as_error_op = vkr::exec::connect(stopped_as_error_sender, TestReceiver{});
     vkr::exec::start(stopped_as_error_op);
+
+    vkr::exec::thread_run_loop sync_wait_loop{2};
+    int sync_wait_value = vkr::exec::sync_wait<int>(
+        vkr::exec::schedule(vkr::exec::get_scheduler(sync_wait_loop)) |
+        vkr::exec::then([]{ return 42; }));
+    std::cout << "sync_wait value " << sync_wait_value << '\n';
+    vkr::exec::sync_wait(
+        vkr::exec::schedule(vkr::exec::get_scheduler(sync_wait_loop)) |
+        vkr::exec::bulk(4, [](uint32_t){}));
+    try
+    {
+        vkr::exec::sync_wait(
+            vkr::exec::schedule(vkr::exec::get_scheduler(sync_wait_loop)) |
+            vkr::exec::then([]{ throw std::runtime_error("sync_wait error"); }));
+    }
+    catch(const std::exception& e)
+    {
+        std::cout << "sync_wait rethrew " << e.what() << '\n';
+    }
 }
\ No newline at end of file
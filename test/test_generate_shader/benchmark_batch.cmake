@@ -0,0 +1,64 @@
+# compares regenerating the headers of 500 shaders with one generate_shader process per shader
+# and with one batch run over a manifest, first from scratch and then with nothing changed,
+# run with cmake -DGENERATE_SHADER=... -DGLSL_COMPILER=... -DWORK_DIR=... -P benchmark_batch.cmake
+set(SHADER_COUNT 500)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/spv ${WORK_DIR}/single ${WORK_DIR}/batch)
+
+# every copy reflects the same descriptors, inputs and push constants, the name differs
+file(WRITE ${WORK_DIR}/benchmark.frag "#version 450
+struct Light { vec4 position; vec4 color; };
+layout(set = 0, binding = 0) uniform Camera { mat4 view; mat4 projection; vec4 position; } camera;
+layout(set = 0, binding = 1) readonly buffer Lights { Light lights[]; };
+layout(set = 1, binding = 0) uniform sampler2D albedo;
+layout(push_constant) uniform Constants { mat4 model; uint lightCount; } constants;
+layout(location = 0) in vec3 normal;
+layout(location = 1) in vec2 uv;
+layout(location = 0) out vec4 color;
+void main()
+{
+	vec3 light = vec3(0.0);
+	for (uint index = 0; index < constants.lightCount; index++)
+		light += lights[index].color.rgb * max(dot(normal, normalize(lights[index].position.xyz - camera.position.xyz)), 0.0);
+	color = texture(albedo, uv) * vec4(light, 1.0);
+}
+")
+execute_process(COMMAND ${GLSL_COMPILER} -V100 -o ${WORK_DIR}/benchmark.frag.spv ${WORK_DIR}/benchmark.frag
+	COMMAND_ERROR_IS_FATAL ANY OUTPUT_QUIET)
+
+set(MANIFEST "")
+math(EXPR LAST_SHADER "${SHADER_COUNT} - 1")
+foreach(INDEX RANGE ${LAST_SHADER})
+	file(COPY_FILE ${WORK_DIR}/benchmark.frag.spv ${WORK_DIR}/spv/shader${INDEX}.frag.spv)
+	string(APPEND MANIFEST "${WORK_DIR}/spv/shader${INDEX}.frag.spv;${WORK_DIR}/batch/shader${INDEX}_frag.hpp\n")
+endforeach()
+file(WRITE ${WORK_DIR}/manifest.txt "${MANIFEST}")
+
+function(measure_milliseconds RESULT)
+	string(TIMESTAMP BEGIN "%s%f")
+	execute_process(${ARGN} COMMAND_ERROR_IS_FATAL ANY OUTPUT_QUIET)
+	string(TIMESTAMP END "%s%f")
+	math(EXPR ELAPSED "(${END} - ${BEGIN}) / 1000")
+	set(${RESULT} ${ELAPSED} PARENT_SCOPE)
+endfunction()
+
+string(TIMESTAMP BEGIN "%s%f")
+foreach(INDEX RANGE ${LAST_SHADER})
+	execute_process(COMMAND ${GENERATE_SHADER} ${WORK_DIR}/spv/shader${INDEX}.frag.spv
+		${WORK_DIR}/single/shader${INDEX}_frag.hpp COMMAND_ERROR_IS_FATAL ANY OUTPUT_QUIET)
+endforeach()
+string(TIMESTAMP END "%s%f")
+math(EXPR SINGLE_TIME "(${END} - ${BEGIN}) / 1000")
+
+measure_milliseconds(BATCH_TIME COMMAND ${GENERATE_SHADER} --manifest ${WORK_DIR}/manifest.txt)
+file(TIMESTAMP ${WORK_DIR}/batch/shader0_frag.hpp FIRST_TIMESTAMP "%s%f")
+measure_milliseconds(UNCHANGED_TIME COMMAND ${GENERATE_SHADER} --manifest ${WORK_DIR}/manifest.txt)
+file(TIMESTAMP ${WORK_DIR}/batch/shader0_frag.hpp SECOND_TIMESTAMP "%s%f")
+if(NOT FIRST_TIMESTAMP STREQUAL SECOND_TIMESTAMP)
+	message(FATAL_ERROR "An unchanged header was written again")
+endif()
+measure_milliseconds(SERIAL_TIME COMMAND ${GENERATE_SHADER} --manifest ${WORK_DIR}/manifest.txt --jobs 1)
+
+message(STATUS "${SHADER_COUNT} shaders, one process each: ${SINGLE_TIME} ms")
+message(STATUS "batch: ${BATCH_TIME} ms from scratch, ${UNCHANGED_TIME} ms unchanged, ${SERIAL_TIME} ms unchanged on one thread")
@@ -0,0 +1,64 @@
+# compares the build time of a ~1 MB SPIR-V shader embedded as a hex array and through .incbin,
+# run with cmake -DGENERATE_SHADER=... -DGLSL_COMPILER=... -DCXX_COMPILER=... -DGLM_INCLUDE_DIR=...
+#   -DWORK_DIR=... -P benchmark_embedding.cmake
+set(CONSTANT_COUNT 60000)
+set(INCLUDE_COUNT 8)
+
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+# every distinct constant becomes its own OpConstant, which is what makes the module large
+set(CONSTANTS "")
+math(EXPR LAST_CONSTANT "${CONSTANT_COUNT} - 1")
+foreach(INDEX RANGE ${LAST_CONSTANT})
+	string(APPEND CONSTANTS "${INDEX}u,")
+endforeach()
+string(REGEX REPLACE ",$" "" CONSTANTS "${CONSTANTS}")
+file(WRITE ${WORK_DIR}/large.comp "#version 450
+layout(local_size_x = 64) in;
+layout(std430, binding = 0) buffer Data { uint values[]; };
+const uint Table[${CONSTANT_COUNT}] = uint[](${CONSTANTS});
+void main() { values[gl_GlobalInvocationID.x] = Table[gl_GlobalInvocationID.x % ${CONSTANT_COUNT}]; }
+")
+
+execute_process(COMMAND ${GLSL_COMPILER} -V100 -o ${WORK_DIR}/large.comp.spv ${WORK_DIR}/large.comp
+	COMMAND_ERROR_IS_FATAL ANY OUTPUT_QUIET)
+file(SIZE ${WORK_DIR}/large.comp.spv SPIRV_SIZE)
+
+function(measure_milliseconds RESULT)
+	string(TIMESTAMP BEGIN "%s%f")
+	execute_process(${ARGN} COMMAND_ERROR_IS_FATAL ANY)
+	string(TIMESTAMP END "%s%f")
+	math(EXPR ELAPSED "(${END} - ${BEGIN}) / 1000")
+	set(${RESULT} ${ELAPSED} PARENT_SCOPE)
+endfunction()
+
+# several translation units include the header, as they would in a renderer
+function(compile_includes MODE RESULT)
+	set(OBJECTS_TIME 0)
+	foreach(INDEX RANGE 1 ${INCLUDE_COUNT})
+		file(WRITE ${WORK_DIR}/${MODE}/include${INDEX}.cpp
+			"#include <large_comp.hpp>\nunsigned int read${INDEX}() { return ShaderData::large_comp::code[${INDEX}]; }\n")
+		measure_milliseconds(TIME COMMAND ${CXX_COMPILER} -std=c++20 -I${WORK_DIR}/${MODE} -I${GLM_INCLUDE_DIR}
+			-c ${WORK_DIR}/${MODE}/include${INDEX}.cpp -o ${WORK_DIR}/${MODE}/include${INDEX}.o)
+		math(EXPR OBJECTS_TIME "${OBJECTS_TIME} + ${TIME}")
+	endforeach()
+	set(${RESULT} ${OBJECTS_TIME} PARENT_SCOPE)
+endfunction()
+
+file(MAKE_DIRECTORY ${WORK_DIR}/array ${WORK_DIR}/embed)
+measure_milliseconds(ARRAY_GENERATE_TIME COMMAND ${GENERATE_SHADER}
+	${WORK_DIR}/large.comp.spv ${WORK_DIR}/array/large_comp.hpp)
+compile_includes(array ARRAY_COMPILE_TIME)
+file(SIZE ${WORK_DIR}/array/large_comp.hpp ARRAY_HEADER_SIZE)
+
+measure_milliseconds(EMBED_GENERATE_TIME COMMAND ${GENERATE_SHADER} --embed ${WORK_DIR}/embed/large_comp.cpp
+	${WORK_DIR}/large.comp.spv ${WORK_DIR}/embed/large_comp.hpp)
+measure_milliseconds(EMBED_OBJECT_TIME COMMAND ${CXX_COMPILER} -c ${WORK_DIR}/embed/large_comp.cpp
+	-o ${WORK_DIR}/embed/large_comp.o)
+compile_includes(embed EMBED_COMPILE_TIME)
+file(SIZE ${WORK_DIR}/embed/large_comp.hpp EMBED_HEADER_SIZE)
+
+message(STATUS "SPIR-V module: ${SPIRV_SIZE} bytes, included by ${INCLUDE_COUNT} translation units")
+message(STATUS "hex array: ${ARRAY_HEADER_SIZE} byte header, generate ${ARRAY_GENERATE_TIME} ms, compile ${ARRAY_COMPILE_TIME} ms")
+message(STATUS ".incbin: ${EMBED_HEADER_SIZE} byte header, generate ${EMBED_GENERATE_TIME} ms, "
+	"compile ${EMBED_COMPILE_TIME} ms + ${EMBED_OBJECT_TIME} ms for the blob object")
@@ -0,0 +1,43 @@
+# compares reflecting a library of 200 shaders read into vectors, which SPIRV-Reflect copies
+# again, with memory mapping them and reflecting in place, for time and peak resident size,
+# run with cmake -DBENCHMARK_REFLECTION=... -DGLSL_COMPILER=... -DWORK_DIR=... -P benchmark_reflection.cmake
+set(SHADER_COUNT 200)
+set(CONSTANT_COUNT 4000)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/spv)
+
+# the table makes every module about 100 KB, so the code and not the reflection data dominates
+set(CONSTANTS "")
+math(EXPR LAST_CONSTANT "${CONSTANT_COUNT} - 1")
+foreach(INDEX RANGE ${LAST_CONSTANT})
+	string(APPEND CONSTANTS "${INDEX}u,")
+endforeach()
+string(REGEX REPLACE ",$" "" CONSTANTS "${CONSTANTS}")
+file(WRITE ${WORK_DIR}/benchmark.frag "#version 450
+layout(set = 0, binding = 0) uniform Camera { mat4 view; mat4 projection; vec4 position; } camera;
+layout(set = 0, binding = 1) readonly buffer Lights { vec4 lights[]; };
+layout(set = 1, binding = 0) uniform sampler2D albedo;
+layout(push_constant) uniform Constants { mat4 model; uint lightCount; } constants;
+layout(location = 0) in vec2 uv;
+layout(location = 0) out vec4 color;
+const uint Table[${CONSTANT_COUNT}] = uint[](${CONSTANTS});
+void main()
+{
+	uint index = Table[uint(gl_FragCoord.x) % ${CONSTANT_COUNT}] % constants.lightCount;
+	color = texture(albedo, uv) * lights[index] * camera.position.w;
+}
+")
+execute_process(COMMAND ${GLSL_COMPILER} -V100 -o ${WORK_DIR}/benchmark.frag.spv ${WORK_DIR}/benchmark.frag
+	COMMAND_ERROR_IS_FATAL ANY OUTPUT_QUIET)
+
+math(EXPR LAST_SHADER "${SHADER_COUNT} - 1")
+foreach(INDEX RANGE ${LAST_SHADER})
+	file(COPY_FILE ${WORK_DIR}/benchmark.frag.spv ${WORK_DIR}/spv/shader${INDEX}.frag.spv)
+endforeach()
+
+foreach(MODE copy map)
+	execute_process(COMMAND ${BENCHMARK_REFLECTION} ${MODE} ${WORK_DIR}/spv
+		COMMAND_ERROR_IS_FATAL ANY OUTPUT_VARIABLE RESULT OUTPUT_STRIP_TRAILING_WHITESPACE)
+	message(STATUS "${RESULT}")
+endforeach()
@@ -0,0 +1,115 @@
+// reflects every SPIR-V file of a directory and keeps the modules alive like a runtime shader
+// library, either read into vectors that SPIRV-Reflect copies again or memory mapped and
+// reflected in place, run once per process so the peak resident size belongs to one mode:
+// benchmark_reflection copy|map [spirv_directory]
+#include <spirv_reflect_wrapper.hpp>
+#include <core/spirv_file.hpp>
+
+#include <vector>
+#include <fstream>
+#include <string>
+#include <iostream>
+#include <format>
+#include <filesystem>
+#include <chrono>
+#include <memory>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+size_t getPeakResidentKilobytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+std::vector<uint32_t> readSpirv(const std::filesystem::path& path)
+{
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if(!file.is_open())
+    {
+        throw std::runtime_error(std::format("Failed to open {}", path.string()));
+    }
+
+    auto filesize = file.tellg();
+    std::vector<uint32_t> buffer(filesize/4);
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(buffer.data()), filesize);
+    return buffer;
+}
+
+int main(int argc, char** argv)
+{
+    std::string mode = argc == 3 ? argv[1] : "";
+    if(mode != "copy" && mode != "map")
+    {
+        std::cout << "Usage: benchmark_reflection copy|map [spirv_directory]";
+        return -1;
+    }
+
+    std::vector<std::filesystem::path> paths;
+    for(const auto& entry : std::filesystem::directory_iterator{argv[2]})
+    {
+        if(entry.path().extension() == ".spv")
+            paths.push_back(entry.path());
+    }
+
+    try {
+        size_t baseline = getPeakResidentKilobytes();
+        auto begin = std::chrono::steady_clock::now();
+
+        // the code outlives its module in both modes, as it does in generate_shader
+        std::vector<std::vector<uint32_t>> copies;
+        std::vector<vkr::SpirvFile> files;
+        std::vector<std::unique_ptr<spv_reflect_wrapper::SpvReflectShaderModule>> modules;
+        size_t codeSize = 0;
+        size_t bindingCount = 0;
+        for(const auto& path : paths)
+        {
+            if(mode == "copy")
+            {
+                auto& code = copies.emplace_back(readSpirv(path));
+                modules.push_back(std::make_unique<spv_reflect_wrapper::SpvReflectShaderModule>(code));
+                codeSize += code.size() * sizeof(uint32_t);
+            }
+            else
+            {
+                auto& file = files.emplace_back(path);
+                modules.push_back(std::make_unique<spv_reflect_wrapper::SpvReflectShaderModule>(file, SPV_REFLECT_MODULE_FLAG_NO_COPY));
+                codeSize += file.size() * sizeof(uint32_t);
+            }
+
+            for(auto* set : modules.back()->enumerateDescriptorSets())
+            {
+                bindingCount += set->binding_count;
+            }
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        std::cout << std::format("{}: {} shaders, {} KiB of SPIR-V, {} bindings in {} ms, peak resident {} KiB ({} KiB above start)\n",
+            mode, paths.size(), codeSize / 1024, bindingCount,
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count(),
+            getPeakResidentKilobytes(), getPeakResidentKilobytes() - baseline);
+    } catch (const std::exception& e) {
+        std::cout << e.what();
+        return -1;
+    }
+    return 0;
+}
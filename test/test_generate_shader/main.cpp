@@ -1,7 +1,66 @@
 #include <triangle_vert.hpp>
 #include <triangle_frag.hpp>
+#include <layout_comp.hpp>
+#include <material_frag_variants.hpp>
+#include <triangle_frag_variants.hpp>
+
+#include <cstring>
+
+using Scene = ShaderData::layout_comp::Descriptor::Scene;
+using Particles = ShaderData::layout_comp::Descriptor::Particles;
+
+// std140 offsets of layout.comp, a vec3 packs a float behind it and array elements are 16 bytes
+static_assert(offsetof(Scene, exposure) == 12);
+static_assert(offsetof(Scene, fogColor) == 16);
+static_assert(offsetof(Scene, normalMatrix) == 32);
+static_assert(sizeof(Scene::weights[0]) == 16);
+static_assert(offsetof(Scene, lights) == 176);
+static_assert(sizeof(Scene) == 288);
+// std430 packs the vec2 array, the particles follow the header
+static_assert(sizeof(Particles::scale[0]) == 8);
+static_assert(sizeof(Particles) == 64);
+
+using Vertex = ShaderData::triangle_vert::Vertex;
+
+// the interleaved vertex of triangle.vert with its color compressed to 4 bytes
+static_assert(sizeof(Vertex) == 20);
+static_assert(offsetof(Vertex, inTexCoord) == 12);
+static_assert(ShaderData::triangle_vert::vertexBindings[0].stride == sizeof(Vertex));
+static_assert(ShaderData::triangle_vert::vertexAttributes[1].format == vk::Format::eR8G8B8A8Unorm);
+
+using SpecializationConstants = ShaderData::triangle_vert::SpecializationConstants;
+
+// the bool constants of triangle.vert are read as VkBool32 and default to false
+static_assert(sizeof(SpecializationConstants) == 2 * sizeof(vk::Bool32));
+static_assert(ShaderData::triangle_vert::specializationMapEntries[1].constantID == 1);
+static_assert(ShaderData::triangle_vert::specializationMapEntries[1].offset == offsetof(SpecializationConstants, FlipTexture));
+static_assert(ShaderData::triangle_vert::specializationConstants.UseTexture == VK_FALSE);
+static_assert(ShaderData::triangle_vert::specializationInfo.mapEntryCount == 2);
+
+namespace Material = ShaderData::material_frag_variants;
+
+// 12 permutations, the ones that differ only in DEBUG_NAMES compile to the same module
+static_assert(Material::variantModules.size() == 12);
+static_assert(Material::modules.size() == 6);
+static_assert(Material::getCode({ .ALPHA_TEST = true, .QUALITY = 2 }).data() ==
+	Material::getCode({ .ALPHA_TEST = true, .DEBUG_NAMES = true, .QUALITY = 2 }).data());
+static_assert(Material::getCode({ .QUALITY = 3 }).empty());
+// only the listed permutation of triangle.frag is built
+static_assert(ShaderData::triangle_frag_variants::getCode({}).empty());
+static_assert(!ShaderData::triangle_frag_variants::getCode({ .FLIP = true }).empty());
 
 int main()
 {
-	
-}
\ No newline at end of file
+	Scene scene{};
+	scene.exposure = 2.0f;
+	scene.weights[1].value = 0.5f;
+
+	// the struct is copied as is, the way it is into a mapped uniform buffer
+	unsigned char mapped[sizeof(Scene)];
+	std::memcpy(mapped, &scene, sizeof(Scene));
+	float exposure;
+	float weight;
+	std::memcpy(&exposure, mapped + 12, sizeof(float));
+	std::memcpy(&weight, mapped + 96, sizeof(float));
+	return exposure == 2.0f && weight == 0.5f ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+#version 450
+
+#ifndef QUALITY
+#define QUALITY 0
+#endif
+
+layout(location = 0) in vec3 fragColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = vec4(fragColor * float(QUALITY + 1), 1.0);
+#ifdef ALPHA_TEST
+    if (fragColor.r < 0.5)
+        discard;
+#endif
+}
@@ -0,0 +1,75 @@
+#include "frame_loop.hpp"
+
+#include <core/core.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <format>
+
+constexpr uint32_t FrameCount = 16;
+constexpr uint32_t FramesInFlight = 3;
+constexpr vk::DeviceSize BufferSize = 16 << 20;
+
+int main()
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::CommandPoolManager, vkr::GpuProfiler>(physicalDevice);
+	const auto& queue = device.getQueueFamilies()[0][0];
+
+	vkr::GpuProfiler profiler{ device, queue, FramesInFlight };
+
+	vk::raii::Buffer buffer{ device, vk::BufferCreateInfo{ {}, BufferSize, vk::BufferUsageFlagBits::eTransferDst } };
+	auto allocation = device.getMemoryAllocator().allocate(buffer.getMemoryRequirements());
+	buffer.bindMemory(allocation.memory, allocation.offset);
+
+	runFrames(device, queue, FramesInFlight, FrameCount, [&](uint64_t frame, const vk::raii::CommandBuffer& commandBuffer)
+	{
+		profiler.beginFrame();
+
+		vkr::GpuProfiler::Scope frameZone{ profiler, commandBuffer, "frame" };
+		{
+			vkr::GpuProfiler::Scope fillZone{ profiler, commandBuffer, "fill \"whole\" buffer" };
+			commandBuffer.fillBuffer(*buffer, 0, VK_WHOLE_SIZE, static_cast<uint32_t>(frame));
+		}
+		vkr::GpuProfiler::Scope halfZone{ profiler, commandBuffer, "fill half" };
+		commandBuffer.fillBuffer(*buffer, 0, BufferSize / 2, 0);
+	});
+
+	profiler.resolve();
+
+	const auto& zones = profiler.getZones();
+	std::cout << std::format("{} zones from {} frames\n", zones.size(), FrameCount);
+	if (zones.size() != 3 * FrameCount)
+	{
+		std::cout << "missing zones\n";
+		return 1;
+	}
+
+	// the frame zone contains the two fills recorded inside it
+	for (size_t index = 0; index < zones.size(); index += 3)
+	{
+		const auto& frameZone = zones[index];
+		double frameEnd = frameZone.beginMicroseconds + frameZone.durationMicroseconds;
+		for (size_t child = index + 1; child < index + 3; child++)
+		{
+			const auto& zone = zones[child];
+			if (zone.frame != frameZone.frame || zone.beginMicroseconds < frameZone.beginMicroseconds
+				|| zone.beginMicroseconds + zone.durationMicroseconds > frameEnd + 0.001)
+			{
+				std::cout << std::format("zone {} of frame {} lies outside its frame\n", zone.name, zone.frame);
+				return 1;
+			}
+		}
+		std::cout << std::format("frame {}: {:.1f} us\n", frameZone.frame, frameZone.durationMicroseconds);
+	}
+
+	auto tracePath = std::filesystem::temp_directory_path() / "vkr_gpu_profiler.json";
+	std::ofstream traceFile{ tracePath };
+	profiler.writeChromeTrace(traceFile);
+	std::cout << std::format("trace written to {}\n", tracePath.string());
+
+	buffer = vk::raii::Buffer{ nullptr };
+	device.getMemoryAllocator().free(allocation);
+}
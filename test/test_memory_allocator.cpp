@@ -0,0 +1,181 @@
+#include <core/memory_allocator.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <map>
+#include <random>
+
+namespace
+{
+	struct FakeMemory
+	{
+		uint64_t nextHandle = 1;
+		uint32_t liveCount = 0;
+		uint32_t dedicatedCount = 0;
+
+		vkr::MemoryCallbacks getCallbacks()
+		{
+			vkr::MemoryCallbacks callbacks;
+			callbacks.allocate = [this](const vk::MemoryAllocateInfo& allocateInfo)
+				{
+					liveCount++;
+					if (allocateInfo.pNext)
+						dedicatedCount++;
+					return vk::DeviceMemory{ reinterpret_cast<VkDeviceMemory>(nextHandle++) };
+				};
+			callbacks.free = [this](vk::DeviceMemory) { liveCount--; };
+			return callbacks;
+		}
+	};
+
+	vk::PhysicalDeviceMemoryProperties getFakeMemoryProperties()
+	{
+		vk::PhysicalDeviceMemoryProperties properties;
+		properties.memoryHeapCount = 2;
+		properties.memoryHeaps[0].size = 4ull << 30;
+		properties.memoryHeaps[1].size = 256ull << 20;
+		properties.memoryTypeCount = 3;
+		properties.memoryTypes[0] = vk::MemoryType{ vk::MemoryPropertyFlagBits::eDeviceLocal, 0 };
+		properties.memoryTypes[1] = vk::MemoryType{
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, 1 };
+		properties.memoryTypes[2] = vk::MemoryType{
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent |
+			vk::MemoryPropertyFlagBits::eHostCached, 1 };
+		return properties;
+	}
+}
+
+TEST_CASE("tlsf allocations are aligned and never overlap")
+{
+	vkr::TlsfAllocator allocator{ 1 << 20 };
+	std::mt19937 random{ 42 };
+	std::vector<vkr::TlsfAllocator::Allocation> allocations;
+
+	for (uint32_t step = 0; step < 20000; step++)
+	{
+		if (allocations.empty() || random() % 2)
+		{
+			vk::DeviceSize size = 1 + random() % 4096;
+			vk::DeviceSize alignment = 1ull << (random() % 9);
+			if (auto allocation = allocator.allocate(size, alignment))
+			{
+				REQUIRE(allocation.offset % alignment == 0);
+				REQUIRE(allocation.size >= size);
+				allocations.push_back(allocation);
+			}
+		}
+		else
+		{
+			auto index = random() % allocations.size();
+			allocator.free(allocations[index]);
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+
+	std::map<vk::DeviceSize, vk::DeviceSize> ranges;
+	vk::DeviceSize allocatedSize = 0;
+	for (const auto& allocation : allocations)
+	{
+		ranges[allocation.offset] = allocation.size;
+		allocatedSize += allocation.size;
+	}
+	vk::DeviceSize end = 0;
+	for (const auto& [offset, size] : ranges)
+	{
+		REQUIRE(offset >= end);
+		end = offset + size;
+	}
+	REQUIRE(end <= allocator.getSize());
+	REQUIRE(allocatedSize + allocator.getFreeSize() == allocator.getSize());
+
+	for (const auto& allocation : allocations)
+	{
+		allocator.free(allocation);
+	}
+	REQUIRE(allocator.getFreeRangeCount() == 1);
+	REQUIRE(allocator.getLargestFreeSize() == allocator.getSize());
+}
+
+TEST_CASE("memory types are picked from the memory properties")
+{
+	auto properties = getFakeMemoryProperties();
+	FakeMemory memory;
+	vkr::MemoryAllocator allocator{ properties, 1, memory.getCallbacks() };
+
+	REQUIRE(allocator.getMemoryTypeIndex(0b111, vkr::MemoryUsage::eGpuOnly) == 0);
+	REQUIRE(allocator.getMemoryTypeIndex(0b111, vkr::MemoryUsage::eCpuToGpu) == 1);
+	REQUIRE(allocator.getMemoryTypeIndex(0b111, vkr::MemoryUsage::eGpuToCpu) == 2);
+	REQUIRE(allocator.getMemoryTypeIndex(0b110, vkr::MemoryUsage::eGpuOnly) == 1);
+	REQUIRE_THROWS(allocator.getMemoryTypeIndex(0b001, vkr::MemoryUsage::eCpuToGpu));
+}
+
+TEST_CASE("small allocations share blocks")
+{
+	auto properties = getFakeMemoryProperties();
+	FakeMemory memory;
+	{
+		vkr::MemoryAllocator allocator{ properties, 1, memory.getCallbacks() };
+
+		std::vector<vkr::MemoryAllocation> allocations;
+		for (uint32_t index = 0; index < 1000; index++)
+		{
+			allocations.push_back(allocator.allocate({ 4096, 256, 0b111 }));
+		}
+		REQUIRE(memory.liveCount == 1);
+
+		auto statistics = allocator.getStatistics();
+		REQUIRE(statistics.blockCount == 1);
+		REQUIRE(statistics.allocationCount == 1000);
+		REQUIRE(statistics.fragmentation == 0.0f);
+
+		for (uint32_t index = 0; index < allocations.size(); index += 2)
+		{
+			allocator.free(allocations[index]);
+		}
+		REQUIRE(allocator.getStatistics().fragmentation > 0.0f);
+
+		for (uint32_t index = 1; index < allocations.size(); index += 2)
+		{
+			allocator.free(allocations[index]);
+		}
+		statistics = allocator.getStatistics();
+		REQUIRE(statistics.allocationCount == 0);
+		REQUIRE(statistics.fragmentation == 0.0f);
+	}
+	REQUIRE(memory.liveCount == 0);
+}
+
+TEST_CASE("linear and optimal resources are kept apart by bufferImageGranularity")
+{
+	auto properties = getFakeMemoryProperties();
+	FakeMemory memory;
+	vkr::MemoryAllocator allocator{ properties, 1024, memory.getCallbacks() };
+
+	auto buffer = allocator.allocate({ 256, 16, 0b1 });
+	auto image = allocator.allocate({ 256, 16, 0b1 }, { vkr::MemoryUsage::eGpuOnly, vkr::ResourceTiling::eOptimal });
+	REQUIRE(buffer.memory != image.memory);
+	REQUIRE(allocator.getStatistics().blockCount == 2);
+}
+
+TEST_CASE("large resources get dedicated allocations")
+{
+	auto properties = getFakeMemoryProperties();
+	FakeMemory memory;
+	vkr::MemoryAllocator allocator{ properties, 1, memory.getCallbacks() };
+
+	auto large = allocator.allocate({ 256ull << 20, 256, 0b1 });
+	REQUIRE(large.offset == 0);
+	REQUIRE(allocator.getStatistics().dedicatedAllocationCount == 1);
+
+	vkr::AllocationCreateInfo createInfo;
+	createInfo.dedicated = true;
+	createInfo.dedicatedImage = vk::Image{ reinterpret_cast<VkImage>(uint64_t{ 1 }) };
+	auto image = allocator.allocate({ 4096, 256, 0b1 }, createInfo);
+	REQUIRE(memory.dedicatedCount == 1);
+
+	allocator.free(large);
+	allocator.free(image);
+	REQUIRE(allocator.getStatistics().dedicatedAllocationCount == 0);
+	REQUIRE(memory.liveCount == 0);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <core/core.hpp>
+#include <exec/sync_wait.hpp>
+#include <variant_comp.hpp>
+
+#include <chrono>
+#include <cstring>
+
+struct PipelineTestContext
+{
+	vkr::Instance instance = vkr::createInstance();
+	vk::raii::PhysicalDevice physicalDevice = instance.getPhysicalDevice();
+	vkr::Device device{ physicalDevice, vkr::DeviceCreateInfo{} };
+	vk::raii::ShaderModule shaderModule{ device,
+		vk::ShaderModuleCreateInfo{ {}, ShaderData::variant_comp::code } };
+	vk::raii::PipelineLayout pipelineLayout{ device, vk::PipelineLayoutCreateInfo{} };
+
+	vk::raii::Pipeline createPipeline(const vk::raii::PipelineCache& pipelineCache, uint32_t variant) const
+	{
+		ShaderData::variant_comp::SpecializationConstants constants{ variant };
+		auto specializationInfo = ShaderData::variant_comp::getSpecializationInfo(constants);
+		vk::PipelineShaderStageCreateInfo stageInfo{ {}, vk::ShaderStageFlagBits::eCompute,
+			*shaderModule, "main", &specializationInfo };
+		return vk::raii::Pipeline{ device, pipelineCache,
+			vk::ComputePipelineCreateInfo{ {}, stageInfo, *pipelineLayout } };
+	}
+
+	vkr::PipelineDescription describePipeline(uint32_t variant) const
+	{
+		vkr::ComputePipelineDescription description;
+		description.stage.module = *shaderModule;
+		ShaderData::variant_comp::SpecializationConstants constants{ variant };
+		description.stage.specializationEntries.assign(ShaderData::variant_comp::specializationMapEntries.begin(),
+			ShaderData::variant_comp::specializationMapEntries.end());
+		description.stage.specializationData.resize(sizeof(constants));
+		std::memcpy(description.stage.specializationData.data(), &constants, sizeof(constants));
+		description.layout = *pipelineLayout;
+		return description;
+	}
+};
+
+template<typename F>
+double measureSeconds(F&& f)
+{
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(end - begin).count();
+}
@@ -0,0 +1,22 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 position;
+} camera;
+
+layout(set = 2, binding = 1) uniform sampler2D albedo;
+
+layout(push_constant) uniform Constants {
+    layout(offset = 64) vec4 tint;
+} constants;
+
+layout(location = 0) in vec3 worldPosition;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    float distance = length(camera.position.xyz - worldPosition);
+    outColor = texture(albedo, worldPosition.xy) * constants.tint / distance;
+}
@@ -0,0 +1,21 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 position;
+} camera;
+
+layout(push_constant) uniform Constants {
+    mat4 model;
+} constants;
+
+layout(location = 0) in vec3 inPosition;
+
+layout(location = 0) out vec3 worldPosition;
+
+void main() {
+    vec4 world = constants.model * vec4(inPosition, 1.0);
+    worldPosition = world.xyz;
+    gl_Position = camera.projection * camera.view * world;
+}
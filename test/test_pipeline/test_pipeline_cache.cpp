@@ -0,0 +1,68 @@
+#include "common.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <iostream>
+#include <format>
+
+constexpr uint32_t PipelineCount = 300;
+
+TEST_CASE("pipeline cache header validation")
+{
+	vk::PhysicalDeviceProperties properties;
+	properties.vendorID = 0x10de;
+	properties.deviceID = 0x2204;
+	properties.pipelineCacheUUID[0] = 1;
+
+	vk::PipelineCacheHeaderVersionOne header{ sizeof(vk::PipelineCacheHeaderVersionOne),
+		vk::PipelineCacheHeaderVersion::eOne, properties.vendorID, properties.deviceID, properties.pipelineCacheUUID };
+	std::vector<std::byte> data(sizeof(header) + 64);
+	std::memcpy(data.data(), &header, sizeof(header));
+
+	REQUIRE(vkr::PipelineCacheStore::isCompatible(data, properties));
+	REQUIRE_FALSE(vkr::PipelineCacheStore::isCompatible(std::span{ data }.first(8), properties));
+
+	auto otherDriver = properties;
+	otherDriver.pipelineCacheUUID[0] = 2;
+	REQUIRE_FALSE(vkr::PipelineCacheStore::isCompatible(data, otherDriver));
+
+	auto otherDevice = properties;
+	otherDevice.deviceID = 0x2206;
+	REQUIRE_FALSE(vkr::PipelineCacheStore::isCompatible(data, otherDevice));
+}
+
+TEST_CASE("cold and warm pipeline creation", "[.][benchmark]")
+{
+	PipelineTestContext context;
+	auto cachePath = std::filesystem::temp_directory_path() / "vkr_pipeline_cache.bin";
+	std::filesystem::remove(cachePath);
+
+	auto createPipelines = [&](vkr::PipelineCacheStore& store)
+		{
+			std::vector<vk::raii::Pipeline> pipelines;
+			for (uint32_t variant = 0; variant < PipelineCount; variant++)
+			{
+				pipelines.push_back(context.createPipeline(store.getPipelineCache(), variant));
+			}
+		};
+
+	double coldTime = 0.0;
+	{
+		vkr::PipelineCacheStore store{ context.device, cachePath };
+		REQUIRE_FALSE(store.isLoaded());
+		coldTime = measureSeconds([&] { createPipelines(store); });
+	}
+	REQUIRE(std::filesystem::exists(cachePath));
+
+	double warmTime = 0.0;
+	{
+		vkr::PipelineCacheStore store{ context.device, cachePath };
+		REQUIRE(store.isLoaded());
+		warmTime = measureSeconds([&] { createPipelines(store); });
+	}
+
+	std::cout << std::format("{} pipelines: cold {:.1f} ms, warm {:.1f} ms\n",
+		PipelineCount, coldTime * 1000.0, warmTime * 1000.0);
+	std::filesystem::remove(cachePath);
+}
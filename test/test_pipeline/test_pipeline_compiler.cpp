@@ -0,0 +1,131 @@
+#include "common.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <format>
+
+constexpr uint32_t UniquePipelineCount = 500;
+
+namespace
+{
+	vkr::PipelineDescription describeGraphics(vk::Format colorFormat, bool blend)
+	{
+		vkr::GraphicsPipelineDescription description;
+		description.stages.push_back({ vk::ShaderStageFlagBits::eVertex });
+		description.stages.push_back({ vk::ShaderStageFlagBits::eFragment });
+		description.vertexBindings = { vk::VertexInputBindingDescription{ 0, 32 } };
+		description.vertexAttributes = { vk::VertexInputAttributeDescription{ 0, 0, vk::Format::eR32G32B32Sfloat, 0 } };
+		vk::PipelineColorBlendAttachmentState blendAttachment;
+		blendAttachment.setBlendEnable(blend);
+		description.blendAttachments = { blendAttachment };
+		description.colorFormats = { colorFormat };
+		description.depthFormat = vk::Format::eD32Sfloat;
+		return description;
+	}
+}
+
+TEST_CASE("pipeline description hashing")
+{
+	auto base = describeGraphics(vk::Format::eR8G8B8A8Unorm, false);
+
+	REQUIRE(vkr::hashPipelineDescription(base) == vkr::hashPipelineDescription(describeGraphics(vk::Format::eR8G8B8A8Unorm, false)));
+	REQUIRE(base == describeGraphics(vk::Format::eR8G8B8A8Unorm, false));
+
+	auto otherFormat = describeGraphics(vk::Format::eB8G8R8A8Unorm, false);
+	REQUIRE(base != otherFormat);
+	REQUIRE(vkr::hashPipelineDescription(base) != vkr::hashPipelineDescription(otherFormat));
+
+	auto otherBlend = describeGraphics(vk::Format::eR8G8B8A8Unorm, true);
+	REQUIRE(base != otherBlend);
+	REQUIRE(vkr::hashPipelineDescription(base) != vkr::hashPipelineDescription(otherBlend));
+
+	vkr::ComputePipelineDescription compute;
+	compute.stage.specializationEntries = { vk::SpecializationMapEntry{ 0, 0, 1 } };
+	compute.stage.specializationData = { std::byte{ 1 } };
+	auto otherSpecialization = compute;
+	otherSpecialization.stage.specializationData = { std::byte{ 2 } };
+	REQUIRE(vkr::hashPipelineDescription(compute) != vkr::hashPipelineDescription(otherSpecialization));
+}
+
+TEST_CASE("pipeline description hashing is canonical")
+{
+	auto base = describeGraphics(vk::Format::eR8G8B8A8Unorm, false);
+	auto& graphics = std::get<vkr::GraphicsPipelineDescription>(base);
+	graphics.vertexAttributes.push_back(vk::VertexInputAttributeDescription{ 1, 0, vk::Format::eR32G32Sfloat, 12 });
+
+	auto reordered = base;
+	auto& reorderedGraphics = std::get<vkr::GraphicsPipelineDescription>(reordered);
+	std::swap(reorderedGraphics.vertexAttributes[0], reorderedGraphics.vertexAttributes[1]);
+	std::swap(reorderedGraphics.stages[0], reorderedGraphics.stages[1]);
+	REQUIRE(vkr::hashPipelineDescription(base) == vkr::hashPipelineDescription(reordered));
+
+	// blend factors are ignored while blending is off
+	auto ignoredBlend = base;
+	std::get<vkr::GraphicsPipelineDescription>(ignoredBlend).blendAttachments[0].setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha);
+	REQUIRE(vkr::hashPipelineDescription(base) == vkr::hashPipelineDescription(ignoredBlend));
+
+	auto noDepthTest = base;
+	std::get<vkr::GraphicsPipelineDescription>(noDepthTest).depthTest = false;
+	auto noDepthTestOtherOp = noDepthTest;
+	std::get<vkr::GraphicsPipelineDescription>(noDepthTestOtherOp).depthCompareOp = vk::CompareOp::eGreater;
+	REQUIRE(vkr::hashPipelineDescription(base) != vkr::hashPipelineDescription(noDepthTest));
+	REQUIRE(vkr::hashPipelineDescription(noDepthTest) == vkr::hashPipelineDescription(noDepthTestOtherOp));
+
+	// the same code in another module is the same pipeline once the code hash is set
+	std::array<uint32_t, 4> code{ 0x07230203, 0x00010000, 0, 1 };
+	vkr::ComputePipelineDescription first;
+	first.stage.module = vk::ShaderModule{ reinterpret_cast<VkShaderModule>(uint64_t{ 1 }) };
+	first.stage.codeHash = vkr::hashShaderCode(code);
+	auto second = first;
+	second.stage.module = vk::ShaderModule{ reinterpret_cast<VkShaderModule>(uint64_t{ 2 }) };
+	REQUIRE(vkr::hashPipelineDescription(first) == vkr::hashPipelineDescription(second));
+}
+
+TEST_CASE("parallel pipeline compilation", "[.][benchmark]")
+{
+	PipelineTestContext context;
+
+	// every variant is requested twice, the second request has to reuse the first pipeline
+	std::vector<vkr::PipelineDescription> descriptions;
+	for (uint32_t repeat = 0; repeat < 2; repeat++)
+	{
+		for (uint32_t variant = 0; variant < UniquePipelineCount; variant++)
+		{
+			descriptions.push_back(context.describePipeline(variant));
+		}
+	}
+
+	std::vector<uint32_t> threadCounts{ 1 };
+	for (uint32_t threadCount = 2; threadCount <= std::thread::hardware_concurrency(); threadCount *= 2)
+	{
+		threadCounts.push_back(threadCount);
+	}
+
+	double serialTime = 0.0;
+	for (auto threadCount : threadCounts)
+	{
+		vkr::exec::thread_run_loop loop{ threadCount };
+		vkr::PipelineCompiler compiler{ context.device };
+
+		vkr::PipelineCompiler::PipelineList pipelines;
+		double time = measureSeconds([&]
+			{
+				pipelines = vkr::exec::sync_wait<vkr::PipelineCompiler::PipelineList>(
+					compiler.compile(vkr::exec::get_scheduler(loop), descriptions));
+			});
+
+		REQUIRE(pipelines.size() == descriptions.size());
+		REQUIRE(compiler.getCompiledCount() == UniquePipelineCount);
+		for (uint32_t variant = 0; variant < UniquePipelineCount; variant++)
+		{
+			REQUIRE(pipelines[variant]);
+			REQUIRE(pipelines[variant] == pipelines[variant + UniquePipelineCount]);
+		}
+
+		if (threadCount == 1)
+			serialTime = time;
+		std::cout << std::format("{} pipelines on {} threads: {:.1f} ms, speedup {:.2f}\n",
+			UniquePipelineCount, threadCount, time * 1000.0, serialTime / time);
+	}
+}
@@ -0,0 +1,138 @@
+#include "common.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <iostream>
+#include <format>
+
+constexpr uint32_t RegistryThreadCount = 16;
+
+namespace
+{
+	// registry tests only look at identity, the factory hands out empty pipelines
+	vkr::PipelineDescription describeVariant(uint32_t variant)
+	{
+		vkr::ComputePipelineDescription description;
+		description.stage.specializationEntries = { vk::SpecializationMapEntry{ 0, 0, sizeof(uint32_t) } };
+		description.stage.specializationData.resize(sizeof(uint32_t));
+		std::memcpy(description.stage.specializationData.data(), &variant, sizeof(uint32_t));
+		return description;
+	}
+
+	template<typename F>
+	void runThreads(uint32_t threadCount, F&& f)
+	{
+		std::vector<std::jthread> threads;
+		for (uint32_t index = 0; index < threadCount; index++)
+		{
+			threads.emplace_back([&f, index] { f(index); });
+		}
+	}
+}
+
+TEST_CASE("pipeline registry creates each pipeline once")
+{
+	constexpr uint32_t VariantCount = 256;
+
+	std::atomic<uint32_t> factoryCalls = 0;
+	vkr::PipelineRegistry registry{ [&](const vkr::PipelineDescription&)
+		{
+			factoryCalls++;
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+			return vk::raii::Pipeline{ nullptr };
+		}, 16 };
+
+	std::vector<std::vector<const vk::raii::Pipeline*>> seen(RegistryThreadCount);
+	runThreads(RegistryThreadCount, [&](uint32_t thread)
+		{
+			for (uint32_t variant = 0; variant < VariantCount; variant++)
+			{
+				// every thread walks the variants from a different start so creations race
+				seen[thread].push_back(&registry.getPipeline(describeVariant((variant + thread * 17) % VariantCount)));
+			}
+			std::ranges::rotate(seen[thread], seen[thread].end() - (thread * 17) % VariantCount);
+		});
+
+	REQUIRE(factoryCalls == VariantCount);
+	REQUIRE(registry.size() == VariantCount);
+	REQUIRE(registry.getCreatedCount() == VariantCount);
+	for (uint32_t thread = 1; thread < RegistryThreadCount; thread++)
+	{
+		REQUIRE(seen[thread] == seen[0]);
+	}
+	for (uint32_t variant = 0; variant < VariantCount; variant++)
+	{
+		REQUIRE(registry.findPipeline(vkr::hashPipelineDescription(describeVariant(variant))) == seen[0][variant]);
+	}
+	REQUIRE(registry.findPipeline(vkr::hashPipelineDescription(describeVariant(VariantCount))) == nullptr);
+}
+
+TEST_CASE("pipeline registry retries failed creation")
+{
+	bool fail = true;
+	vkr::PipelineRegistry registry{ [&](const vkr::PipelineDescription&)
+		{
+			if (std::exchange(fail, false))
+				throw std::runtime_error("compilation failed");
+			return vk::raii::Pipeline{ nullptr };
+		} };
+
+	auto description = describeVariant(0);
+	REQUIRE_THROWS(registry.getPipeline(description));
+	REQUIRE(registry.findPipeline(vkr::hashPipelineDescription(description)) == nullptr);
+	REQUIRE_NOTHROW(registry.getPipeline(description));
+	REQUIRE(registry.findPipeline(vkr::hashPipelineDescription(description)) != nullptr);
+	REQUIRE(registry.getCreatedCount() == 1);
+}
+
+TEST_CASE("pipeline registry lookup throughput", "[.][benchmark]")
+{
+	constexpr uint32_t VariantCount = 4096;
+	constexpr uint32_t LookupCount = 1 << 20;
+
+	vkr::PipelineRegistry registry{ [](const vkr::PipelineDescription&) { return vk::raii::Pipeline{ nullptr }; } };
+
+	std::vector<vkr::PipelineDescription> descriptions;
+	std::vector<vkr::PipelineHash> hashes;
+	for (uint32_t variant = 0; variant < VariantCount; variant++)
+	{
+		descriptions.push_back(describeVariant(variant));
+		hashes.push_back(vkr::hashPipelineDescription(descriptions.back()));
+		registry.getPipeline(hashes.back(), descriptions.back());
+	}
+
+	std::atomic<uint32_t> misses = 0;
+	double hashTime = measureSeconds([&]
+		{
+			runThreads(RegistryThreadCount, [&](uint32_t thread)
+				{
+					for (uint32_t index = 0; index < LookupCount; index++)
+					{
+						if (!registry.findPipeline(hashes[(index * 7 + thread) % VariantCount]))
+							misses++;
+					}
+				});
+		});
+
+	constexpr uint32_t DescriptionLookupCount = LookupCount / 16;
+	double descriptionTime = measureSeconds([&]
+		{
+			runThreads(RegistryThreadCount, [&](uint32_t thread)
+				{
+					for (uint32_t index = 0; index < DescriptionLookupCount; index++)
+					{
+						registry.getPipeline(descriptions[(index * 7 + thread) % VariantCount]);
+					}
+				});
+		});
+
+	REQUIRE(misses == 0);
+	REQUIRE(registry.getCreatedCount() == VariantCount);
+
+	double totalLookups = static_cast<double>(LookupCount) * RegistryThreadCount;
+	double totalDescriptionLookups = static_cast<double>(DescriptionLookupCount) * RegistryThreadCount;
+	std::cout << std::format("{} threads, lookup by hash: {:.1f} M/s, lookup by description: {:.1f} M/s\n",
+		RegistryThreadCount, totalLookups / hashTime / 1e6, totalDescriptionLookups / descriptionTime / 1e6);
+}
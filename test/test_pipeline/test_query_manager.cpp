@@ -0,0 +1,75 @@
+#include "../frame_loop.hpp"
+
+#include <core/core.hpp>
+#include <variant_comp.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <format>
+
+TEST_CASE("query manager reads pass statistics and occlusion results a frame late")
+{
+	constexpr uint32_t FramesInFlight = 2;
+	constexpr uint32_t FrameCount = 6;
+	constexpr uint32_t GroupCount = 16;
+
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::CommandPoolManager, vkr::QueryManager>(physicalDevice);
+	const auto& queue = device.getQueueFamilies()[0][0];
+
+	vk::raii::ShaderModule shaderModule{ device, vk::ShaderModuleCreateInfo{ {}, ShaderData::variant_comp::code } };
+	vk::raii::PipelineLayout pipelineLayout{ device, vk::PipelineLayoutCreateInfo{} };
+	vk::raii::Pipeline pipeline{ device, nullptr, vk::ComputePipelineCreateInfo{ {},
+		vk::PipelineShaderStageCreateInfo{ {}, vk::ShaderStageFlagBits::eCompute, *shaderModule, "main" }, *pipelineLayout } };
+
+	vkr::QueryManager queries{ device, vkr::QueryManagerCreateInfo{ FramesInFlight, 64, 16 } };
+	// without the feature statistics queries are skipped and nothing else changes
+	uint32_t statisticsPerFrame = queries.hasPipelineStatistics() ? 2 : 0;
+
+	uint32_t resolvedFrames = 0;
+	runFrames(device, queue, FramesInFlight, FrameCount, [&](uint64_t frame, const vk::raii::CommandBuffer& commandBuffer)
+	{
+		queries.beginFrame();
+
+		// every frame but the first two sees the results of the frame two before it
+		if (frame > FramesInFlight)
+		{
+			const auto& passStatistics = queries.getPassStatistics();
+			REQUIRE(passStatistics.size() == statisticsPerFrame);
+			if (statisticsPerFrame > 0)
+			{
+				REQUIRE(passStatistics[0].name == "dispatch");
+				REQUIRE(passStatistics[0].frame == frame - FramesInFlight);
+				auto invocations = passStatistics[0].statistics.get(vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations);
+				REQUIRE(invocations > 0);
+				REQUIRE(passStatistics[1].statistics.get(vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations) == 0);
+				std::cout << std::format("frame {}: {} compute invocations\n", passStatistics[0].frame, invocations);
+			}
+
+			REQUIRE(queries.getOcclusionResults().size() == 1);
+			REQUIRE(queries.getOcclusionResults()[0].key == frame - FramesInFlight);
+			REQUIRE(queries.getOcclusionResults()[0].samples == 0);
+			resolvedFrames++;
+		}
+
+		queries.recordResets(commandBuffer);
+
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+		auto dispatchQuery = queries.beginStatisticsQuery(commandBuffer, "dispatch");
+		commandBuffer.dispatch(GroupCount, 1, 1);
+		queries.endStatisticsQuery(commandBuffer, dispatchQuery);
+
+		// nothing is drawn, neither query counts anything
+		auto emptyQuery = queries.beginStatisticsQuery(commandBuffer, "empty");
+		queries.endStatisticsQuery(commandBuffer, emptyQuery);
+		auto occlusionQuery = queries.beginOcclusionQuery(commandBuffer, frame);
+		queries.endOcclusionQuery(commandBuffer, occlusionQuery);
+	});
+
+	queries.resolve();
+	REQUIRE(resolvedFrames == FrameCount - FramesInFlight);
+	REQUIRE(queries.getPassStatistics().size() == statisticsPerFrame * FramesInFlight);
+	REQUIRE(queries.getDroppedCount() == 0);
+}
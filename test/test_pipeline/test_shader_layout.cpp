@@ -0,0 +1,69 @@
+#include <core/core.hpp>
+#include <layout_vert.hpp>
+#include <layout_frag.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <stdexcept>
+
+namespace
+{
+	constexpr vkr::ShaderStageLayout VertexLayout{
+		ShaderData::layout_vert::descriptorSets, ShaderData::layout_vert::pushConstantRanges };
+	constexpr vkr::ShaderStageLayout FragmentLayout{
+		ShaderData::layout_frag::descriptorSets, ShaderData::layout_frag::pushConstantRanges };
+}
+
+// the generated data is usable in constant expressions
+static_assert(ShaderData::layout_vert::stage == vk::ShaderStageFlagBits::eVertex);
+static_assert(ShaderData::layout_frag::descriptorSets.size() == 3);
+static_assert(ShaderData::layout_frag::descriptorSets[1].empty());
+static_assert(ShaderData::layout_frag::pushConstantRanges[0].offset == 64);
+
+TEST_CASE("generated shader layouts merge across stages")
+{
+	auto layout = vkr::mergeShaderLayouts(std::array{ VertexLayout, FragmentLayout });
+
+	REQUIRE(layout.descriptorSets.size() == 3);
+	REQUIRE(layout.descriptorSets[0].size() == 1);
+	REQUIRE(layout.descriptorSets[0][0].descriptorType == vk::DescriptorType::eUniformBuffer);
+	REQUIRE(layout.descriptorSets[0][0].stageFlags == (vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment));
+	REQUIRE(layout.descriptorSets[1].empty());
+	REQUIRE(layout.descriptorSets[2].size() == 1);
+	REQUIRE(layout.descriptorSets[2][0].binding == 1);
+	REQUIRE(layout.descriptorSets[2][0].descriptorType == vk::DescriptorType::eCombinedImageSampler);
+	REQUIRE(layout.descriptorSets[2][0].stageFlags == vk::ShaderStageFlagBits::eFragment);
+
+	REQUIRE(layout.pushConstantRanges.size() == 2);
+	REQUIRE(layout.pushConstantRanges[0] == vk::PushConstantRange{ vk::ShaderStageFlagBits::eVertex, 0, 64 });
+	REQUIRE(layout.pushConstantRanges[1] == vk::PushConstantRange{ vk::ShaderStageFlagBits::eFragment, 64, 16 });
+}
+
+TEST_CASE("stages that disagree on a binding do not merge")
+{
+	static constexpr std::array vertexBindings{
+		vk::DescriptorSetLayoutBinding{ 0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex } };
+	static constexpr std::array fragmentBindings{
+		vk::DescriptorSetLayoutBinding{ 0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment } };
+	static constexpr std::array<std::span<const vk::DescriptorSetLayoutBinding>, 1> vertexSets{ vertexBindings };
+	static constexpr std::array<std::span<const vk::DescriptorSetLayoutBinding>, 1> fragmentSets{ fragmentBindings };
+
+	REQUIRE_THROWS_AS(vkr::mergeShaderLayouts(std::array{
+		vkr::ShaderStageLayout{ vertexSets, {} }, vkr::ShaderStageLayout{ fragmentSets, {} } }), std::runtime_error);
+}
+
+TEST_CASE("pipeline layout is created from generated layouts without reflection")
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::DescriptorAllocator>(physicalDevice);
+	vkr::DescriptorLayoutCache layoutCache{ device };
+
+	auto layout = vkr::mergeShaderLayouts(std::array{ VertexLayout, FragmentLayout });
+	auto pipelineLayout = vkr::createPipelineLayout(device, layoutCache, layout);
+
+	REQUIRE(*pipelineLayout);
+	// the uniform buffer set, the empty set and the sampler set
+	REQUIRE(layoutCache.size() == 3);
+}
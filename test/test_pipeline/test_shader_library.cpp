@@ -0,0 +1,89 @@
+#include "common.hpp"
+#include <layout_vert.hpp>
+#include <layout_frag.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <iostream>
+#include <format>
+
+// layout.frag is generated with --compression spirv-lz
+static_assert(ShaderData::layout_frag::compressedCode.size() < ShaderData::layout_frag::codeSize * sizeof(uint32_t));
+
+TEST_CASE("compressed SPIR-V decompresses to the same words")
+{
+	for (std::span<const uint32_t> code : { std::span<const uint32_t>{ ShaderData::variant_comp::code },
+		std::span<const uint32_t>{ ShaderData::layout_vert::code } })
+	{
+		auto compressed = vkr::compressSpirv(code);
+		REQUIRE(vkr::getDecompressedWordCount(compressed) == code.size());
+		auto decompressed = vkr::decompressSpirv(compressed);
+		REQUIRE(std::ranges::equal(decompressed, code));
+		std::cout << std::format("{} bytes of SPIR-V compressed to {} bytes\n", code.size_bytes(), compressed.size());
+	}
+}
+
+TEST_CASE("compressed SPIR-V decompression throughput", "[.][benchmark]")
+{
+	constexpr uint32_t DecompressCount = 2000;
+	std::vector<uint32_t> decompressed;
+	double time = measureSeconds([&]
+		{
+			for (uint32_t index = 0; index < DecompressCount; index++)
+			{
+				decompressed = vkr::decompressSpirv(ShaderData::layout_frag::compressedCode);
+			}
+		});
+	REQUIRE(decompressed.size() == ShaderData::layout_frag::codeSize);
+	std::cout << std::format("decompression: {:.1f} MB/s of SPIR-V\n",
+		static_cast<double>(DecompressCount) * ShaderData::layout_frag::codeSize * sizeof(uint32_t) / time / 1e6);
+}
+
+TEST_CASE("corrupt compressed SPIR-V throws")
+{
+	auto compressed = vkr::compressSpirv(ShaderData::variant_comp::code);
+	REQUIRE_THROWS_AS(vkr::decompressSpirv(std::span{ compressed }.first(compressed.size() - 1)), std::runtime_error);
+	REQUIRE_THROWS_AS(vkr::decompressSpirv(std::span{ compressed }.first(8)), std::runtime_error);
+
+	compressed[8]++;
+	REQUIRE_THROWS_AS(vkr::decompressSpirv(compressed), std::runtime_error);
+
+	// uncompressed SPIR-V is not accepted either
+	std::span<const uint32_t> code = ShaderData::variant_comp::code;
+	vkr::ShaderLibrary library;
+	REQUIRE_THROWS_AS(library.add("variant_comp",
+		std::span{ reinterpret_cast<const uint8_t*>(code.data()), code.size_bytes() }), std::runtime_error);
+}
+
+TEST_CASE("shader library decompresses each shader once")
+{
+	constexpr uint32_t ThreadCount = 8;
+
+	vkr::ShaderLibrary library;
+	uint32_t index = library.add("layout_frag", ShaderData::layout_frag::compressedCode);
+	REQUIRE(library.find("layout_frag") == index);
+	REQUIRE(library.find("layout_vert") == UINT32_MAX);
+	REQUIRE_THROWS_AS(library.getCode("layout_vert"), std::runtime_error);
+	REQUIRE(library.getDecompressedSize() == 0);
+
+	std::vector<const uint32_t*> seen(ThreadCount);
+	{
+		std::vector<std::jthread> threads;
+		for (uint32_t thread = 0; thread < ThreadCount; thread++)
+		{
+			threads.emplace_back([&, thread] { seen[thread] = library.getCode(index).data(); });
+		}
+	}
+	REQUIRE(std::ranges::all_of(seen, [&](const uint32_t* code) { return code == seen[0]; }));
+	REQUIRE(library.getCode("layout_frag").data() == seen[0]);
+	REQUIRE(library.getDecompressedSize() == ShaderData::layout_frag::codeSize * sizeof(uint32_t));
+
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	vkr::Device device{ physicalDevice, vkr::DeviceCreateInfo{} };
+	auto code = library.getCode(index);
+	vk::raii::ShaderModule shaderModule{ device, vk::ShaderModuleCreateInfo{ {}, code } };
+	REQUIRE(*shaderModule);
+}
@@ -0,0 +1,324 @@
+#include <core/core.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <format>
+
+namespace
+{
+	constexpr vk::DeviceSize ImageAlignment = 256;
+
+	// stands in for vkGetDeviceImageMemoryRequirements, 4 bytes per texel in one memory type
+	vk::MemoryRequirements queryMemoryRequirements(const vkr::RenderGraphResource& resource)
+	{
+		if (resource.type == vkr::ResourceType::eBuffer)
+			return vk::MemoryRequirements{ resource.buffer.size, 16, 1 };
+
+		const auto& extent = resource.image.extent;
+		vk::DeviceSize size = static_cast<vk::DeviceSize>(extent.width) * extent.height * extent.depth * 4;
+		return vk::MemoryRequirements{ (size + ImageAlignment - 1) / ImageAlignment * ImageAlignment, ImageAlignment, 1 };
+	}
+
+	vkr::ImageDescription describeImage(uint32_t width, uint32_t height)
+	{
+		vkr::ImageDescription description;
+		description.format = vk::Format::eR8G8B8A8Unorm;
+		description.extent = vk::Extent3D{ width, height, 1 };
+		description.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled;
+		return description;
+	}
+
+	const vkr::ResourceUsage ColorAttachment{ vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+		vk::AccessFlagBits2::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal };
+	const vkr::ResourceUsage FragmentSampled{ vk::PipelineStageFlagBits2::eFragmentShader,
+		vk::AccessFlagBits2::eShaderSampledRead, vk::ImageLayout::eShaderReadOnlyOptimal };
+	const vkr::ResourceUsage ComputeSampled{ vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderSampledRead, vk::ImageLayout::eShaderReadOnlyOptimal };
+	const vkr::ResourceUsage Present{ vk::PipelineStageFlagBits2::eNone,
+		vk::AccessFlagBits2::eNone, vk::ImageLayout::ePresentSrcKHR };
+
+	struct TestGraph
+	{
+		vkr::RenderGraph graph;
+		vkr::ResourceHandle backbuffer;
+
+		TestGraph()
+		{
+			backbuffer = graph.importImage("backbuffer", vk::Image{}, describeImage(1920, 1080),
+				vkr::ResourceUsage{}, Present);
+		}
+	};
+
+	const vkr::ResourceBarrier* findBarrier(const vkr::RenderGraphBatch& batch, vkr::ResourceHandle resource)
+	{
+		auto iter = std::ranges::find(batch.barriers, resource, &vkr::ResourceBarrier::resource);
+		return iter != batch.barriers.end() ? &*iter : nullptr;
+	}
+}
+
+TEST_CASE("render graph culls passes whose results are never read")
+{
+	TestGraph test;
+	auto& graph = test.graph;
+	auto unused = graph.createImage("unused", describeImage(512, 512));
+	auto scene = graph.createImage("scene", describeImage(1920, 1080));
+
+	graph.addPass("unused").write(unused, ColorAttachment);
+	graph.addPass("scene").write(scene, ColorAttachment);
+	graph.addPass("debug").read(scene, FragmentSampled).setSideEffect();
+	graph.addPass("compose").read(scene, FragmentSampled).write(test.backbuffer, ColorAttachment);
+	graph.compile(queryMemoryRequirements);
+
+	const auto& passes = graph.getPasses();
+	REQUIRE(passes[0].culled);
+	REQUIRE_FALSE(passes[1].culled);
+	REQUIRE_FALSE(passes[2].culled);
+	REQUIRE_FALSE(passes[3].culled);
+	REQUIRE(graph.getStatistics().culledPassCount == 1);
+	REQUIRE_FALSE(graph.getPlacement(unused));
+	REQUIRE(graph.getStatistics().transientResourceCount == 1);
+}
+
+TEST_CASE("render graph batches independent passes behind one barrier call")
+{
+	TestGraph test;
+	auto& graph = test.graph;
+	auto albedo = graph.createImage("albedo", describeImage(1920, 1080));
+	auto normal = graph.createImage("normal", describeImage(1920, 1080));
+
+	graph.addPass("albedo").write(albedo, ColorAttachment);
+	graph.addPass("normal").write(normal, ColorAttachment);
+	graph.addPass("lighting")
+		.read(albedo, FragmentSampled)
+		.read(normal, FragmentSampled)
+		.write(test.backbuffer, ColorAttachment);
+	graph.compile(queryMemoryRequirements);
+
+	const auto& batches = graph.getBatches();
+	REQUIRE(batches.size() == 2);
+	REQUIRE(batches[0].passes == std::vector<uint32_t>{ 0, 1 });
+	REQUIRE(batches[1].passes == std::vector<uint32_t>{ 2 });
+
+	// first use of both targets, a transition from undefined each
+	REQUIRE(batches[0].barriers.size() == 2);
+	REQUIRE(findBarrier(batches[0], albedo)->oldLayout == vk::ImageLayout::eUndefined);
+
+	auto albedoBarrier = findBarrier(batches[1], albedo);
+	REQUIRE(albedoBarrier);
+	REQUIRE(albedoBarrier->srcStages == vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+	REQUIRE(albedoBarrier->srcAccess == vk::AccessFlagBits2::eColorAttachmentWrite);
+	REQUIRE(albedoBarrier->newLayout == vk::ImageLayout::eShaderReadOnlyOptimal);
+	REQUIRE(batches[1].barriers.size() == 3);
+
+	REQUIRE(graph.getFinalBarriers().size() == 1);
+	REQUIRE(graph.getFinalBarriers()[0].newLayout == vk::ImageLayout::ePresentSrcKHR);
+	REQUIRE(graph.getStatistics().barrierBatchCount == 3);
+}
+
+TEST_CASE("render graph only waits once for reads in the same layout")
+{
+	TestGraph test;
+	auto& graph = test.graph;
+	auto shadow = graph.createImage("shadow", describeImage(2048, 2048));
+	auto scene = graph.createImage("scene", describeImage(1920, 1080));
+
+	graph.addPass("shadow").write(shadow, ColorAttachment);
+	graph.addPass("scene").read(shadow, FragmentSampled).write(scene, ColorAttachment);
+	graph.addPass("fog").read(shadow, FragmentSampled).setSideEffect();
+	graph.addPass("compose").read(scene, FragmentSampled).read(shadow, FragmentSampled).write(test.backbuffer, ColorAttachment);
+	graph.addPass("histogram").read(shadow, ComputeSampled).read(test.backbuffer, ComputeSampled).setSideEffect();
+	graph.compile(queryMemoryRequirements);
+
+	const auto& batches = graph.getBatches();
+	REQUIRE(batches.size() == 4);
+	REQUIRE(batches[1].passes == std::vector<uint32_t>{ 1, 2 });
+
+	// scene and fog share one transition, compose reads in the same layout and stage later
+	REQUIRE(findBarrier(batches[1], shadow));
+	REQUIRE_FALSE(findBarrier(batches[2], shadow));
+
+	// the histogram reads in another stage, which the transition did not cover
+	auto computeBarrier = findBarrier(batches[3], shadow);
+	REQUIRE(computeBarrier);
+	REQUIRE(computeBarrier->oldLayout == computeBarrier->newLayout);
+	REQUIRE(computeBarrier->dstStages == vk::PipelineStageFlagBits2::eComputeShader);
+}
+
+TEST_CASE("render graph aliases transient resources with disjoint lifetimes")
+{
+	TestGraph test;
+	auto& graph = test.graph;
+	std::array<vkr::ResourceHandle, 4> chain;
+	for (uint32_t index = 0; index < chain.size(); index++)
+	{
+		chain[index] = graph.createImage(std::format("chain{}", index), describeImage(1024, 1024));
+	}
+
+	graph.addPass("first").write(chain[0], ColorAttachment);
+	for (uint32_t index = 1; index < chain.size(); index++)
+	{
+		graph.addPass(std::format("blur{}", index)).read(chain[index - 1], FragmentSampled).write(chain[index], ColorAttachment);
+	}
+	graph.addPass("compose").read(chain.back(), FragmentSampled).write(test.backbuffer, ColorAttachment);
+	graph.compile(queryMemoryRequirements);
+
+	// each image only overlaps its neighbours, two slots hold all four
+	vk::DeviceSize imageSize = queryMemoryRequirements(graph.getResource(chain[0])).size;
+	const auto& statistics = graph.getStatistics();
+	REQUIRE(statistics.transientBytes == 4 * imageSize);
+	REQUIRE(statistics.aliasedBytes == 2 * imageSize);
+	REQUIRE(graph.getPlacement(chain[0]).offset == graph.getPlacement(chain[2]).offset);
+	REQUIRE(graph.getPlacement(chain[1]).offset == graph.getPlacement(chain[3]).offset);
+	REQUIRE(graph.getPlacement(chain[0]).offset != graph.getPlacement(chain[1]).offset);
+
+	// chain2 takes over chain0's memory and has to wait for its last read
+	auto aliasBarrier = findBarrier(graph.getBatches()[2], chain[2]);
+	REQUIRE(aliasBarrier);
+	REQUIRE(aliasBarrier->oldLayout == vk::ImageLayout::eUndefined);
+	REQUIRE(aliasBarrier->srcStages & vk::PipelineStageFlagBits2::eFragmentShader);
+}
+
+TEST_CASE("render graph orders async compute passes with queue waits")
+{
+	TestGraph test;
+	auto& graph = test.graph;
+	auto depth = graph.createImage("depth", describeImage(1920, 1080));
+	auto occlusion = graph.createImage("occlusion", describeImage(1920, 1080));
+	auto shadow = graph.createImage("shadow", describeImage(2048, 2048));
+
+	const vkr::ResourceUsage ComputeStorage{ vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderStorageWrite, vk::ImageLayout::eGeneral };
+
+	graph.addPass("depth").write(depth, ColorAttachment);
+	graph.addPass("occlusion").read(depth, ComputeSampled).write(occlusion, ComputeStorage).setAsyncCompute();
+	graph.addPass("shadow").write(shadow, ColorAttachment);
+	graph.addPass("lighting")
+		.read(occlusion, FragmentSampled)
+		.read(shadow, FragmentSampled)
+		.write(test.backbuffer, ColorAttachment);
+	graph.compile(queryMemoryRequirements);
+
+	// shadow overlaps the compute pass, each queue switch is a wait on the other queue
+	const auto& passes = graph.getPasses();
+	const auto& batches = graph.getBatches();
+	REQUIRE(batches.size() == 3);
+	REQUIRE(batches[1].passes == std::vector<uint32_t>{ 1 });
+	REQUIRE(batches[0].passes == std::vector<uint32_t>{ 0, 2 });
+	REQUIRE(passes[1].queueWaits == std::vector<uint32_t>{ 0 });
+	REQUIRE(passes[3].queueWaits == std::vector<uint32_t>{ 1 });
+	REQUIRE(passes[2].queueWaits.empty());
+
+	auto depthBarrier = findBarrier(batches[1], depth);
+	REQUIRE(depthBarrier);
+	REQUIRE(depthBarrier->queue == vkr::PassQueue::eAsyncCompute);
+	REQUIRE(depthBarrier->newLayout == vk::ImageLayout::eShaderReadOnlyOptimal);
+	REQUIRE(findBarrier(batches[2], occlusion)->queue == vkr::PassQueue::eGraphics);
+
+	// both queues use the occlusion image, it is kept out of the graphics heap
+	REQUIRE(graph.getPlacement(occlusion).queues == vkr::AllQueues);
+	REQUIRE(graph.getPlacement(shadow).heap != graph.getPlacement(occlusion).heap);
+}
+
+TEST_CASE("render graph submissions wait before the barriers of a batch")
+{
+	TestGraph test;
+	auto& graph = test.graph;
+	auto depth = graph.createImage("depth", describeImage(1920, 1080));
+	auto occlusion = graph.createImage("occlusion", describeImage(1920, 1080));
+	auto shadow = graph.createImage("shadow", describeImage(2048, 2048));
+	auto blurred = graph.createImage("blurred", describeImage(2048, 2048));
+	auto history = graph.createImage("history", describeImage(1920, 1080));
+
+	const vkr::ResourceUsage ComputeStorage{ vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderStorageWrite, vk::ImageLayout::eGeneral };
+
+	graph.addPass("depth").write(depth, ColorAttachment);
+	graph.addPass("occlusion").read(depth, ComputeSampled).write(occlusion, ComputeStorage).setAsyncCompute();
+	graph.addPass("shadow").write(shadow, ColorAttachment);
+	graph.addPass("blur").read(shadow, FragmentSampled).write(blurred, ColorAttachment);
+	// first graphics pass of the last batch, it does not depend on the compute queue
+	graph.addPass("history").read(blurred, FragmentSampled).write(history, ColorAttachment).setSideEffect();
+	graph.addPass("lighting").read(occlusion, FragmentSampled).write(test.backbuffer, ColorAttachment);
+	graph.compile(queryMemoryRequirements);
+
+	const auto& batches = graph.getBatches();
+	REQUIRE(batches.size() == 3);
+	REQUIRE(batches[2].passes == std::vector<uint32_t>{ 4, 5 });
+	REQUIRE(findBarrier(batches[2], occlusion)->queue == vkr::PassQueue::eGraphics);
+
+	auto recordedPasses = vkr::getRecordedPasses(graph, true);
+	REQUIRE(recordedPasses.size() == 6);
+	REQUIRE(recordedPasses[4].pass == 4);
+	REQUIRE(recordedPasses[4].recordsBarriers);
+	REQUIRE_FALSE(recordedPasses[5].recordsBarriers);
+
+	// history records the occlusion acquire, so its submission and not the one of lighting waits
+	auto plan = vkr::planSubmissions(graph, recordedPasses);
+	const auto& graphics = plan[0];
+	const auto& compute = plan[1];
+	REQUIRE(compute.size() == 1);
+	REQUIRE(compute[0].passes == std::vector<uint32_t>{ 2 });
+	REQUIRE(compute[0].waitValue == 1);
+	REQUIRE(graphics.size() == 3);
+	REQUIRE(graphics[0].passes == std::vector<uint32_t>{ 0, 1 });
+	REQUIRE(graphics[1].passes == std::vector<uint32_t>{ 3 });
+	REQUIRE(graphics[1].waitValue == 0);
+	REQUIRE(graphics[2].passes == std::vector<uint32_t>{ 4, 5, UINT32_MAX });
+	REQUIRE(graphics[2].waitValue == compute[0].signalValue);
+
+	// on a single queue nothing waits and every pass goes into one submission
+	auto singleQueuePlan = vkr::planSubmissions(graph, vkr::getRecordedPasses(graph, false));
+	REQUIRE(singleQueuePlan[1].empty());
+	REQUIRE(singleQueuePlan[0].size() == 1);
+	REQUIRE(singleQueuePlan[0][0].waitValue == 0);
+}
+
+TEST_CASE("render graph compile time for 500 passes", "[.][benchmark]")
+{
+	constexpr uint32_t PassCount = 500;
+	constexpr uint32_t CompileCount = 100;
+
+	TestGraph test;
+	auto& graph = test.graph;
+
+	// every pass renders one target and samples up to three of the recent ones, every
+	// seventh pass is a debug view nothing reads
+	std::vector<vkr::ResourceHandle> targets;
+	uint32_t seed = 1;
+	auto random = [&seed] { seed = seed * 1664525 + 1013904223; return seed >> 8; };
+	for (uint32_t pass = 0; pass < PassCount; pass++)
+	{
+		uint32_t size = 256u << (random() % 4);
+		auto target = graph.createImage(std::format("target{}", pass), describeImage(size, size));
+		auto builder = graph.addPass(std::format("pass{}", pass));
+		uint32_t readCount = std::min<uint32_t>(static_cast<uint32_t>(targets.size()), 1 + random() % 3);
+		for (uint32_t read = 0; read < readCount; read++)
+		{
+			builder.read(targets[targets.size() - 1 - random() % std::min<size_t>(targets.size(), 8)], FragmentSampled);
+		}
+		builder.write(target, ColorAttachment);
+		if (pass % 7 != 6)
+			targets.push_back(target);
+	}
+	graph.addPass("compose").read(targets.back(), FragmentSampled).write(test.backbuffer, ColorAttachment);
+
+	auto begin = std::chrono::steady_clock::now();
+	for (uint32_t index = 0; index < CompileCount; index++)
+	{
+		graph.compile(queryMemoryRequirements);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	const auto& statistics = graph.getStatistics();
+	REQUIRE(statistics.aliasedBytes <= statistics.transientBytes);
+
+	double microseconds = std::chrono::duration<double, std::micro>(end - begin).count() / CompileCount;
+	std::cout << std::format("{} passes ({} culled) in {} batches: {:.1f} us per compile, {} barriers in {} calls\n",
+		statistics.passCount, statistics.culledPassCount, statistics.batchCount, microseconds,
+		statistics.barrierCount, statistics.barrierBatchCount);
+	std::cout << std::format("{} transient images: {:.1f} MiB unaliased, {:.1f} MiB aliased ({:.0f}% saved)\n",
+		statistics.transientResourceCount, statistics.transientBytes / 1048576.0, statistics.aliasedBytes / 1048576.0,
+		100.0 * (1.0 - static_cast<double>(statistics.aliasedBytes) / statistics.transientBytes));
+}
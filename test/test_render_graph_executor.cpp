@@ -0,0 +1,109 @@
+#include <core/core.hpp>
+#include <exec/sync_wait.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <format>
+#include <optional>
+#include <thread>
+
+constexpr uint32_t PassCount = 500;
+constexpr uint32_t ChainLength = 8;
+constexpr uint32_t CommandsPerPass = 256;
+constexpr uint32_t FrameCount = 8;
+constexpr uint32_t FramesInFlight = 2;
+constexpr vk::DeviceSize BufferSize = 64 << 10;
+
+int main()
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::CommandPoolManager, vkr::RenderGraphExecutor>(physicalDevice);
+
+	vkr::CommandPoolManager commandPools{ device, FramesInFlight };
+	vkr::RenderGraphExecutor executor{ device, commandPools };
+
+	// chains of passes, each copies from the previous buffer of its chain and fills its own
+	// with many small commands; every third chain runs on the compute queue and feeds the
+	// next graphics chain, so both queues have independent work and wait for each other
+	const vkr::ResourceUsage TransferWrite{ vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite };
+	const vkr::ResourceUsage TransferRead{ vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferRead };
+
+	vkr::RenderGraph graph;
+	std::vector<vkr::ResourceHandle> buffers;
+	for (uint32_t pass = 0; pass < PassCount; pass++)
+	{
+		auto buffer = graph.createBuffer(std::format("buffer{}", pass), vkr::BufferDescription{ BufferSize,
+			vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst });
+		buffers.push_back(buffer);
+
+		uint32_t chain = pass / ChainLength;
+		std::optional<vkr::ResourceHandle> source;
+		if (pass % ChainLength != 0)
+			source = buffers[pass - 1];
+		else if (chain % 3 == 1)
+			source = buffers[pass - 1];
+
+		auto builder = graph.addPass(std::format("pass{}", pass),
+			[buffer, source](const vk::raii::CommandBuffer& commandBuffer, const vkr::RenderGraphResources& resources)
+			{
+				vk::Buffer dstBuffer = resources.getBuffer(buffer);
+				if (source)
+					commandBuffer.copyBuffer(resources.getBuffer(*source), dstBuffer, vk::BufferCopy{ 0, 0, 256 });
+				for (uint32_t command = 0; command < CommandsPerPass; command++)
+				{
+					commandBuffer.fillBuffer(dstBuffer, command * 256, 256, command);
+				}
+			});
+		if (source)
+			builder.read(*source, TransferRead);
+		builder.write(buffer, TransferWrite).setSideEffect();
+		if (chain % 3 == 0)
+			builder.setAsyncCompute();
+	}
+	graph.compile(device);
+
+	vkr::RenderGraphResources resources{ device };
+	resources.realize(graph, executor.getQueueFamilyIndices());
+
+	const auto& statistics = graph.getStatistics();
+	std::cout << std::format("{} passes in {} batches, async compute {}\n", statistics.passCount,
+		statistics.batchCount, executor.hasAsyncCompute() ? "on a dedicated queue" : "on the graphics queue");
+
+	auto runFrames = [&](uint32_t threadCount)
+		{
+			vkr::exec::thread_run_loop loop{ threadCount };
+			double recordSeconds = 0.0;
+			for (uint32_t frame = 0; frame < FrameCount; frame++)
+			{
+				commandPools.beginFrame(executor.getTimelineSemaphore(vkr::PassQueue::eGraphics));
+
+				auto begin = std::chrono::steady_clock::now();
+				auto recorded = vkr::exec::sync_wait<vkr::RecordedGraph>(
+					executor.record(vkr::exec::get_scheduler(loop), graph, resources));
+				auto end = std::chrono::steady_clock::now();
+				recordSeconds += std::chrono::duration<double>(end - begin).count();
+
+				auto submission = executor.submit(graph, recorded);
+				commandPools.endFrame(submission.graphicsValue);
+			}
+			device.waitIdle();
+			return recordSeconds / FrameCount;
+		};
+
+	uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	double serialSeconds = runFrames(1);
+	double parallelSeconds = runFrames(threadCount);
+	std::cout << std::format("recording {} passes: {:.2f} ms on 1 thread, {:.2f} ms on {} threads ({:.1f}x)\n",
+		statistics.passCount, serialSeconds * 1000.0, parallelSeconds * 1000.0, threadCount,
+		serialSeconds / parallelSeconds);
+
+	auto computeValue = executor.getTimelineSemaphore(vkr::PassQueue::eAsyncCompute).getCounterValue();
+	auto graphicsValue = executor.getTimelineSemaphore(vkr::PassQueue::eGraphics).getCounterValue();
+	if (executor.hasAsyncCompute() && computeValue == 0)
+	{
+		std::cout << "async compute passes were never submitted to the compute queue\n";
+		return 1;
+	}
+	std::cout << std::format("timelines: graphics {}, compute {}\n", graphicsValue, computeValue);
+}
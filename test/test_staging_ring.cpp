@@ -0,0 +1,112 @@
+#include <core/core.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <format>
+
+TEST_CASE("ring allocations are aligned bump allocations")
+{
+	vkr::RingAllocator ring{ 1024 };
+
+	REQUIRE(ring.allocate(10) == 0);
+	REQUIRE(ring.allocate(16, 64) == 64);
+	REQUIRE(ring.getUsedSize() == 80);
+}
+
+TEST_CASE("ring does not overwrite frames in flight")
+{
+	vkr::RingAllocator ring{ 1000 };
+
+	REQUIRE(ring.allocate(400) == 0);
+	ring.endFrame(1);
+	REQUIRE(ring.allocate(400) == 400);
+	ring.endFrame(2);
+
+	// 200 bytes left at the end and frame 1 still holds the start
+	REQUIRE_FALSE(ring.allocate(300));
+	REQUIRE(ring.getOldestRetireValue() == 1);
+
+	ring.retire(1);
+	REQUIRE(ring.allocate(300) == 0);
+	REQUIRE_FALSE(ring.allocate(200));
+	ring.endFrame(3);
+
+	ring.retire(2);
+	REQUIRE(ring.allocate(500) == 300);
+	ring.endFrame(4);
+
+	ring.retire(4);
+	REQUIRE(ring.getUsedSize() == 0);
+	REQUIRE_FALSE(ring.getOldestRetireValue());
+}
+
+TEST_CASE("staging ring upload throughput", "[.][benchmark]")
+{
+	constexpr vk::DeviceSize RingSize = 16ull << 20;
+	constexpr vk::DeviceSize FrameUploadSize = 8ull << 20;
+	constexpr vk::DeviceSize ChunkSize = 4096;
+	constexpr uint32_t FrameCount = 64;
+
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::StagingRing, vkr::SubmitBatcher>(physicalDevice);
+	const auto& queueFamily = device.getQueueFamilies()[0];
+	const auto& queue = queueFamily[0];
+
+	vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> semaphoreCreateInfo{
+		{}, vk::SemaphoreTypeCreateInfo{ vk::SemaphoreType::eTimeline, 0 } };
+	vk::raii::Semaphore timeline{ device, semaphoreCreateInfo.get<vk::SemaphoreCreateInfo>() };
+
+	vkr::StagingRing stagingRing{ device, timeline, RingSize };
+
+	vk::raii::Buffer dstBuffer{ device, vk::BufferCreateInfo{ {}, FrameUploadSize, vk::BufferUsageFlagBits::eTransferDst } };
+	auto dstAllocation = device.getMemoryAllocator().allocate(dstBuffer.getMemoryRequirements());
+	dstBuffer.bindMemory(dstAllocation.memory, dstAllocation.offset);
+
+	vk::raii::CommandPool commandPool{ device,
+		vk::CommandPoolCreateInfo{ vk::CommandPoolCreateFlagBits::eResetCommandBuffer, queueFamily.getQueueFamilyIndex() } };
+	vk::raii::CommandBuffers commandBuffers{ device,
+		vk::CommandBufferAllocateInfo{ *commandPool, vk::CommandBufferLevel::ePrimary, 2 } };
+
+	std::vector<std::byte> data(ChunkSize, std::byte{ 0x5a });
+
+	auto begin = std::chrono::steady_clock::now();
+	for (uint64_t frame = 1; frame <= FrameCount; frame++)
+	{
+		auto& commandBuffer = commandBuffers[frame % 2];
+		if (frame > 2)
+		{
+			uint64_t value = frame - 2;
+			vk::Semaphore semaphore = *timeline;
+			auto result = device.waitSemaphores(vk::SemaphoreWaitInfo{ {}, semaphore, value }, UINT64_MAX);
+		}
+
+		for (vk::DeviceSize offset = 0; offset < FrameUploadSize; offset += ChunkSize)
+		{
+			stagingRing.upload(*dstBuffer, offset, data);
+		}
+
+		commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+		stagingRing.recordCopies(*commandBuffer);
+		commandBuffer.end();
+
+		vk::CommandBufferSubmitInfo commandBufferInfo{ *commandBuffer };
+		vk::SemaphoreSubmitInfo signalInfo{ *timeline, frame, vk::PipelineStageFlagBits2::eAllTransfer };
+		vk::SubmitInfo2 submitInfo;
+		submitInfo.setCommandBufferInfos(commandBufferInfo);
+		submitInfo.setSignalSemaphoreInfos(signalInfo);
+		queue.submit2(submitInfo);
+		stagingRing.endFrame(frame);
+	}
+	device.waitIdle();
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - begin).count();
+	double megabytes = static_cast<double>(FrameUploadSize * FrameCount) / (1 << 20);
+	std::cout << std::format("staging ring: {:.1f} MB/s in {}KB uploads\n", megabytes / seconds, ChunkSize / 1024);
+
+	dstBuffer.clear();
+	device.getMemoryAllocator().free(dstAllocation);
+}
@@ -0,0 +1,75 @@
+#include <core/core.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <format>
+#include <stdexcept>
+
+constexpr uint32_t FrameCount = 100;
+constexpr uint32_t PassCount = 48;
+
+template<typename F>
+double measureFrames(const vkr::Device& device, const vk::raii::Fence& fence, F&& submitFrame)
+{
+	auto begin = std::chrono::steady_clock::now();
+	for (uint32_t frame = 0; frame < FrameCount; frame++)
+	{
+		submitFrame(*fence);
+		if (device.waitForFences({ *fence }, true, UINT64_MAX) != vk::Result::eSuccess)
+			throw std::runtime_error(std::format("Failed to wait for frame {}", frame));
+		device.resetFences({ *fence });
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::micro>(end - begin).count() / FrameCount;
+}
+
+int main()
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::SubmitBatcher>(physicalDevice);
+
+	const auto& queueFamily = device.getQueueFamilies()[0];
+	const auto& queue = queueFamily[0];
+
+	vk::raii::CommandPool commandPool{ device,
+		vk::CommandPoolCreateInfo{ {}, queueFamily.getQueueFamilyIndex() } };
+	vk::raii::CommandBuffers commandBuffers{ device,
+		vk::CommandBufferAllocateInfo{ *commandPool, vk::CommandBufferLevel::ePrimary, PassCount } };
+	for (auto& commandBuffer : commandBuffers)
+	{
+		commandBuffer.begin(vk::CommandBufferBeginInfo{});
+		commandBuffer.end();
+	}
+
+	vk::raii::Fence fence{ device, vk::FenceCreateInfo{} };
+
+	uint64_t directSubmitCount = 0;
+	double directTime = measureFrames(device, fence, [&](vk::Fence frameFence)
+		{
+			for (uint32_t pass = 0; pass < PassCount; pass++)
+			{
+				vk::CommandBufferSubmitInfo commandBufferInfo{ *commandBuffers[pass] };
+				vk::SubmitInfo2 submitInfo;
+				submitInfo.setCommandBufferInfos(commandBufferInfo);
+				queue.submit2(submitInfo, pass + 1 == PassCount ? frameFence : vk::Fence{});
+				directSubmitCount++;
+			}
+		});
+
+	vkr::SubmitBatcher batcher{ queue };
+	double batchedTime = measureFrames(device, fence, [&](vk::Fence frameFence)
+		{
+			for (uint32_t pass = 0; pass < PassCount; pass++)
+			{
+				batcher.push(*commandBuffers[pass]);
+			}
+			batcher.flush(frameFence);
+		});
+	auto statistics = batcher.getStatistics();
+
+	std::cout << std::format("direct:  {} submits per frame, {:.1f} us per frame\n",
+		directSubmitCount / FrameCount, directTime);
+	std::cout << std::format("batched: {} submits per frame, {:.1f} us per frame\n",
+		statistics.submitCount / FrameCount, batchedTime);
+}
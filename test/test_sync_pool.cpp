@@ -0,0 +1,81 @@
+#include <core/core.hpp>
+
+#include <deque>
+#include <iostream>
+#include <format>
+
+constexpr uint32_t FrameCount = 64;
+constexpr uint32_t FramesInFlight = 3;
+
+int main()
+{
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::SubmitBatcher, vkr::SemaphorePool>(physicalDevice);
+	const auto& queue = device.getQueueFamilies()[0][0];
+
+	auto& fencePool = device.getFencePool();
+	auto& semaphorePool = device.getSemaphorePool();
+
+	// retires the binary semaphores, owned by the pool like everything else
+	auto frameTimeline = semaphorePool.acquireTimeline();
+	std::deque<vk::Fence> framesInFlight;
+	uint64_t steadyStateCreations = 0;
+
+	for (uint32_t frame = 0; frame < FrameCount; frame++)
+	{
+		uint64_t createdBefore = fencePool.getCreatedCount()
+			+ semaphorePool.getCreatedBinaryCount() + semaphorePool.getCreatedTimelineCount();
+
+		if (framesInFlight.size() == FramesInFlight)
+		{
+			vk::Fence oldestFence = framesInFlight.front();
+			framesInFlight.pop_front();
+			fencePool.waitAndRelease({ &oldestFence, 1 });
+		}
+
+		// two submissions chained by a binary semaphore, the second signals the frame
+		// timeline, a per frame timeline and the frame fence
+		vk::Semaphore passSemaphore = semaphorePool.acquireBinary();
+		auto passTimeline = semaphorePool.acquireTimeline();
+		vk::Fence frameFence = fencePool.acquire();
+		uint64_t frameValue = ++frameTimeline.value;
+
+		vk::SemaphoreSubmitInfo passSignal{ passSemaphore, 0, vk::PipelineStageFlagBits2::eAllCommands };
+		vk::SubmitInfo2 firstSubmit;
+		firstSubmit.setSignalSemaphoreInfos(passSignal);
+		queue.submit2(firstSubmit);
+
+		std::array frameSignals{
+			vk::SemaphoreSubmitInfo{ frameTimeline.semaphore, frameValue, vk::PipelineStageFlagBits2::eAllCommands },
+			vk::SemaphoreSubmitInfo{ passTimeline.semaphore, passTimeline.value + 1, vk::PipelineStageFlagBits2::eAllCommands },
+		};
+		vk::SubmitInfo2 secondSubmit;
+		secondSubmit.setWaitSemaphoreInfos(passSignal);
+		secondSubmit.setSignalSemaphoreInfos(frameSignals);
+		queue.submit2(secondSubmit, frameFence);
+
+		semaphorePool.releaseBinary(passSemaphore, frameTimeline.semaphore, frameValue);
+		semaphorePool.releaseTimeline(passTimeline.semaphore, passTimeline.value + 1);
+		framesInFlight.push_back(frameFence);
+
+		uint64_t creations = fencePool.getCreatedCount()
+			+ semaphorePool.getCreatedBinaryCount() + semaphorePool.getCreatedTimelineCount() - createdBefore;
+		if (frame >= FrameCount / 2)
+			steadyStateCreations += creations;
+		std::cout << std::format("frame {}: {} sync objects created\n", frame, creations);
+	}
+
+	std::vector<vk::Fence> remainingFences{ framesInFlight.begin(), framesInFlight.end() };
+	fencePool.waitAndRelease(remainingFences);
+
+	std::cout << std::format("created {} fences, {} binary and {} timeline semaphores over {} frames\n",
+		fencePool.getCreatedCount(), semaphorePool.getCreatedBinaryCount(),
+		semaphorePool.getCreatedTimelineCount(), FrameCount);
+
+	if (steadyStateCreations != 0)
+	{
+		std::cout << std::format("{} sync objects created in steady state\n", steadyStateCreations);
+		return 1;
+	}
+}
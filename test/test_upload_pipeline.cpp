@@ -0,0 +1,114 @@
+#include <core/core.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <format>
+#include <latch>
+
+constexpr uint32_t AssetCount = 32;
+constexpr size_t AssetSize = 4 << 20;
+
+struct UploadReceiver
+{
+	struct is_receiver {};
+
+	friend void tag_invoke(vkr::exec::set_value_t, UploadReceiver&& self, uint64_t) noexcept
+	{
+		self.latch->count_down();
+	}
+
+	friend void tag_invoke(vkr::exec::set_error_t, UploadReceiver&& self, std::exception_ptr eptr) noexcept
+	{
+		try {
+			std::rethrow_exception(eptr);
+		} catch (const std::exception& e) {
+			std::cout << "upload failed: " << e.what() << '\n';
+		}
+		self.latch->count_down();
+	}
+
+	friend void tag_invoke(vkr::exec::set_stopped_t, UploadReceiver&& self) noexcept
+	{
+		self.latch->count_down();
+	}
+
+	std::latch* latch;
+};
+
+int main()
+{
+	auto assetDirectory = std::filesystem::temp_directory_path() / "vkr_upload_pipeline";
+	std::filesystem::create_directories(assetDirectory);
+	std::vector<std::filesystem::path> assets;
+	std::vector<char> content(AssetSize, 'a');
+	for (uint32_t index = 0; index < AssetCount; index++)
+	{
+		auto path = assetDirectory / std::format("asset_{}.bin", index);
+		// the first asset is empty, it completes without copying or releasing anything
+		std::ofstream{ path, std::ios::binary }.write(content.data(), index == 0 ? 0 : content.size());
+		assets.push_back(path);
+	}
+
+	auto instance = vkr::createInstance();
+	auto physicalDevice = instance.getPhysicalDevice();
+	auto device = vkr::createDevice<vkr::UploadPipeline>(physicalDevice);
+
+	// prefer a transfer only family, the pipeline then releases ownership to graphics
+	const vkr::QueueFamily* graphicsFamily = nullptr;
+	const vkr::QueueFamily* transferFamily = nullptr;
+	auto queueFamilyProperties = physicalDevice.getQueueFamilyProperties();
+	for (const auto& queueFamily : device.getQueueFamilies())
+	{
+		auto flags = queueFamilyProperties[queueFamily.getQueueFamilyIndex()].queueFlags;
+		if (!graphicsFamily && (flags & vk::QueueFlagBits::eGraphics))
+			graphicsFamily = &queueFamily;
+		else if (!transferFamily && (flags & vk::QueueFlagBits::eTransfer))
+			transferFamily = &queueFamily;
+	}
+	if (!transferFamily)
+		transferFamily = graphicsFamily;
+
+	vkr::UploadPipeline pipeline{ device, transferFamily->front(), graphicsFamily->getQueueFamilyIndex() };
+
+	std::vector<vk::raii::Buffer> buffers;
+	std::vector<vkr::MemoryAllocation> allocations;
+	for (uint32_t index = 0; index < AssetCount; index++)
+	{
+		auto& buffer = buffers.emplace_back(device,
+			vk::BufferCreateInfo{ {}, AssetSize, vk::BufferUsageFlagBits::eTransferDst });
+		allocations.push_back(device.getMemoryAllocator().allocate(buffer.getMemoryRequirements()));
+		buffer.bindMemory(allocations.back().memory, allocations.back().offset);
+	}
+
+	std::latch latch{ AssetCount };
+	auto startUpload = [&](uint32_t index)
+		{
+			auto operation = new auto(vkr::exec::connect(
+				pipeline.upload(assets[index], *buffers[index]), UploadReceiver{ &latch }));
+			vkr::exec::start(*operation);
+			return std::unique_ptr<std::remove_pointer_t<decltype(operation)>>{ operation };
+		};
+
+	auto begin = std::chrono::steady_clock::now();
+	std::vector<decltype(startUpload(0))> operations;
+	for (uint32_t index = 0; index < AssetCount; index++)
+	{
+		operations.push_back(startUpload(index));
+	}
+	latch.wait();
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - begin).count();
+	double megabytes = static_cast<double>(pipeline.getUploadedBytes()) / (1 << 20);
+	std::cout << std::format("upload pipeline: {:.1f} MB in {:.3f} s, {:.1f} MB/s\n",
+		megabytes, seconds, megabytes / seconds);
+
+	device.waitIdle();
+	buffers.clear();
+	for (const auto& allocation : allocations)
+	{
+		device.getMemoryAllocator().free(allocation);
+	}
+	std::filesystem::remove_all(assetDirectory);
+}
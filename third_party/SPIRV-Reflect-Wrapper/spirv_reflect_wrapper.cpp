@@ -38,8 +38,11 @@ void throwSPIRVResult(SpvReflectResult result)
 }
 
 SpvReflectShaderModule::SpvReflectShaderModule(size_t size, const uint32_t *p_code)
+    : SpvReflectShaderModule{size, p_code, SPV_REFLECT_MODULE_FLAG_NONE} {}
+
+SpvReflectShaderModule::SpvReflectShaderModule(size_t size, const uint32_t *p_code, SpvReflectModuleFlags flags)
 {
-    auto result = spvReflectCreateShaderModule(size * 4, p_code, &module);
+    auto result = spvReflectCreateShaderModule2(flags, size * 4, p_code, &module);
     throwSPIRVResult(result);
 }
 
@@ -105,11 +108,12 @@ size_t getInterfaceVariableSize(const SpvReflectInterfaceVariable& variable)
     {
         baseSize += getInterfaceVariableSize(variable.members[index]);
     }
-    if(variable.numeric.vector.component_count)
-        baseSize = variable.numeric.scalar.width * variable.numeric.vector.component_count;
-    else if(variable.numeric.matrix.column_count && variable.numeric.matrix.row_count)
+    // a matrix also has the component count of its columns, it is checked first
+    if(variable.numeric.matrix.column_count && variable.numeric.matrix.row_count)
         baseSize = variable.numeric.scalar.width * variable.numeric.matrix.column_count *
             variable.numeric.matrix.row_count;
+    else if(variable.numeric.vector.component_count)
+        baseSize = variable.numeric.scalar.width * variable.numeric.vector.component_count;
     else
         baseSize = variable.numeric.scalar.width;
     
@@ -5,6 +5,7 @@
 #include <string>
 #include <stdexcept>
 #include <format>
+#include <ranges>
 
 namespace spv_reflect_wrapper
 {
@@ -16,6 +17,9 @@ class SpvReflectShaderModule
 {
 public:
     SpvReflectShaderModule(size_t size, const uint32_t *p_code);
+    // with SPV_REFLECT_MODULE_FLAG_NO_COPY the module reads p_code instead of a copy of it,
+    // the code has to outlive the module, e.g. a memory mapped vkr::SpirvFile
+    SpvReflectShaderModule(size_t size, const uint32_t *p_code, SpvReflectModuleFlags flags);
     ~SpvReflectShaderModule() noexcept;
     template<class T>
     SpvReflectShaderModule(size_t size, const T* p_code)
@@ -23,6 +27,12 @@ public:
     template<class T>
     SpvReflectShaderModule(const T& data)requires requires(T obj){ obj.size(); obj.data(); }
         : SpvReflectShaderModule{data.size(), data.data()} {}
+    template<class T>
+    SpvReflectShaderModule(const T& data, SpvReflectModuleFlags flags)requires requires(T obj){ obj.size(); obj.data(); }
+        : SpvReflectShaderModule{data.size()*sizeof(*data.data())/sizeof(uint32_t), reinterpret_cast<const uint32_t*>(data.data()), flags} {}
+    // the module may keep reading the code, a temporary owning it would be gone after construction
+    template<class T>
+    SpvReflectShaderModule(const T&& data, SpvReflectModuleFlags flags)requires (!std::ranges::borrowed_range<T>) = delete;
 
     std::vector<SpvReflectInterfaceVariable*> enumerateInputVariables() const;
     std::vector<SpvReflectInterfaceVariable*> enumerateOutputVariables() const;
@@ -3,9 +3,41 @@
 #include <vector>
 #include <fstream>
 #include <string>
+#include <string_view>
+#include <array>
 #include <iostream>
+#include <sstream>
 #include <format>
 #include <filesystem>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <bit>
+#include <cmath>
+#include <span>
+#include <optional>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+#include <exec/execution.hpp>
+#include <exec/scheduler.hpp>
+#include <exec/sync_wait.hpp>
+#include <core/shader_compression.hpp>
+#include <core/spirv_file.hpp>
 
 #include "spirv_reflect_wrapper.hpp"
 
@@ -87,29 +119,166 @@ std::string getField(const SpvReflectTypeDescription& type, std::string name)
     return std::format("{} {}{};\n", getType(type), name, arrays);
 }
 
-// std::string getSpecConstantField(const SpvReflectSpecializationConstant& constant)
-// {
-//     switch (constant.constant_type) 
-//     {
-//         case SPV_REFLECT_SPECIALIZATION_CONSTANT_BOOL:
-//             return std::format("bool {} = {};\n", constant.name, constant.default_value.int_bool_value);
-//         case SPV_REFLECT_SPECIALIZATION_CONSTANT_INT:
-//             return std::format("int {} = {};\n", constant.name, constant.default_value.int_bool_value);
-//         case SPV_REFLECT_SPECIALIZATION_CONSTANT_FLOAT:
-//             return std::format("float {} = {};\n", constant.name, constant.default_value.float_value);
-//     }
-// }
+struct BlockLayout
+{
+    uint32_t size = 0;
+    uint32_t alignment = 1;
+};
+
+uint32_t roundUp(uint32_t value, uint32_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// matrix columns are MatrixStride apart, so the padding std140 puts after a mat3 column
+// is part of the type; glm is column major and gets the transpose of a row major matrix
+std::string getBlockMathType(const SpvReflectBlockVariable& member, BlockLayout& layout)
+{
+    const auto& type = *member.type_description;
+    std::string dataType = getDataType(type);
+    uint32_t scalarSize = type.traits.numeric.scalar.width / 8;
+    layout.alignment = scalarSize;
+    if(type.type_flags & SPV_REFLECT_TYPE_FLAG_MATRIX)
+    {
+        bool rowMajor = member.decoration_flags & SPV_REFLECT_DECORATION_ROW_MAJOR;
+        uint32_t vectorCount = rowMajor ? type.traits.numeric.matrix.row_count : type.traits.numeric.matrix.column_count;
+        uint32_t stride = member.numeric.matrix.stride;
+        layout.size = vectorCount * stride;
+        return std::format("glm::mat<{}, {}, {}>", vectorCount, stride / scalarSize, dataType);
+    }
+    if(type.type_flags & SPV_REFLECT_TYPE_FLAG_VECTOR)
+    {
+        layout.size = type.traits.numeric.vector.component_count * scalarSize;
+        return std::format("glm::vec<{}, {}>", type.traits.numeric.vector.component_count, dataType);
+    }
+    layout.size = scalarSize;
+    return dataType;
+}
+
+std::string getBlockTypeName(const SpvReflectTypeDescription& type, const std::string& name)
+{
+    if(type.type_name && *type.type_name)
+        return type.type_name;
+    return std::format("{}Type", name);
+}
+
+// every member sits at its SPIR-V Offset, explicit padding fills the gaps std140 and std430
+// leave and array elements are padded to ArrayStride, so the struct can be copied into a
+// mapped buffer as is; the checks assert the layout the compiler gave it
+std::string getBlockStruct(const SpvReflectBlockVariable& block, const std::string& typeName,
+    const std::string& scope, std::string& checks, BlockLayout& layout)
+{
+    std::string types;
+    std::string fields;
+    std::vector<std::string> definedTypes;
+    uint32_t paddingCount = 0;
+    bool runtimeArray = false;
+    layout = {};
+    for(uint32_t index = 0; index < block.member_count && !runtimeArray; index++)
+    {
+        const auto& member = block.members[index];
+        if(member.offset > layout.size)
+        {
+            fields += std::format("std::byte _padding{}[{}];\n", paddingCount++, member.offset - layout.size);
+            layout.size = member.offset;
+        }
+
+        BlockLayout element;
+        std::string elementType;
+        if(member.type_description->type_flags & SPV_REFLECT_TYPE_FLAG_STRUCT)
+        {
+            elementType = getBlockTypeName(*member.type_description, member.name);
+            std::string typeChecks;
+            std::string definition = getBlockStruct(member, elementType, scope + "::" + elementType, typeChecks, element);
+            if(std::find(definedTypes.begin(), definedTypes.end(), elementType) == definedTypes.end())
+            {
+                definedTypes.push_back(elementType);
+                types += definition + ";\n";
+                checks += typeChecks;
+            }
+        }
+        else
+        {
+            elementType = getBlockMathType(member, element);
+        }
+
+        std::string arrays;
+        uint32_t count = 1;
+        if(member.array.dims_count > 0)
+        {
+            // ArrayStride separates the outermost elements, inner arrays are packed in between
+            uint32_t innerCount = 1;
+            for(uint32_t dim = 0; dim < member.array.dims_count; dim++)
+            {
+                arrays += std::format("[{}]", member.array.dims[dim]);
+                count *= member.array.dims[dim];
+                if(dim > 0)
+                    innerCount *= member.array.dims[dim];
+            }
+            uint32_t stride = member.array.stride / innerCount;
+            if(stride > element.size)
+            {
+                elementType = std::format("Padded<{}, {}>", elementType, stride);
+                element.size = stride;
+            }
+            runtimeArray = member.array.dims[0] == SPV_REFLECT_ARRAY_DIM_RUNTIME;
+        }
+        layout.alignment = std::max(layout.alignment, element.alignment);
+
+        // a runtime array is not part of the struct, its elements follow it in the buffer
+        if(runtimeArray)
+        {
+            fields += std::format("using {}Element = {};\n", member.name, elementType);
+            checks += std::format("static_assert(sizeof({}::{}Element) == {});\n", scope, member.name, element.size);
+            continue;
+        }
+
+        fields += std::format("{} {}{};\n", elementType, member.name, arrays);
+        checks += std::format("static_assert(offsetof({}, {}) == {});\n", scope, member.name, member.offset);
+        layout.size += element.size * count;
+    }
+
+    if(!runtimeArray)
+        layout.size = roundUp(layout.size, layout.alignment);
+    if(layout.size > 0)
+        checks += std::format("static_assert(sizeof({}) == {});\n", scope, layout.size);
+    return std::format("struct {}\n{{\n{}{}}}", typeName, types, fields);
+}
+
+std::string getBlockField(const SpvReflectBlockVariable& block, const SpvReflectTypeDescription& type,
+    const std::string& name, const std::string& scope, std::string& checks)
+{
+    std::string arrays;
+    for(uint32_t index = 0; index < type.traits.array.dims_count; index++)
+    {
+        arrays = arrays + std::format("[{}]", type.traits.array.dims[index]);
+    }
+    BlockLayout layout;
+    std::string typeName = getBlockTypeName(type, name);
+    return std::format("{} {}{};\n", getBlockStruct(block, typeName, scope + "::" + typeName, checks, layout), name, arrays);
+}
+
+bool isBufferBinding(const SpvReflectDescriptorBinding& binding)
+{
+    return binding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+        binding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+        binding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+        binding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
 
-void printDescriptorBinding(std::ostream& out, const SpvReflectDescriptorBinding& binding)
+void printDescriptorBinding(std::ostream& out, const SpvReflectDescriptorBinding& binding, std::string& checks)
 {
-    out << getField(*(binding.type_description), binding.name);
+    if(isBufferBinding(binding))
+        out << getBlockField(binding.block, *(binding.type_description), binding.name, "Descriptor", checks);
+    else
+        out << getField(*(binding.type_description), binding.name);
 }
 
-void printDescriptorSet(std::ostream& out, const SpvReflectDescriptorSet& set)
+void printDescriptorSet(std::ostream& out, const SpvReflectDescriptorSet& set, std::string& checks)
 {
     for(uint32_t index = 0; index < set.binding_count; index++)
     {
-        printDescriptorBinding(out, *set.bindings[index]);
+        printDescriptorBinding(out, *set.bindings[index], checks);
     }
 }
 
@@ -118,25 +287,428 @@ void printInterfaceVariable(std::ostream& out, const SpvReflectInterfaceVariable
     out << getField(*(variable.type_description), variable.name);
 }
 
-void printPushConstant(std::ostream& out, const SpvReflectBlockVariable& constant)
+void printPushConstant(std::ostream& out, const SpvReflectBlockVariable& constant, std::string& checks)
 {
-    out << getField(*(constant.type_description), constant.name);
+    out << getBlockField(constant, *(constant.type_description), constant.name, "PushConstant", checks);
 }
 
-// void printSpecConstant(std::ostream& out, const SpvReflectSpecializationConstant& specConstant)
-// {
-//     out << getSpecConstantField(specConstant);
-// }
+// C++ type and default value of a specialization constant, SPIRV-Reflect only reports its ids
+struct SpecConstantValue
+{
+    std::string type;
+    std::string value;
+};
 
-void printShader(std::ostream& out, const spv_reflect_wrapper::SpvReflectShaderModule& module)
+std::string getFloatLiteral(double value, std::string_view suffix)
 {
-    out << "struct Descriptor\n{\n";
+    std::string literal = std::format("{}", value);
+    if(literal.find_first_of(".e") == std::string::npos)
+        literal += ".0";
+    return literal + std::string{suffix};
+}
+
+SpecConstantValue getSpecConstantValue(uint32_t opcode, std::span<const uint32_t> type, std::span<const uint32_t> value)
+{
+    constexpr uint32_t OpTypeBool = 20;
+    constexpr uint32_t OpTypeInt = 21;
+    constexpr uint32_t OpSpecConstantTrue = 48;
+
+    // booleans are read as VkBool32
+    if((type[0] & 0xFFFF) == OpTypeBool)
+        return {"vk::Bool32", opcode == OpSpecConstantTrue ? "VK_TRUE" : "VK_FALSE"};
+
+    uint32_t width = type[2];
+    uint64_t bits = value[0];
+    if(width == 64)
+        bits |= static_cast<uint64_t>(value[1]) << 32;
+
+    if((type[0] & 0xFFFF) == OpTypeInt)
+    {
+        bool isSigned = type[3] != 0;
+        std::string name = std::format("{}int{}_t", isSigned ? "" : "u", width);
+        // constants narrower than 32 bits are sign extended into their word when signed
+        if(!isSigned)
+            return {name, std::format("{}u", bits)};
+        int64_t signedBits = width == 64 ? static_cast<int64_t>(bits) : static_cast<int32_t>(bits);
+        if(signedBits == INT64_MIN)
+            return {name, "INT64_MIN"};
+        return {name, std::format("{}", signedBits)};
+    }
+
+    if(width == 32 && std::isfinite(std::bit_cast<float>(static_cast<uint32_t>(bits))))
+        return {"float", getFloatLiteral(std::bit_cast<float>(static_cast<uint32_t>(bits)), "f")};
+    if(width == 64 && std::isfinite(std::bit_cast<double>(bits)))
+        return {"double", getFloatLiteral(std::bit_cast<double>(bits), "")};
+    if(width == 32)
+        return {"float", std::format("std::bit_cast<float>({:#x}u)", bits)};
+    if(width == 64)
+        return {"double", std::format("std::bit_cast<double>({:#x}ull)", bits)};
+    throw std::runtime_error(std::format("{} bit floating point specialization constants are not supported", width));
+}
+
+// the OpSpecConstant* instructions by result id, with the type they were declared with
+std::unordered_map<uint32_t, SpecConstantValue> getSpecConstantValues(std::span<const uint32_t> code)
+{
+    constexpr uint32_t OpTypeBool = 20;
+    constexpr uint32_t OpTypeFloat = 22;
+    constexpr uint32_t OpSpecConstantTrue = 48;
+    constexpr uint32_t OpSpecConstant = 50;
+
+    std::unordered_map<uint32_t, std::span<const uint32_t>> types;
+    std::unordered_map<uint32_t, SpecConstantValue> values;
+    // the instructions follow the 5 word header
+    for(size_t index = 5; index < code.size();)
+    {
+        uint32_t opcode = code[index] & 0xFFFF;
+        uint32_t wordCount = code[index] >> 16;
+        if(wordCount == 0 || index + wordCount > code.size())
+            throw std::runtime_error("Malformed SPIR-V instruction stream");
+
+        auto instruction = code.subspan(index, wordCount);
+        if(opcode >= OpTypeBool && opcode <= OpTypeFloat)
+            types[instruction[1]] = instruction;
+        else if(opcode >= OpSpecConstantTrue && opcode <= OpSpecConstant)
+        {
+            auto type = types.find(instruction[1]);
+            if(type == types.end())
+                throw std::runtime_error(std::format("Specialization constant %{} has no scalar type", instruction[2]));
+            values[instruction[2]] = getSpecConstantValue(opcode, type->second, instruction.subspan(3));
+        }
+        index += wordCount;
+    }
+    return values;
+}
+
+// a struct with the default values and its map entries, a pipeline specializes the shader
+// with a modified copy instead of compiling another permutation of it
+void printSpecConstants(std::ostream& out, const spv_reflect_wrapper::SpvReflectShaderModule& module, std::span<const uint32_t> code)
+{
+    auto specConstants = module.enumerateSpecializationConstants();
+    std::sort(specConstants.begin(), specConstants.end(), [](const auto* a, const auto* b){ return a->constant_id < b->constant_id; });
+    auto values = getSpecConstantValues(code);
+
+    std::string entries;
+    out << "struct SpecializationConstants\n{\n";
+    for(const auto& constant : specConstants)
+    {
+        const auto& value = values.at(constant->spirv_id);
+        std::string name = constant->name && *constant->name ? constant->name : std::format("constant{}", constant->constant_id);
+        out << std::format("{} {} = {};\n", value.type, name, value.value);
+        entries += std::format("    vk::SpecializationMapEntry{{ {}, offsetof(SpecializationConstants, {}), sizeof({}) }},\n",
+            constant->constant_id, name, value.type);
+    }
+    out << "};\n";
+    out << std::format("inline constexpr std::array<vk::SpecializationMapEntry, {}> specializationMapEntries{{\n{}}};\n",
+        specConstants.size(), entries);
+
+    // the returned info points at constants, they have to outlive the pipeline creation
+    out << std::format("constexpr vk::SpecializationInfo getSpecializationInfo(const SpecializationConstants& constants)\n{{\n"
+        "    return vk::SpecializationInfo{{ {}, specializationMapEntries.data(), {}, &constants }};\n}}\n",
+        specConstants.size(), specConstants.empty() ? "0" : "sizeof(SpecializationConstants)");
+    out << "inline constexpr SpecializationConstants specializationConstants{};\n";
+    out << "inline constexpr vk::SpecializationInfo specializationInfo = getSpecializationInfo(specializationConstants);\n\n";
+}
+
+struct ShaderOptions
+{
+    // one vertex buffer per stage input instead of one interleaved buffer
+    bool vertexStreams = false;
+    // stage input name and the compressed format its vertex data is stored in
+    std::vector<std::pair<std::string, std::string>> vertexFormats;
+    // SPIR-V embedded instead of the reflected one, e.g. a stripped or optimized copy of it
+    std::string codeFilename;
+    // embeds vkr::compressSpirv data as compressedCode instead of code, for a vkr::ShaderLibrary
+    bool compress = false;
+};
+
+struct VertexFormat
+{
+    std::string_view name;
+    std::string_view format;
+    std::string_view type;
+    uint32_t size;
+    uint32_t alignment;
+};
+
+// formats a float stage input can be compressed to, the half float ones hold the bits
+// of glm::packHalf; 8 and 16 bit formats with three components are left out as few
+// devices read vertex buffers in them
+constexpr std::array<VertexFormat, 11> CompressedVertexFormats{{
+    {"r16g16_sfloat", "vk::Format::eR16G16Sfloat", "glm::vec<2, uint16_t>", 4, 2},
+    {"r16g16b16a16_sfloat", "vk::Format::eR16G16B16A16Sfloat", "glm::vec<4, uint16_t>", 8, 2},
+    {"r16g16_unorm", "vk::Format::eR16G16Unorm", "glm::vec<2, uint16_t>", 4, 2},
+    {"r16g16_snorm", "vk::Format::eR16G16Snorm", "glm::vec<2, int16_t>", 4, 2},
+    {"r16g16b16a16_unorm", "vk::Format::eR16G16B16A16Unorm", "glm::vec<4, uint16_t>", 8, 2},
+    {"r16g16b16a16_snorm", "vk::Format::eR16G16B16A16Snorm", "glm::vec<4, int16_t>", 8, 2},
+    {"r8g8b8a8_unorm", "vk::Format::eR8G8B8A8Unorm", "glm::vec<4, uint8_t>", 4, 1},
+    {"r8g8b8a8_snorm", "vk::Format::eR8G8B8A8Snorm", "glm::vec<4, int8_t>", 4, 1},
+    {"a2b10g10r10_unorm_pack32", "vk::Format::eA2B10G10R10UnormPack32", "uint32_t", 4, 4},
+    {"a2b10g10r10_snorm_pack32", "vk::Format::eA2B10G10R10SnormPack32", "uint32_t", 4, 4},
+    {"r32_sfloat", "vk::Format::eR32Sfloat", "float", 4, 4},
+}};
+
+struct VertexInput
+{
+    std::string name;
+    std::string type;
+    std::string arrays;
+    std::string format;
+    uint32_t location;
+    // a matrix takes one location per column, an array one per element
+    uint32_t locationCount;
+    uint32_t locationSize;
+    uint32_t alignment;
+};
+
+// the format SPIR-V declares the input with, one location of it
+std::string getInputFormat(const SpvReflectTypeDescription& type, uint32_t componentCount)
+{
+    uint32_t width = type.traits.numeric.scalar.width;
+    std::string channels;
+    for(uint32_t index = 0; index < componentCount; index++)
+    {
+        channels += std::format("{}{}", "RGBA"[index], width);
+    }
+    std::string numeric = (type.type_flags & SPV_REFLECT_TYPE_FLAG_FLOAT) ? "Sfloat" :
+        type.traits.numeric.scalar.signedness ? "Sint" : "Uint";
+    return std::format("vk::Format::e{}{}", channels, numeric);
+}
+
+VertexInput getVertexInput(const SpvReflectInterfaceVariable& variable, const ShaderOptions& options)
+{
+    const auto& type = *variable.type_description;
+    VertexInput input{variable.name, "", "", "", variable.location, 1, 0, type.traits.numeric.scalar.width / 8};
+    uint32_t componentCount = 1;
+    if(type.type_flags & SPV_REFLECT_TYPE_FLAG_MATRIX)
+    {
+        input.type = getMathType(type);
+        input.locationCount = type.traits.numeric.matrix.column_count;
+        componentCount = type.traits.numeric.matrix.row_count;
+    }
+    else if(type.type_flags & SPV_REFLECT_TYPE_FLAG_VECTOR)
+    {
+        input.type = getMathType(type);
+        componentCount = type.traits.numeric.vector.component_count;
+    }
+    else
+    {
+        input.type = getDataType(type);
+    }
+    input.format = getInputFormat(type, componentCount);
+    input.locationSize = componentCount * input.alignment;
+
+    for(uint32_t index = 0; index < type.traits.array.dims_count; index++)
+    {
+        input.arrays += std::format("[{}]", type.traits.array.dims[index]);
+        input.locationCount *= type.traits.array.dims[index];
+    }
+
+    auto selected = std::find_if(options.vertexFormats.begin(), options.vertexFormats.end(),
+        [&input](const auto& vertexFormat){ return vertexFormat.first == input.name; });
+    if(selected == options.vertexFormats.end())
+        return input;
+
+    auto format = std::find_if(CompressedVertexFormats.begin(), CompressedVertexFormats.end(),
+        [&selected](const VertexFormat& format){ return format.name == selected->second; });
+    if(format == CompressedVertexFormats.end())
+        throw std::runtime_error(std::format("Unknown vertex format {} for {}", selected->second, input.name));
+    if(!(type.type_flags & SPV_REFLECT_TYPE_FLAG_FLOAT) || input.locationCount != 1)
+        throw std::runtime_error(std::format("Only float scalar and vector inputs can be compressed, {} is not one", input.name));
+
+    input.type = format->type;
+    input.format = format->format;
+    input.locationSize = format->size;
+    input.alignment = format->alignment;
+    return input;
+}
+
+// vertex buffer layout of the stage inputs, interleaved in one binding or one binding per
+// input in location order; the struct has no padding as long as every input is at least
+// as wide as the ones after it or all are multiples of four bytes
+void printVertexInput(std::ostream& out, const spv_reflect_wrapper::SpvReflectShaderModule& module, const ShaderOptions& options)
+{
+    std::vector<VertexInput> inputs;
+    size_t fullSize = 0;
+    for(const auto& variable : module.enumerateInputVariables())
+    {
+        if(variable->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN)
+            continue;
+        inputs.push_back(getVertexInput(*variable, options));
+        fullSize += spv_reflect_wrapper::getInterfaceVariableSize(*variable);
+    }
+    std::sort(inputs.begin(), inputs.end(), [](const VertexInput& a, const VertexInput& b){ return a.location < b.location; });
+
+    for(const auto& vertexFormat : options.vertexFormats)
+    {
+        if(std::none_of(inputs.begin(), inputs.end(), [&vertexFormat](const VertexInput& input){ return input.name == vertexFormat.first; }))
+            throw std::runtime_error(std::format("No stage input {} to set the vertex format of", vertexFormat.first));
+    }
+
+    BlockLayout layout;
+    for(const auto& input : inputs)
+    {
+        layout.size = roundUp(layout.size, input.alignment) + input.locationCount * input.locationSize;
+        layout.alignment = std::max(layout.alignment, input.alignment);
+    }
+    layout.size = roundUp(layout.size, layout.alignment);
+
+    std::string bindings;
+    std::string attributes;
+    out << std::format("// {} bytes per vertex, {} at the precision the shader declares\n", layout.size, fullSize);
+    if(options.vertexStreams)
+    {
+        out << "struct VertexStreams\n{\n";
+        for(uint32_t binding = 0; binding < inputs.size(); binding++)
+        {
+            const auto& input = inputs[binding];
+            out << std::format("using {} = {}{};\n", input.name, input.type, input.arrays);
+            bindings += std::format("    vk::VertexInputBindingDescription{{ {}, sizeof(VertexStreams::{}), vk::VertexInputRate::eVertex }},\n",
+                binding, input.name);
+            for(uint32_t index = 0; index < input.locationCount; index++)
+            {
+                attributes += std::format("    vk::VertexInputAttributeDescription{{ {}, {}, {}, {} }},\n",
+                    input.location + index, binding, input.format, index * input.locationSize);
+            }
+        }
+        out << "};\n";
+    }
+    else
+    {
+        out << "struct Vertex\n{\n";
+        for(const auto& input : inputs)
+        {
+            out << std::format("{} {}{};\n", input.type, input.name, input.arrays);
+            for(uint32_t index = 0; index < input.locationCount; index++)
+            {
+                std::string offset = std::format("offsetof(Vertex, {})", input.name);
+                if(index > 0)
+                    offset += std::format(" + {}", index * input.locationSize);
+                attributes += std::format("    vk::VertexInputAttributeDescription{{ {}, 0, {}, {} }},\n",
+                    input.location + index, input.format, offset);
+            }
+        }
+        out << "};\n";
+        if(!inputs.empty())
+        {
+            out << std::format("static_assert(sizeof(Vertex) == {});\n", layout.size);
+            bindings = "    vk::VertexInputBindingDescription{ 0, sizeof(Vertex), vk::VertexInputRate::eVertex },\n";
+        }
+    }
+
+    size_t bindingCount = options.vertexStreams ? inputs.size() : std::min<size_t>(inputs.size(), 1);
+    size_t attributeCount = 0;
+    for(const auto& input : inputs)
+    {
+        attributeCount += input.locationCount;
+    }
+    out << std::format("inline constexpr std::array<vk::VertexInputBindingDescription, {}> vertexBindings{{\n{}}};\n", bindingCount, bindings);
+    out << std::format("inline constexpr std::array<vk::VertexInputAttributeDescription, {}> vertexAttributes{{\n{}}};\n\n",
+        attributeCount, attributes);
+}
+
+// SPIRV-Reflect uses the Vulkan values, the names only keep the headers readable
+std::string getShaderStage(SpvReflectShaderStageFlagBits stage)
+{
+    switch(stage)
+    {
+        case SPV_REFLECT_SHADER_STAGE_VERTEX_BIT: return "vk::ShaderStageFlagBits::eVertex";
+        case SPV_REFLECT_SHADER_STAGE_TESSELLATION_CONTROL_BIT: return "vk::ShaderStageFlagBits::eTessellationControl";
+        case SPV_REFLECT_SHADER_STAGE_TESSELLATION_EVALUATION_BIT: return "vk::ShaderStageFlagBits::eTessellationEvaluation";
+        case SPV_REFLECT_SHADER_STAGE_GEOMETRY_BIT: return "vk::ShaderStageFlagBits::eGeometry";
+        case SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT: return "vk::ShaderStageFlagBits::eFragment";
+        case SPV_REFLECT_SHADER_STAGE_COMPUTE_BIT: return "vk::ShaderStageFlagBits::eCompute";
+        default: return std::format("static_cast<vk::ShaderStageFlagBits>({:#x})", static_cast<uint32_t>(stage));
+    }
+}
+
+std::string getDescriptorType(SpvReflectDescriptorType type)
+{
+    switch(type)
+    {
+        case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLER: return "vk::DescriptorType::eSampler";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: return "vk::DescriptorType::eCombinedImageSampler";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLED_IMAGE: return "vk::DescriptorType::eSampledImage";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_IMAGE: return "vk::DescriptorType::eStorageImage";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER: return "vk::DescriptorType::eUniformTexelBuffer";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: return "vk::DescriptorType::eStorageTexelBuffer";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER: return "vk::DescriptorType::eUniformBuffer";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER: return "vk::DescriptorType::eStorageBuffer";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC: return "vk::DescriptorType::eUniformBufferDynamic";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC: return "vk::DescriptorType::eStorageBufferDynamic";
+        case SPV_REFLECT_DESCRIPTOR_TYPE_INPUT_ATTACHMENT: return "vk::DescriptorType::eInputAttachment";
+        default: return std::format("static_cast<vk::DescriptorType>({})", static_cast<uint32_t>(type));
+    }
+}
+
+// set layout bindings and push constant ranges of the stage, vkr::mergeShaderLayouts
+// combines the ones of all stages of a pipeline
+void printLayout(std::ostream& out, const spv_reflect_wrapper::SpvReflectShaderModule& module)
+{
+    out << std::format("inline constexpr vk::ShaderStageFlagBits stage = {};\n\n", getShaderStage(module.getShaderStage()));
+
     auto descriptorSets = module.enumerateDescriptorSets();
+    uint32_t setCount = 0;
     for(const auto& set : descriptorSets)
     {
-        printDescriptorSet(out, *set);
+        out << std::format("inline constexpr std::array<vk::DescriptorSetLayoutBinding, {}> set{}Bindings{{\n",
+            set->binding_count, set->set);
+        for(uint32_t index = 0; index < set->binding_count; index++)
+        {
+            const auto& binding = *set->bindings[index];
+            // a runtime array would need its count and variable count binding flags from the
+            // application, the generated layout has neither
+            if(binding.count == 0)
+            {
+                throw std::runtime_error(std::format("{} (set {}, binding {}) is a runtime descriptor array, "
+                    "descriptor set layouts are only generated for fixed size arrays", binding.name, set->set, binding.binding));
+            }
+            out << std::format("    vk::DescriptorSetLayoutBinding{{ {}, {}, {}, stage }},\n",
+                binding.binding, getDescriptorType(binding.descriptor_type), binding.count);
+        }
+        out << "};\n";
+        setCount = std::max(setCount, set->set + 1);
+    }
+
+    // indexed by set number, sets the shader does not use stay empty
+    std::string sets;
+    for(uint32_t number = 0; number < setCount; number++)
+    {
+        bool used = std::any_of(descriptorSets.begin(), descriptorSets.end(), [number](const auto& set){ return set->set == number; });
+        sets += used ? std::format("set{}Bindings, ", number) : "std::span<const vk::DescriptorSetLayoutBinding>{}, ";
+    }
+    out << std::format("inline constexpr std::array<std::span<const vk::DescriptorSetLayoutBinding>, {}> descriptorSets{{ {}}};\n\n",
+        setCount, sets);
+
+    auto pushConstants = module.enumeratePushConstantBlocks();
+    out << std::format("inline constexpr std::array<vk::PushConstantRange, {}> pushConstantRanges{{\n", pushConstants.size());
+    for(const auto& constant : pushConstants)
+    {
+        // the range starts at the first member, a block may leave the start to another stage
+        uint32_t offset = UINT32_MAX;
+        for(uint32_t index = 0; index < constant->member_count; index++)
+        {
+            offset = std::min(offset, constant->members[index].offset);
+        }
+        std::string checks;
+        BlockLayout layout;
+        getBlockStruct(*constant, "", "", checks, layout);
+        offset = std::min(offset, layout.size);
+        out << std::format("    vk::PushConstantRange{{ stage, {}, {} }},\n", offset, layout.size - offset);
     }
     out << "};\n\n";
+}
+
+void printShader(std::ostream& out, const spv_reflect_wrapper::SpvReflectShaderModule& module, std::span<const uint32_t> code,
+    const ShaderOptions& options)
+{
+    std::string checks;
+    out << "struct Descriptor\n{\n";
+    auto descriptorSets = module.enumerateDescriptorSets();
+    for(const auto& set : descriptorSets)
+    {
+        printDescriptorSet(out, *set, checks);
+    }
+    out << "};\n" << checks << "\n";
 
     out << std::format("struct {}\n{{\n", "StageInput");
     auto inputs = module.enumerateInputVariables();
@@ -156,19 +728,18 @@ void printShader(std::ostream& out, const spv_reflect_wrapper::SpvReflectShaderM
 
     out << std::format("struct {}\n{{\n", "PushConstant");
     auto pushConstants = module.enumeratePushConstantBlocks();
+    checks.clear();
     for(const auto& constant: pushConstants)
     {
-        printPushConstant(out, *constant);
+        printPushConstant(out, *constant, checks);
     }
-    out << "};\n\n";
+    out << "};\n" << checks << "\n";
+
+    if(module.getShaderStage() == SPV_REFLECT_SHADER_STAGE_VERTEX_BIT)
+        printVertexInput(out, module, options);
+    printLayout(out, module);
 
-    // out << std::format("struct {}\n{{\n", "SpecializationConstant");
-    // auto specConstants = module.enumerateSpecializationConstants();
-    // for(const auto& constant: specConstants)
-    // {
-    //     printSpecConstant(out, *constant);
-    // }
-    // out << "};\n\n";
+    printSpecConstants(out, module, code);
 }
 
 std::vector<uint32_t> readSourceFile(const std::string& filename)
@@ -188,34 +759,1045 @@ std::vector<uint32_t> readSourceFile(const std::string& filename)
     return buffer;
 }
 
+// removes what only tools read: debug names and lines, the source text and non-semantic
+// instruction sets with the extension that allows them; the ids keep their numbers
+std::vector<uint32_t> stripSpirv(std::span<const uint32_t> code)
+{
+    constexpr uint32_t OpSourceContinued = 2;
+    constexpr uint32_t OpLine = 8;
+    constexpr uint32_t OpModuleProcessed = 330;
+    constexpr uint32_t OpNoLine = 317;
+    constexpr uint32_t OpExtension = 10;
+    constexpr uint32_t OpExtInstImport = 11;
+    constexpr uint32_t OpExtInst = 12;
+    constexpr uint32_t OpDecorateString = 5632;
+    constexpr uint32_t OpMemberDecorateString = 5633;
+    constexpr uint32_t DecorationUserSemantic = 5635;
+
+    if(code.size() < 5 || code[0] != 0x07230203)
+        throw std::runtime_error("Not a SPIR-V module");
+
+    // literal strings are nul terminated and padded to whole words
+    auto getString = [](std::span<const uint32_t> words)
+    {
+        std::string string{reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint32_t)};
+        return string.substr(0, string.find('\0'));
+    };
+
+    std::vector<uint32_t> stripped{code.begin(), code.begin() + 5};
+    std::vector<uint32_t> nonSemanticSets;
+    for(size_t index = 5; index < code.size();)
+    {
+        uint32_t opcode = code[index] & 0xFFFF;
+        uint32_t wordCount = code[index] >> 16;
+        if(wordCount == 0 || index + wordCount > code.size())
+            throw std::runtime_error("Malformed SPIR-V instruction stream");
+
+        auto instruction = code.subspan(index, wordCount);
+        index += wordCount;
+        // the source, names, strings and lines
+        bool debug = (opcode >= OpSourceContinued && opcode <= OpLine) || opcode == OpNoLine || opcode == OpModuleProcessed;
+        if(debug)
+            continue;
+        if(opcode == OpExtension && getString(instruction.subspan(1)) == "SPV_KHR_non_semantic_info")
+            continue;
+        if(opcode == OpExtInstImport && getString(instruction.subspan(2)).starts_with("NonSemantic."))
+        {
+            nonSemanticSets.push_back(instruction[1]);
+            continue;
+        }
+        if(opcode == OpExtInst && std::ranges::find(nonSemanticSets, instruction[3]) != nonSemanticSets.end())
+            continue;
+        if((opcode == OpDecorateString && instruction[2] == DecorationUserSemantic) ||
+            (opcode == OpMemberDecorateString && instruction[3] == DecorationUserSemantic))
+            continue;
+        stripped.insert(stripped.end(), instruction.begin(), instruction.end());
+    }
+    return stripped;
+}
+
+// element of a block array whose ArrayStride is larger than the element itself
+void printPaddedTemplate(std::ostream& out)
+{
+    out << "template<typename T, std::size_t Stride>\nstruct Padded\n{\n    T value;\n"
+        "    std::byte padding[Stride - sizeof(T)];\n};\n\n";
+}
+
+// inline so every translation unit including the header shares one copy
+void printCodeArray(std::ostream& out, std::span<const uint32_t> shader, const std::string& name = "code")
+{
+    out << std::format("inline constexpr std::array<uint32_t, {}> {} = \n{{\n    ", shader.size(), name);
+    for(uint32_t data : shader)
+    {
+        out << std::format("{:#0x}, ", data);
+    }
+    out << "\n};\n\n";
+}
+
+// the words live in the object file of the embed source, the header only declares them
+void printCodeSpan(std::ostream& out, const std::string& symbol, size_t size, const std::string& name = "code")
+{
+    out << std::format("inline constexpr std::span<const uint32_t, {}> {}{{ ::{} }};\n\n", size, name, symbol);
+}
+
+// the path is an assembler string inside a C++ string literal, escaped for both
+std::string escapeAssemblerString(const std::string& string)
+{
+    std::string escaped;
+    for(char c : string)
+    {
+        if(c == '\\')
+            escaped += R"(\\\\)";
+        else if(c == '"')
+            escaped += R"(\\\")";
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+struct EmbeddedFile
+{
+    std::string symbol;
+    std::filesystem::path path;
+};
+
+// one .incbin per file pulls the SPIR-V into read only data when the source is assembled,
+// the compiler never parses the words
+std::string getEmbedSource(const std::vector<EmbeddedFile>& files)
+{
+    std::ostringstream out;
+    out << "#if defined(__APPLE__)\n#define SHADER_DATA_SECTION \".const_data\"\n"
+        "#elif defined(_WIN32)\n#define SHADER_DATA_SECTION \".section .rdata,\\\"dr\\\"\"\n"
+        "#else\n#define SHADER_DATA_SECTION \".section .rodata\"\n#endif\n"
+        "#define SHADER_DATA_STRING(x) #x\n#define SHADER_DATA_SYMBOL(x) SHADER_DATA_STRING(x)\n";
+    for(const auto& file : files)
+    {
+        auto spirvPath = escapeAssemblerString(std::filesystem::absolute(file.path).generic_string());
+        out << std::format("\n__asm__(\n    SHADER_DATA_SECTION \"\\n\"\n    \".balign 4\\n\"\n"
+            "    \".globl \" SHADER_DATA_SYMBOL(__USER_LABEL_PREFIX__) \"{0}\\n\"\n"
+            "    SHADER_DATA_SYMBOL(__USER_LABEL_PREFIX__) \"{0}:\\n\"\n"
+            "    \".incbin \\\"{1}\\\"\\n\"\n"
+            "    \".previous\\n\");\n", file.symbol, spirvPath);
+    }
+    return out.str();
+}
+
+struct ShaderFiles
+{
+    std::string sourceFilename;
+    std::string targetFilename;
+    // empty unless the SPIR-V is embedded through .incbin
+    std::string embedFilename;
+    ShaderOptions options;
+};
+
+// options come before the files on the command line and after them in a manifest line
+void parseOption(ShaderOptions& options, const std::string& option, const std::string& value)
+{
+    if(option == "--vertex-layout")
+    {
+        if(value != "interleaved" && value != "soa")
+            throw std::runtime_error(std::format("Unknown vertex layout {}, expected interleaved or soa", value));
+        options.vertexStreams = value == "soa";
+    }
+    else if(option == "--vertex-format")
+    {
+        auto separator = value.find('=');
+        if(separator == std::string::npos)
+            throw std::runtime_error(std::format("Expected input=format, got {}", value));
+        options.vertexFormats.emplace_back(value.substr(0, separator), value.substr(separator + 1));
+    }
+    else if(option == "--code")
+    {
+        options.codeFilename = value;
+    }
+    else if(option == "--compression")
+    {
+        if(value != "none" && value != "spirv-lz")
+            throw std::runtime_error(std::format("Unknown compression {}, expected none or spirv-lz", value));
+        options.compress = value == "spirv-lz";
+    }
+    else
+    {
+        throw std::runtime_error(std::format("Unknown option {}", option));
+    }
+}
+
+struct GeneratedShader
+{
+    std::string header;
+    std::string embedSource;
+    // the compressed code and the file .incbin reads it from
+    std::string compressedCode;
+    std::string compressedFilename;
+    // words of the reflected and of the embedded SPIR-V
+    size_t reflectedSize = 0;
+    size_t codeSize = 0;
+};
+
+void printCompressedArray(std::ostream& out, const std::string& compressed)
+{
+    out << std::format("inline constexpr std::array<uint8_t, {}> compressedCode = \n{{\n    ", compressed.size());
+    for(char data : compressed)
+    {
+        out << std::format("{:#0x}, ", static_cast<uint8_t>(data));
+    }
+    out << "\n};\n\n";
+}
+
+// the compressed code replaces code, vkr::ShaderLibrary decompresses it on first use
+GeneratedShader generateCompressedShader(const ShaderFiles& files, const std::string& shaderName, std::span<const uint32_t> code)
+{
+    GeneratedShader generated;
+    auto compressed = vkr::compressSpirv(code);
+    generated.compressedCode.assign(compressed.begin(), compressed.end());
+
+    std::ostringstream header;
+    if(files.embedFilename.empty())
+    {
+        header << "#pragma once\n#include <array>\n#include <bit>\n#include <cstddef>\n#include <cstdint>\n#include <span>\n#include <vulkan/vulkan.hpp>\n#include <glm/glm.hpp>\n";
+        header << std::format("namespace ShaderData::{}{{\n", shaderName);
+        printCompressedArray(header, generated.compressedCode);
+    }
+    else
+    {
+        std::string symbol = std::format("ShaderData_{}_compressed", shaderName);
+        generated.compressedFilename = std::filesystem::path{files.embedFilename}.replace_extension(".spvz").string();
+        generated.embedSource = getEmbedSource({{symbol, generated.compressedFilename}});
+        header << "#pragma once\n#include <array>\n#include <bit>\n#include <cstddef>\n#include <cstdint>\n#include <span>\n#include <vulkan/vulkan.hpp>\n#include <glm/glm.hpp>\n";
+        header << std::format("extern \"C\" const uint8_t {}[{}];\n", symbol, compressed.size());
+        header << std::format("namespace ShaderData::{}{{\n", shaderName);
+        header << std::format("inline constexpr std::span<const uint8_t, {}> compressedCode{{ ::{} }};\n\n", compressed.size(), symbol);
+    }
+    header << std::format("// {} bytes of SPIR-V compressed to {}\ninline constexpr size_t codeSize = {};\n\n",
+        code.size() * sizeof(uint32_t), compressed.size(), code.size());
+    generated.header = header.str();
+    return generated;
+}
+
+GeneratedShader generateShader(const ShaderFiles& files)
+{
+    // the mapped file is reflected in place, neither this nor SPIRV-Reflect copies the words
+    vkr::SpirvFile shader{files.sourceFilename};
+    spv_reflect_wrapper::SpvReflectShaderModule module{shader, SPV_REFLECT_MODULE_FLAG_NO_COPY};
+    std::string shaderName = std::filesystem::path{files.targetFilename}.stem().string();
+
+    // reflection reads the names the embedded copy may no longer have
+    const auto& codeFilename = files.options.codeFilename.empty() ? files.sourceFilename : files.options.codeFilename;
+    std::optional<vkr::SpirvFile> codeFile;
+    if(!files.options.codeFilename.empty())
+        codeFile.emplace(codeFilename);
+    auto code = codeFile ? codeFile->getCode() : shader.getCode();
+
+    GeneratedShader generated;
+    std::ostringstream header;
+    if(files.options.compress)
+    {
+        generated = generateCompressedShader(files, shaderName, code);
+        header << generated.header;
+    }
+    else if(files.embedFilename.empty())
+    {
+        header << "#pragma once\n#include <array>\n#include <bit>\n#include <cstddef>\n#include <span>\n#include <vulkan/vulkan.hpp>\n#include <glm/glm.hpp>\n";
+        header << std::format("namespace ShaderData::{}{{\n", shaderName);
+        printCodeArray(header, code);
+    }
+    else
+    {
+        std::string symbol = std::format("ShaderData_{}_code", shaderName);
+        generated.embedSource = getEmbedSource({{symbol, codeFilename}});
+        header << "#pragma once\n#include <array>\n#include <bit>\n#include <cstddef>\n#include <cstdint>\n#include <span>\n#include <vulkan/vulkan.hpp>\n#include <glm/glm.hpp>\n";
+        header << std::format("extern \"C\" const uint32_t {}[{}];\n", symbol, code.size());
+        header << std::format("namespace ShaderData::{}{{\n", shaderName);
+        printCodeSpan(header, symbol, code.size());
+    }
+    printPaddedTemplate(header);
+    printShader(header, module, shader.getCode(), files.options);
+    header << std::format("}}//namespace ShaderData::{}\n", shaderName);
+    generated.header = header.str();
+    generated.reflectedSize = shader.size();
+    generated.codeSize = code.size();
+    return generated;
+}
+
+void writeFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream file{filename, std::ios::out | std::ios::trunc | std::ios::binary};
+    if(!file.is_open())
+    {
+        throw std::runtime_error(std::format("Failed to open {}", filename));
+    }
+    file << content;
+}
+
+// FNV-1a, only compared against the hash of the previous run
+uint64_t hashContent(std::string_view content)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for(char c : content)
+    {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+// an unchanged file keeps its timestamp, nothing that includes it is rebuilt
+bool writeIfChanged(const std::string& filename, const std::string& content, uint64_t previousHash, uint64_t& hash)
+{
+    hash = hashContent(content);
+    if(hash == previousHash && std::filesystem::exists(filename))
+        return false;
+
+    writeFile(filename, content);
+    return true;
+}
+
+// one shader per line, source_spirv_file;target_header_file[;target_source_file][;option;value...]
+std::vector<ShaderFiles> readManifest(const std::string& filename)
+{
+    std::ifstream file{filename};
+    if(!file.is_open())
+    {
+        throw std::runtime_error(std::format("Failed to open {}", filename));
+    }
+
+    std::vector<ShaderFiles> entries;
+    std::string line;
+    while(std::getline(file, line))
+    {
+        if(line.empty())
+            continue;
+
+        std::vector<std::string> fields;
+        std::istringstream stream{line};
+        for(std::string field; std::getline(stream, field, ';');)
+        {
+            fields.push_back(field);
+        }
+        if(fields.size() < 2)
+        {
+            throw std::runtime_error(std::format("Invalid manifest line in {}: {}", filename, line));
+        }
+
+        auto& entry = entries.emplace_back(ShaderFiles{fields[0], fields[1]});
+        size_t index = 2;
+        if(index < fields.size() && !fields[index].starts_with("--"))
+            entry.embedFilename = fields[index++];
+        for(; index + 1 < fields.size(); index += 2)
+        {
+            parseOption(entry.options, fields[index], fields[index + 1]);
+        }
+        if(index != fields.size())
+        {
+            throw std::runtime_error(std::format("Invalid manifest line in {}: {}", filename, line));
+        }
+    }
+    return entries;
+}
+
+// content hashes of the files the previous run wrote, one "hash path" per line
+std::unordered_map<std::string, uint64_t> readHashes(const std::string& filename)
+{
+    std::unordered_map<std::string, uint64_t> hashes;
+    std::ifstream file{filename};
+    std::string line;
+    while(std::getline(file, line))
+    {
+        auto separator = line.find(' ');
+        if(separator == std::string::npos)
+            continue;
+        hashes[line.substr(separator + 1)] = std::stoull(line.substr(0, separator), nullptr, 16);
+    }
+    return hashes;
+}
+
+std::string getCodeSizeReport(const std::string& filename, size_t size, size_t reducedSize, std::string_view unit = "words")
+{
+    return std::format("{}: {} -> {} {} ({:.1f}% smaller)\n", std::filesystem::path{filename}.filename().string(),
+        size, reducedSize, unit, 100.0 * (1.0 - static_cast<double>(reducedSize) / static_cast<double>(size)));
+}
+
+// what the size options did to a shader
+std::string getShaderSizeReport(const ShaderFiles& files, const GeneratedShader& generated)
+{
+    std::string report;
+    if(!files.options.codeFilename.empty())
+        report += getCodeSizeReport(files.sourceFilename, generated.reflectedSize, generated.codeSize);
+    if(files.options.compress)
+        report += getCodeSizeReport(files.sourceFilename, generated.codeSize * sizeof(uint32_t), generated.compressedCode.size(), "bytes");
+    return report;
+}
+
+struct BatchResult
+{
+    uint64_t headerHash = 0;
+    uint64_t embedHash = 0;
+    uint64_t compressedHash = 0;
+    std::string compressedFilename;
+    std::string sizeReport;
+    bool written = false;
+    std::string error;
+};
+
+// reflects every shader of the manifest on a thread pool and writes only the files whose
+// content changed since the previous run
+int generateBatch(const std::string& manifestFilename, uint32_t jobs)
+{
+    auto begin = std::chrono::steady_clock::now();
+    auto entries = readManifest(manifestFilename);
+    std::string hashFilename = manifestFilename + ".hash";
+    auto previousHashes = readHashes(hashFilename);
+    auto getPreviousHash = [&previousHashes](const std::string& filename) -> uint64_t
+    {
+        auto found = previousHashes.find(filename);
+        return found == previousHashes.end() ? 0 : found->second;
+    };
+
+    std::vector<BatchResult> results(entries.size());
+    if(!entries.empty())
+    {
+        vkr::exec::thread_run_loop loop{std::min(jobs, static_cast<uint32_t>(entries.size()))};
+        vkr::exec::sync_wait(vkr::exec::schedule(vkr::exec::get_scheduler(loop)) |
+            vkr::exec::bulk(static_cast<uint32_t>(entries.size()), [&](uint32_t index)
+                {
+                    const auto& entry = entries[index];
+                    auto& result = results[index];
+                    try {
+                        auto generated = generateShader(entry);
+                        result.sizeReport = getShaderSizeReport(entry, generated);
+                        result.written = writeIfChanged(entry.targetFilename, generated.header,
+                            getPreviousHash(entry.targetFilename), result.headerHash);
+                        if(!entry.embedFilename.empty())
+                        {
+                            result.written |= writeIfChanged(entry.embedFilename, generated.embedSource,
+                                getPreviousHash(entry.embedFilename), result.embedHash);
+                        }
+                        result.compressedFilename = generated.compressedFilename;
+                        if(!result.compressedFilename.empty())
+                        {
+                            result.written |= writeIfChanged(result.compressedFilename, generated.compressedCode,
+                                getPreviousHash(result.compressedFilename), result.compressedHash);
+                        }
+                    } catch (const std::exception& e) {
+                        result.error = std::format("{}: {}", entry.sourceFilename, e.what());
+                    }
+                }));
+    }
+
+    // failed shaders leave no hash behind and are written again by the next run
+    std::ostringstream hashes;
+    uint32_t writtenCount = 0;
+    uint32_t failedCount = 0;
+    for(size_t index = 0; index < entries.size(); index++)
+    {
+        const auto& result = results[index];
+        if(!result.error.empty())
+        {
+            std::cout << result.error << "\n";
+            failedCount++;
+            continue;
+        }
+
+        writtenCount += result.written;
+        std::cout << result.sizeReport;
+        hashes << std::format("{:016x} {}\n", result.headerHash, entries[index].targetFilename);
+        if(!entries[index].embedFilename.empty())
+            hashes << std::format("{:016x} {}\n", result.embedHash, entries[index].embedFilename);
+        if(!result.compressedFilename.empty())
+            hashes << std::format("{:016x} {}\n", result.compressedHash, result.compressedFilename);
+    }
+    writeFile(hashFilename, hashes.str());
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    std::cout << std::format("Generated {} shaders in {} ms: {} written, {} unchanged, {} failed\n", entries.size(),
+        elapsed.count(), writtenCount, entries.size() - writtenCount - failedCount, failedCount);
+    return failedCount == 0 ? 0 : -1;
+}
+
+// a define a shader is compiled with, flags are defined as 1 when set and left undefined
+// otherwise, value axes are always defined to one of their values
+struct VariantAxis
+{
+    std::string name;
+    std::vector<uint32_t> values;
+    bool flag = false;
+};
+
+struct ShaderVariants
+{
+    std::string source;
+    std::vector<VariantAxis> axes;
+    // keys of the listed permutations, all of them when empty
+    std::vector<uint32_t> keys;
+};
+
+// the key numbers the permutations with the first axis in the lowest digit
+uint32_t getPermutationCount(const ShaderVariants& shader)
+{
+    uint64_t count = 1;
+    for(const auto& axis : shader.axes)
+    {
+        count *= axis.values.size();
+        if(count > 65536)
+            throw std::runtime_error(std::format("{} has more than 65536 permutations", shader.source));
+    }
+    return static_cast<uint32_t>(count);
+}
+
+VariantAxis parseVariantAxis(const std::string& field)
+{
+    VariantAxis axis;
+    auto separator = field.find('=');
+    axis.name = field.substr(0, separator);
+    if(separator == std::string::npos)
+    {
+        axis.flag = true;
+        axis.values = {0, 1};
+        return axis;
+    }
+
+    std::istringstream stream{field.substr(separator + 1)};
+    for(std::string value; std::getline(stream, value, '|');)
+    {
+        axis.values.push_back(static_cast<uint32_t>(std::stoul(value)));
+    }
+    if(axis.values.empty())
+        throw std::runtime_error(std::format("Axis {} has no values", axis.name));
+    return axis;
+}
+
+// the key of a listed permutation, axes it does not name are unset or take their first value
+uint32_t parseVariantKey(const ShaderVariants& shader, const std::vector<std::string>& fields)
+{
+    uint32_t key = 0;
+    for(const auto& field : fields)
+    {
+        auto separator = field.find('=');
+        std::string name = field.substr(0, separator);
+        uint32_t stride = 1;
+        auto axis = shader.axes.begin();
+        for(; axis != shader.axes.end() && axis->name != name; axis++)
+        {
+            stride *= static_cast<uint32_t>(axis->values.size());
+        }
+        if(axis == shader.axes.end())
+            throw std::runtime_error(std::format("{} has no axis {}", shader.source, name));
+
+        uint32_t value = separator == std::string::npos ? 1 : static_cast<uint32_t>(std::stoul(field.substr(separator + 1)));
+        auto found = std::find(axis->values.begin(), axis->values.end(), value);
+        if(found == axis->values.end() || (axis->flag && separator != std::string::npos))
+            throw std::runtime_error(std::format("{} is not a value of {} in {}", field, name, shader.source));
+        key += stride * static_cast<uint32_t>(found - axis->values.begin());
+    }
+    return key;
+}
+
+// "shader.frag: FLAG AXIS=0|1|2" declares the axes of a shader, every permutation of them is
+// built unless lines "shader.frag = FLAG AXIS=2" list the ones to build
+std::vector<ShaderVariants> readVariantManifest(const std::string& filename)
+{
+    std::ifstream file{filename};
+    if(!file.is_open())
+    {
+        throw std::runtime_error(std::format("Failed to open {}", filename));
+    }
+
+    std::vector<ShaderVariants> shaders;
+    std::string line;
+    while(std::getline(file, line))
+    {
+        auto first = line.find_first_not_of(" \t\r");
+        if(first == std::string::npos || line[first] == '#')
+            continue;
+
+        auto separator = line.find_first_of(":=");
+        std::string source;
+        std::istringstream{line.substr(0, separator)} >> source;
+        if(separator == std::string::npos || source.empty())
+        {
+            throw std::runtime_error(std::format("Invalid variant manifest line in {}: {}", filename, line));
+        }
+
+        std::vector<std::string> fields;
+        std::istringstream stream{line.substr(separator + 1)};
+        for(std::string field; stream >> field;)
+        {
+            fields.push_back(field);
+        }
+
+        if(line[separator] == ':')
+        {
+            auto& shader = shaders.emplace_back(ShaderVariants{source});
+            for(const auto& field : fields)
+            {
+                shader.axes.push_back(parseVariantAxis(field));
+            }
+            getPermutationCount(shader);
+            continue;
+        }
+
+        auto shader = std::find_if(shaders.begin(), shaders.end(), [&source](const auto& shader){ return shader.source == source; });
+        if(shader == shaders.end())
+        {
+            throw std::runtime_error(std::format("{} is listed before its axes in {}", source, filename));
+        }
+        shader->keys.push_back(parseVariantKey(*shader, fields));
+    }
+    return shaders;
+}
+
+struct VariantJob
+{
+    size_t shader = 0;
+    uint32_t key = 0;
+    std::string spirvFilename;
+    std::vector<uint32_t> code;
+    std::string error;
+};
+
+#ifdef _WIN32
+// quoted the way CommandLineToArgvW splits the command line again
+std::wstring quoteArgument(const std::wstring& argument)
+{
+    if(!argument.empty() && argument.find_first_of(L" \t\n\v\"") == std::wstring::npos)
+        return argument;
+
+    std::wstring quoted = L"\"";
+    size_t backslashes = 0;
+    for(wchar_t c : argument)
+    {
+        if(c == L'\\')
+        {
+            backslashes++;
+            continue;
+        }
+        quoted.append(c == L'"' ? 2 * backslashes + 1 : backslashes, L'\\');
+        quoted += c;
+        backslashes = 0;
+    }
+    quoted.append(2 * backslashes, L'\\');
+    quoted += L'"';
+    return quoted;
+}
+#endif
+
+// starts the program without a shell, its standard output and error go to the log file;
+// returns the exit code
+int runProcess(const std::vector<std::string>& arguments, const std::string& logFilename)
+{
+#ifdef _WIN32
+    std::wstring commandLine;
+    for(const auto& argument : arguments)
+    {
+        commandLine += quoteArgument(std::filesystem::path{argument}.wstring()) + L" ";
+    }
+
+    SECURITY_ATTRIBUTES inheritable{sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE};
+    HANDLE log = CreateFileW(std::filesystem::path{logFilename}.c_str(), GENERIC_WRITE, FILE_SHARE_READ, &inheritable,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(log == INVALID_HANDLE_VALUE)
+        throw std::runtime_error(std::format("Failed to create {}: {}", logFilename, std::system_category().message(static_cast<int>(GetLastError()))));
+
+    STARTUPINFOW startupInfo{sizeof(STARTUPINFOW)};
+    startupInfo.dwFlags = STARTF_USESTDHANDLES;
+    startupInfo.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    startupInfo.hStdOutput = log;
+    startupInfo.hStdError = log;
+    PROCESS_INFORMATION processInfo{};
+    BOOL started = CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr,
+        &startupInfo, &processInfo);
+    int error = static_cast<int>(GetLastError());
+    CloseHandle(log);
+    if(!started)
+        throw std::runtime_error(std::format("Failed to start {}: {}", arguments[0], std::system_category().message(error)));
+
+    WaitForSingleObject(processInfo.hProcess, INFINITE);
+    DWORD exitCode = 0;
+    GetExitCodeProcess(processInfo.hProcess, &exitCode);
+    CloseHandle(processInfo.hThread);
+    CloseHandle(processInfo.hProcess);
+    return static_cast<int>(exitCode);
+#else
+    std::vector<char*> argv;
+    for(const auto& argument : arguments)
+    {
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, logFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+    pid_t pid;
+    int error = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if(error != 0)
+        throw std::runtime_error(std::format("Failed to start {}: {}", arguments[0], std::system_category().message(error)));
+
+    int status = 0;
+    while(waitpid(pid, &status, 0) < 0)
+    {
+        if(errno != EINTR)
+            throw std::runtime_error(std::format("Failed to wait for {}: {}", arguments[0], std::system_category().message(errno)));
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+// glslangValidator with the defines of the key, its output ends up in a log next to the SPIR-V
+void compileVariant(VariantJob& job, const ShaderVariants& shader, const std::filesystem::path& sourceDir,
+    const std::string& compiler)
+{
+    std::vector<std::string> arguments{compiler, std::format("-I{}", sourceDir.string()), "-V100"};
+    std::string defines;
+    uint32_t digits = job.key;
+    for(const auto& axis : shader.axes)
+    {
+        uint32_t value = axis.values[digits % axis.values.size()];
+        digits /= static_cast<uint32_t>(axis.values.size());
+        if(!axis.flag)
+            arguments.push_back(std::format("-D{}={}", axis.name, value));
+        else if(value)
+            arguments.push_back(std::format("-D{}=1", axis.name));
+        else
+            continue;
+        defines += " " + arguments.back();
+    }
+    arguments.insert(arguments.end(), {"-o", job.spirvFilename, (sourceDir / shader.source).string()});
+
+    std::string logFilename = job.spirvFilename + ".log";
+    if(runProcess(arguments, logFilename) != 0)
+    {
+        std::ifstream log{logFilename};
+        std::ostringstream output;
+        output << log.rdbuf();
+        job.error = std::format("{} with{}:\n{}", shader.source, defines.empty() ? " no defines" : defines, output.str());
+        return;
+    }
+    job.code = readSourceFile(job.spirvFilename);
+}
+
+// mesh.vert becomes mesh_vert_variants, the name of its header and namespace
+std::string getVariantsName(const ShaderVariants& shader)
+{
+    std::string name = std::format("{}_variants", std::filesystem::path{shader.source}.filename().string());
+    std::replace(name.begin(), name.end(), '.', '_');
+    return name;
+}
+
+struct VariantFiles
+{
+    std::string header;
+    // empty unless the modules are embedded through .incbin
+    std::string embedSource;
+    uint32_t moduleCount = 0;
+};
+
+// one module per distinct SPIR-V, the lookup maps every key to its module; embedded modules
+// are the compiled SPIR-V files of the first permutation that produced them
+VariantFiles getVariantFiles(const ShaderVariants& shader, std::span<VariantJob> jobs, bool embed)
+{
+    std::string shaderName = getVariantsName(shader);
+    uint32_t permutationCount = getPermutationCount(shader);
+
+    std::unordered_multimap<uint64_t, uint32_t> hashes;
+    std::vector<const VariantJob*> modules;
+    std::vector<uint32_t> variantModules(permutationCount, UINT32_MAX);
+    for(const auto& job : jobs)
+    {
+        uint64_t hash = hashContent({reinterpret_cast<const char*>(job.code.data()), job.code.size() * sizeof(uint32_t)});
+        auto [begin, end] = hashes.equal_range(hash);
+        auto found = std::find_if(begin, end, [&](const auto& entry){ return modules[entry.second]->code == job.code; });
+        if(found != end)
+        {
+            variantModules[job.key] = found->second;
+            continue;
+        }
+
+        variantModules[job.key] = static_cast<uint32_t>(modules.size());
+        hashes.emplace(hash, static_cast<uint32_t>(modules.size()));
+        modules.push_back(&job);
+    }
+
+    VariantFiles files;
+    files.moduleCount = static_cast<uint32_t>(modules.size());
+    std::vector<EmbeddedFile> embeddedFiles;
+    std::ostringstream out;
+    out << "#pragma once\n#include <array>\n#include <cstdint>\n#include <span>\n";
+    if(embed)
+    {
+        for(size_t index = 0; index < modules.size(); index++)
+        {
+            auto& file = embeddedFiles.emplace_back(EmbeddedFile{std::format("ShaderData_{}_module{}", shaderName, index),
+                modules[index]->spirvFilename});
+            out << std::format("extern \"C\" const uint32_t {}[{}];\n", file.symbol, modules[index]->code.size());
+        }
+        files.embedSource = getEmbedSource(embeddedFiles);
+    }
+    out << std::format("namespace ShaderData::{}{{\n", shaderName);
+    out << std::format("// {} variants of {}, {} distinct modules\n", jobs.size(), shader.source, modules.size());
+    out << "struct Variant\n{\n";
+    for(const auto& axis : shader.axes)
+    {
+        if(axis.flag)
+            out << std::format("bool {} = false;\n", axis.name);
+        else
+            out << std::format("uint32_t {} = {};\n", axis.name, axis.values[0]);
+    }
+    out << "};\n\n";
+
+    std::string moduleNames;
+    for(size_t index = 0; index < modules.size(); index++)
+    {
+        if(embed)
+            printCodeSpan(out, embeddedFiles[index].symbol, modules[index]->code.size(), std::format("module{}", index));
+        else
+            printCodeArray(out, modules[index]->code, std::format("module{}", index));
+        moduleNames += std::format("module{}, ", index);
+    }
+    out << std::format("inline constexpr std::array<std::span<const uint32_t>, {}> modules{{ {}}};\n", modules.size(), moduleNames);
+
+    std::string keys;
+    for(uint32_t module : variantModules)
+    {
+        keys += module == UINT32_MAX ? "UINT32_MAX, " : std::format("{}, ", module);
+    }
+    out << "// module of every key, UINT32_MAX for the permutations that were not built\n";
+    out << std::format("inline constexpr std::array<uint32_t, {}> variantModules{{ {}}};\n\n", permutationCount, keys);
+
+    out << "constexpr uint32_t getVariantKey(const Variant& variant)\n{\n    uint32_t key = 0;\n";
+    uint32_t stride = 1;
+    for(const auto& axis : shader.axes)
+    {
+        if(axis.flag)
+        {
+            out << std::format("    key += variant.{} ? {} : 0;\n", axis.name, stride);
+        }
+        else
+        {
+            out << std::format("    switch(variant.{})\n    {{\n", axis.name);
+            for(size_t index = 0; index < axis.values.size(); index++)
+            {
+                out << std::format("        case {}: key += {}; break;\n", axis.values[index], index * stride);
+            }
+            out << "        default: return UINT32_MAX;\n    }\n";
+        }
+        stride *= static_cast<uint32_t>(axis.values.size());
+    }
+    out << "    return key;\n}\n\n";
+
+    out << "// empty for a permutation that was not built\n";
+    out << "constexpr std::span<const uint32_t> getCode(const Variant& variant)\n{\n"
+        "    uint32_t key = getVariantKey(variant);\n"
+        "    if(key >= variantModules.size() || variantModules[key] == UINT32_MAX)\n"
+        "        return {};\n"
+        "    return modules[variantModules[key]];\n}\n";
+    out << std::format("}}//namespace ShaderData::{}\n", shaderName);
+    files.header = out.str();
+    return files;
+}
+
+// compiles the permutations of every shader of the manifest on a thread pool and writes a
+// header per shader in which permutations with identical SPIR-V share one module; with an
+// embed directory the modules are embedded by a source file per shader written there
+int generateVariants(const std::string& manifestFilename, const std::string& compiler,
+    const std::string& spirvDir, const std::string& headerDir, const std::string& embedDir, uint32_t jobCount)
+{
+    auto begin = std::chrono::steady_clock::now();
+    auto shaders = readVariantManifest(manifestFilename);
+    auto sourceDir = std::filesystem::path{manifestFilename}.parent_path();
+
+    std::vector<VariantJob> jobs;
+    for(size_t index = 0; index < shaders.size(); index++)
+    {
+        auto keys = shaders[index].keys;
+        if(keys.empty())
+        {
+            keys.resize(getPermutationCount(shaders[index]));
+            std::iota(keys.begin(), keys.end(), 0);
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        for(uint32_t key : keys)
+        {
+            auto spirvFilename = std::filesystem::path{spirvDir} / std::format("{}.{}.spv", shaders[index].source, key);
+            jobs.push_back(VariantJob{index, key, spirvFilename.string()});
+        }
+    }
+
+    if(!jobs.empty())
+    {
+        vkr::exec::thread_run_loop loop{std::min(jobCount, static_cast<uint32_t>(jobs.size()))};
+        vkr::exec::sync_wait(vkr::exec::schedule(vkr::exec::get_scheduler(loop)) |
+            vkr::exec::bulk(static_cast<uint32_t>(jobs.size()), [&](uint32_t index)
+                {
+                    auto& job = jobs[index];
+                    try {
+                        compileVariant(job, shaders[job.shader], sourceDir, compiler);
+                    } catch (const std::exception& e) {
+                        job.error = std::format("{}: {}", shaders[job.shader].source, e.what());
+                    }
+                }));
+    }
+
+    uint32_t failedCount = 0;
+    for(const auto& job : jobs)
+    {
+        if(!job.error.empty())
+        {
+            std::cout << job.error << "\n";
+            failedCount++;
+        }
+    }
+    if(failedCount > 0)
+    {
+        std::cout << std::format("{} of {} variants failed to compile\n", failedCount, jobs.size());
+        return -1;
+    }
+
+    // untouched unless their content changed, the variants have no hash file of their own
+    auto writeVariantFile = [](const std::filesystem::path& filename, const std::string& content)
+    {
+        std::ifstream previous{filename};
+        std::ostringstream previousContent;
+        previousContent << previous.rdbuf();
+        uint64_t hash;
+        writeIfChanged(filename.string(), content, previous.is_open() ? hashContent(previousContent.str()) : 0, hash);
+    };
+
+    // the jobs of a shader are contiguous
+    uint32_t moduleCount = 0;
+    for(auto first = jobs.begin(); first != jobs.end();)
+    {
+        auto last = std::find_if(first, jobs.end(), [first](const auto& job){ return job.shader != first->shader; });
+        const auto& shader = shaders[first->shader];
+        auto files = getVariantFiles(shader, std::span{first, last}, !embedDir.empty());
+        moduleCount += files.moduleCount;
+
+        writeVariantFile(std::filesystem::path{headerDir} / (getVariantsName(shader) + ".hpp"), files.header);
+        if(!embedDir.empty())
+            writeVariantFile(std::filesystem::path{embedDir} / (getVariantsName(shader) + ".cpp"), files.embedSource);
+        first = last;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    std::cout << std::format("Compiled {} variants of {} shaders in {} ms, {} distinct modules\n", jobs.size(),
+        shaders.size(), elapsed.count(), moduleCount);
+    return 0;
+}
+
 int main(int argc, char* argv[])
 {
-    if(argc != 3)
+    std::vector<std::string> arguments{argv + 1, argv + argc};
+    if(!arguments.empty() && arguments[0] == "--manifest")
     {
-       std::cout << "Usage: generate_shader [source_spirv_file] [target_header_file]";
+        uint32_t jobs = std::max(std::thread::hardware_concurrency(), 1u);
+        if(arguments.size() == 4 && arguments[2] == "--jobs")
+        {
+            jobs = std::max(static_cast<uint32_t>(std::stoul(arguments[3])), 1u);
+            arguments.resize(2);
+        }
+
+        if(arguments.size() != 2)
+        {
+            std::cout << "Usage: generate_shader --manifest [manifest_file] [--jobs thread_count]";
+            return -1;
+        }
+
+        try {
+            return generateBatch(arguments[1], jobs);
+        } catch (const std::exception& e) {
+            std::cout << e.what();
+            return -1;
+        }
+    }
+
+    if(!arguments.empty() && arguments[0] == "--strip")
+    {
+        if(arguments.size() != 3)
+        {
+            std::cout << "Usage: generate_shader --strip [source_spirv_file] [target_spirv_file]";
+            return -1;
+        }
+
+        try {
+            vkr::SpirvFile shader{arguments[1]};
+            auto stripped = stripSpirv(shader.getCode());
+            writeFile(arguments[2], std::string{reinterpret_cast<const char*>(stripped.data()), stripped.size() * sizeof(uint32_t)});
+            std::cout << getCodeSizeReport(arguments[1], shader.size(), stripped.size());
+        } catch (const std::exception& e) {
+            std::cout << e.what();
+            return -1;
+        }
+        return 0;
+    }
+
+    if(!arguments.empty() && arguments[0] == "--variants")
+    {
+        std::unordered_map<std::string, std::string> options{{"--jobs", std::to_string(std::max(std::thread::hardware_concurrency(), 1u))}};
+        for(size_t index = 2; index + 1 < arguments.size(); index += 2)
+        {
+            options[arguments[index]] = arguments[index + 1];
+        }
+
+        if(arguments.size() % 2 != 0 || !options.contains("--compiler") || !options.contains("--spirv-dir") || !options.contains("--header-dir"))
+        {
+            std::cout << "Usage: generate_shader --variants [variant_manifest_file] --compiler [glslang_validator]\n"
+                "           --spirv-dir [spirv_directory] --header-dir [header_directory] [--embed-dir embed_source_directory]\n"
+                "           [--jobs thread_count]";
+            return -1;
+        }
+
+        try {
+            return generateVariants(arguments[1], options["--compiler"], options["--spirv-dir"], options["--header-dir"],
+                options["--embed-dir"], std::max(static_cast<uint32_t>(std::stoul(options["--jobs"])), 1u));
+        } catch (const std::exception& e) {
+            std::cout << e.what();
+            return -1;
+        }
+    }
+
+    ShaderFiles files;
+    try {
+        while(arguments.size() > 3 && arguments[0].starts_with("--"))
+        {
+            if(arguments[0] == "--embed")
+                files.embedFilename = arguments[1];
+            else
+                parseOption(files.options, arguments[0], arguments[1]);
+            arguments.erase(arguments.begin(), arguments.begin() + 2);
+        }
+    } catch (const std::exception& e) {
+        std::cout << e.what();
+        return -1;
+    }
+
+    if(arguments.size() != 2)
+    {
+       std::cout << "Usage: generate_shader [--embed target_source_file] [--vertex-layout interleaved|soa]\n"
+           "           [--vertex-format input=format]... [--code embedded_spirv_file] [--compression none|spirv-lz]\n"
+           "           [source_spirv_file] [target_header_file]\n"
+           "       generate_shader --manifest [manifest_file] [--jobs thread_count]\n"
+           "       generate_shader --variants [variant_manifest_file] --compiler [glslang_validator] ...\n"
+           "       generate_shader --strip [source_spirv_file] [target_spirv_file]";
        return -1;
     }
 
-    std::string sourceFilename = argv[1];
-    std::string targetFilename = argv[2];
+    files.sourceFilename = arguments[0];
+    files.targetFilename = arguments[1];
 
     try {
-        auto shader = readSourceFile(sourceFilename);
-        spv_reflect_wrapper::SpvReflectShaderModule module{shader};
-        std::ofstream targetFile{targetFilename, std::ios::out | std::ios::trunc};
-        std::string shaderName = std::filesystem::path{targetFilename}.stem().string();
-        targetFile << "#pragma once\n#include <array>\n#include <glm/glm.hpp>\n";
-        targetFile << std::format("namespace ShaderData::{}{{\n", shaderName);
-        targetFile << std::format("static const std::array<uint32_t, {}> code = \n{{\n    ", shader.size());
-        for(uint32_t data : shader)
-        {
-            targetFile << std::format("{:#0x}, ", data);
-        }
-        targetFile << "\n};\n\n";
-        printShader(targetFile, module);
-        targetFile << std::format("}}//namespace ShaderData::{}\n", shaderName);
+        auto generated = generateShader(files);
+        std::cout << getShaderSizeReport(files, generated);
+        writeFile(files.targetFilename, generated.header);
+        if(!files.embedFilename.empty())
+            writeFile(files.embedFilename, generated.embedSource);
+        if(!generated.compressedFilename.empty())
+            writeFile(generated.compressedFilename, generated.compressedCode);
     } catch (const std::exception& e) {
         std::cout << e.what();
         return -1;
     }
-}
\ No newline at end of file
+}